@@ -12,6 +12,7 @@
 #include "atom/app/atom_content_client.h"
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/relauncher.h"
+#include "atom/browser/startup_timeline.h"
 #include "atom/common/atom_command_line.h"
 #include "atom/utility/atom_content_utility_client.h"
 #include "base/base_switches.h"
@@ -257,6 +258,9 @@ bool AtomMainDelegate::BasicStartupComplete(int* exit_code) {
   base::trace_event::TraceLog::GetInstance()->SetArgumentFilterPredicate(
       base::Bind(&IsTraceEventArgsWhitelisted));
 
+  if (IsBrowserProcess(command_line))
+    StartupTimeline::MaybeStart(command_line);
+
 #if defined(OS_WIN)
   v8_breakpad_support::SetUp();
 #endif
@@ -27,6 +27,7 @@
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
 #include "atom/common/options_switches.h"
+#include "atom/common/perf_counters.h"
 #include "atom/common/pepper_flash_util.h"
 #include "base/base_paths.h"
 #include "base/command_line.h"
@@ -37,8 +38,11 @@
 #include "base/path_service.h"
 #include "base/strings/string_util.h"
 #include "brave/browser/brave_content_browser_client.h"
+#include "brave/browser/resource_coordinator/guest_tab_manager.h"
+#include "brave/browser/subresource_filter/subresource_filter_publisher.h"
 #include "brave/common/workers/v8_worker_thread.h"
 #include "brave/common/workers/worker_bindings.h"
+#include "chrome/browser/browser_process.h"
 #include "chrome/common/chrome_paths.h"
 #include "components/component_updater/component_updater_paths.h"
 #include "content/browser/plugin_service_impl.h"
@@ -789,6 +793,64 @@ void App::SendMemoryPressureAlert() {
       base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
 }
 
+void App::SetTabDiscardPolicy(const base::DictionaryValue& options) {
+  auto tab_manager = static_cast<resource_coordinator::GuestTabManager*>(
+      g_browser_process->GetTabManager());
+  if (tab_manager)
+    tab_manager->discard_policy()->SetOptions(options);
+}
+
+v8::Local<v8::Value> App::GetTabDiscardPolicy() {
+  auto tab_manager = static_cast<resource_coordinator::GuestTabManager*>(
+      g_browser_process->GetTabManager());
+  if (!tab_manager)
+    return v8::Null(isolate());
+
+  return mate::ConvertToV8(isolate(),
+      *tab_manager->discard_policy()->GetOptions());
+}
+
+void App::SetTabRestoreOptions(const base::DictionaryValue& options) {
+  auto tab_manager = static_cast<resource_coordinator::GuestTabManager*>(
+      g_browser_process->GetTabManager());
+  if (tab_manager)
+    tab_manager->restore_scheduler()->SetOptions(options);
+}
+
+v8::Local<v8::Value> App::GetTabRestoreOptions() {
+  auto tab_manager = static_cast<resource_coordinator::GuestTabManager*>(
+      g_browser_process->GetTabManager());
+  if (!tab_manager)
+    return v8::Null(isolate());
+
+  return mate::ConvertToV8(isolate(),
+      *tab_manager->restore_scheduler()->GetOptions());
+}
+
+int App::SetSubresourceFilter(mate::Arguments* args) {
+  auto publisher = brave::SubresourceFilterPublisher::GetInstance();
+  if (args->Length() == 0 || args->PeekNext()->IsNull()) {
+    publisher->ClearRules();
+    return publisher->version();
+  }
+
+  base::DictionaryValue rules;
+  if (!args->GetNext(&rules)) {
+    args->ThrowError("rules must be an object");
+    return -1;
+  }
+
+  std::string error;
+  int version = publisher->SetRules(rules, &error);
+  if (version < 0)
+    args->ThrowError(error);
+  return version;
+}
+
+v8::Local<v8::Value> App::GetMetrics() {
+  return mate::ConvertToV8(isolate(), *atom::PerfCounters::GetSnapshot());
+}
+
 void App::PostMessage(int worker_id,
                       v8::Local<v8::Value> message,
                       mate::Arguments* args) {
@@ -950,6 +1012,12 @@ void App::BuildPrototype(
       .SetMethod("isAccessibilitySupportEnabled",
                  &App::IsAccessibilitySupportEnabled)
       .SetMethod("sendMemoryPressureAlert", &App::SendMemoryPressureAlert)
+      .SetMethod("setTabDiscardPolicy", &App::SetTabDiscardPolicy)
+      .SetMethod("getTabDiscardPolicy", &App::GetTabDiscardPolicy)
+      .SetMethod("setTabRestoreOptions", &App::SetTabRestoreOptions)
+      .SetMethod("getTabRestoreOptions", &App::GetTabRestoreOptions)
+      .SetMethod("setSubresourceFilter", &App::SetSubresourceFilter)
+      .SetMethod("getMetrics", &App::GetMetrics)
       .SetMethod("_postMessage", &App::PostMessage)
       .SetMethod("_startWorker", &App::StartWorker)
       .SetMethod("stopWorker", &App::StopWorker)
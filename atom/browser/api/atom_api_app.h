@@ -124,6 +124,12 @@ class App : public AtomBrowserClient::Delegate,
   void DisableHardwareAcceleration(mate::Arguments* args);
   bool IsAccessibilitySupportEnabled();
   void SendMemoryPressureAlert();
+  void SetTabDiscardPolicy(const base::DictionaryValue& options);
+  v8::Local<v8::Value> GetTabDiscardPolicy();
+  void SetTabRestoreOptions(const base::DictionaryValue& options);
+  v8::Local<v8::Value> GetTabRestoreOptions();
+  int SetSubresourceFilter(mate::Arguments* args);
+  v8::Local<v8::Value> GetMetrics();
   void PostMessage(int worker_id,
                   v8::Local<v8::Value> message,
                   mate::Arguments* args);
@@ -5,10 +5,13 @@
 #include <set>
 #include <string>
 
+#include "atom/browser/startup_timeline.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/perf_counters.h"
 #include "base/bind.h"
 #include "base/files/file_util.h"
+#include "base/trace_event/trace_event.h"
 #include "content/public/browser/tracing_controller.h"
 #include "native_mate/dictionary.h"
 
@@ -54,10 +57,26 @@ scoped_refptr<TracingController::TraceDataEndpoint> GetTraceDataEndpoint(
 
 void StopRecording(const base::FilePath& path,
                    const CompletionCallback& callback) {
+  atom::PerfCounters::TraceSnapshot();
   TracingController::GetInstance()->StopTracing(
       GetTraceDataEndpoint(path, callback));
 }
 
+// Used by browser/init.js to trace the modules required during startup.
+bool IsStartupTracing() {
+  bool enabled = false;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED("startup", &enabled);
+  return enabled;
+}
+
+void BeginStartupEvent(const std::string& name, const std::string& detail) {
+  TRACE_EVENT_COPY_BEGIN1("startup", name.c_str(), "detail", detail);
+}
+
+void EndStartupEvent(const std::string& name) {
+  TRACE_EVENT_COPY_END0("startup", name.c_str());
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   auto controller = base::Unretained(TracingController::GetInstance());
@@ -69,6 +88,10 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("stopRecording", &StopRecording);
   dict.SetMethod("getTraceBufferUsage", base::Bind(
       &TracingController::GetTraceBufferUsage, controller));
+  dict.Set("startupCategories", atom::StartupTimeline::kCategories);
+  dict.SetMethod("_isStartupTracing", &IsStartupTracing);
+  dict.SetMethod("_beginStartupEvent", &BeginStartupEvent);
+  dict.SetMethod("_endStartupEvent", &EndStartupEvent);
 }
 
 }  // namespace
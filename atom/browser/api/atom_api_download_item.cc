@@ -5,6 +5,7 @@
 #include "atom/browser/api/atom_api_download_item.h"
 
 #include <map>
+#include <vector>
 
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/common/native_mate_converters/callback.h"
@@ -44,6 +45,18 @@ struct Converter<content::DownloadItem::DownloadState> {
   }
 };
 
+template<>
+struct Converter<content::DownloadItem::ReceivedSlice> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate,
+      const content::DownloadItem::ReceivedSlice& slice) {
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+    dict.Set("offset", slice.offset);
+    dict.Set("receivedBytes", slice.received_bytes);
+    return dict.GetHandle();
+  }
+};
+
 }  // namespace mate
 
 namespace atom {
@@ -127,6 +140,11 @@ int64_t DownloadItem::GetTotalBytes() const {
   return download_item_->GetTotalBytes();
 }
 
+std::vector<content::DownloadItem::ReceivedSlice>
+DownloadItem::GetReceivedSlices() const {
+  return download_item_->GetReceivedSlices();
+}
+
 std::string DownloadItem::GetMimeType() const {
   return download_item_->GetMimeType();
 }
@@ -197,6 +215,7 @@ void DownloadItem::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("cancel", &DownloadItem::Cancel)
       .SetMethod("getReceivedBytes", &DownloadItem::GetReceivedBytes)
       .SetMethod("getTotalBytes", &DownloadItem::GetTotalBytes)
+      .SetMethod("getReceivedSlices", &DownloadItem::GetReceivedSlices)
       .SetMethod("getMimeType", &DownloadItem::GetMimeType)
       .SetMethod("hasUserGesture", &DownloadItem::HasUserGesture)
       .SetMethod("getFilename", &DownloadItem::GetFilename)
@@ -6,6 +6,7 @@
 #define ATOM_BROWSER_API_ATOM_API_DOWNLOAD_ITEM_H_
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
 #include "base/files/file_path.h"
@@ -33,6 +34,7 @@ class DownloadItem : public mate::TrackableObject<DownloadItem>,
   void Cancel();
   int64_t GetReceivedBytes() const;
   int64_t GetTotalBytes() const;
+  std::vector<content::DownloadItem::ReceivedSlice> GetReceivedSlices() const;
   std::string GetMimeType() const;
   bool HasUserGesture() const;
   std::string GetFilename() const;
@@ -4,6 +4,7 @@
 
 #include "atom/browser/api/atom_api_session.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <set>
@@ -307,10 +308,11 @@ void SetProxyInIO(scoped_refptr<net::URLRequestContextGetter> getter,
 
 void SetCertVerifyProcInIO(
     const scoped_refptr<net::URLRequestContextGetter>& context_getter,
-    const AtomCertVerifier::VerifyProc& proc) {
+    const AtomCertVerifier::VerifyProc& proc,
+    base::TimeDelta verdict_ttl) {
   auto request_context = context_getter->GetURLRequestContext();
   static_cast<AtomCertVerifier*>(request_context->cert_verifier())->
-      SetVerifyProc(proc);
+      SetVerifyProc(proc, verdict_ttl);
 }
 
 void ClearHostResolverCacheInIO(
@@ -473,11 +475,17 @@ void Session::SetCertVerifyProc(v8::Local<v8::Value> val,
     args->ThrowError("Must pass null or function");
     return;
   }
+  int verdict_cache_time = 0;
+  mate::Dictionary options;
+  if (args->GetNext(&options))
+    options.Get("verdictCacheTime", &verdict_cache_time);
 
   BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
       base::Bind(&SetCertVerifyProcInIO,
                  request_context_getter_,
-                 proc));
+                 proc,
+                 base::TimeDelta::FromSeconds(
+                     std::max(verdict_cache_time, 0))));
 }
 
 void Session::SetPermissionRequestHandler(v8::Local<v8::Value> val,
@@ -487,9 +495,24 @@ void Session::SetPermissionRequestHandler(v8::Local<v8::Value> val,
     args->ThrowError("Must pass null or function");
     return;
   }
+  int decision_cache_time = 0;
+  mate::Dictionary options;
+  if (args->GetNext(&options))
+    options.Get("decisionCacheTime", &decision_cache_time);
+
+  auto permission_manager = static_cast<brave::BravePermissionManager*>(
+      profile_->GetPermissionManager());
+  permission_manager->SetPermissionRequestHandler(
+      handler, base::TimeDelta::FromSeconds(std::max(decision_cache_time, 0)));
+}
+
+void Session::ClearPermissionDecisions(mate::Arguments* args) {
+  GURL origin;
+  args->GetNext(&origin);
+
   auto permission_manager = static_cast<brave::BravePermissionManager*>(
       profile_->GetPermissionManager());
-  permission_manager->SetPermissionRequestHandler(handler);
+  permission_manager->ClearPermissionDecisions(origin);
 }
 
 void Session::ClearHostResolverCache(mate::Arguments* args) {
@@ -644,6 +667,8 @@ void Session::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setCertificateVerifyProc", &Session::SetCertVerifyProc)
       .SetMethod("setPermissionRequestHandler",
                  &Session::SetPermissionRequestHandler)
+      .SetMethod("clearPermissionDecisions",
+                 &Session::ClearPermissionDecisions)
       .SetMethod("clearHostResolverCache", &Session::ClearHostResolverCache)
       .SetMethod("allowNTLMCredentialsForDomains",
                  &Session::AllowNTLMCredentialsForDomains)
@@ -3,52 +3,103 @@
 // found in the LICENSE file.
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "atom/browser/api/atom_api_user_prefs.h"
 
+#include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/incremental_v8_value_converter.h"
 #include "atom/common/native_mate_converters/v8_value_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/perf_counters.h"
 #include "base/values.h"
 #include "chrome/browser/profiles/profile.h"
 #include "components/pref_registry/pref_registry_syncable.h"
+#include "components/prefs/pref_change_registrar.h"
 #include "components/sync_preferences/pref_service_syncable.h"
 #include "content/public/browser/browser_thread.h"
+#include "native_mate/arguments.h"
 #include "native_mate/object_template_builder.h"
 
-namespace mate {
+namespace atom {
+
+namespace api {
+
+namespace {
+
+std::unique_ptr<base::ListValue> PathToList(
+    const std::vector<std::string>& path) {
+  std::unique_ptr<base::ListValue> list(new base::ListValue);
+  for (const std::string& key : path)
+    list->AppendString(key);
+  return list;
+}
+
+void AppendEntry(base::ListValue* entries,
+                 const std::vector<std::string>& path,
+                 const base::Value& value) {
+  std::unique_ptr<base::DictionaryValue> entry(new base::DictionaryValue);
+  entry->Set("path", PathToList(path));
+  entry->Set("value", value.CreateDeepCopy());
+  entries->Append(std::move(entry));
+}
 
-template<>
-struct Converter<const base::DictionaryValue*> {
-  static v8::Local<v8::Value> ToV8(
-      v8::Isolate* isolate,
-      const base::DictionaryValue* val) {
-    std::unique_ptr<atom::V8ValueConverter>
-        converter(new atom::V8ValueConverter);
-    return converter->ToV8Value(val, isolate->GetCurrentContext());
+// Adds the differences from |old_value| to |new_value| to the lists, and
+// updates |old_value| to match |new_value| as it goes, copying only what
+// changed.
+void DiffDictionaries(base::DictionaryValue* old_value,
+                      const base::DictionaryValue& new_value,
+                      std::vector<std::string>* path,
+                      base::ListValue* added,
+                      base::ListValue* changed,
+                      base::ListValue* removed) {
+  std::vector<std::string> removed_keys;
+  for (base::DictionaryValue::Iterator it(*old_value); !it.IsAtEnd();
+       it.Advance()) {
+    if (!new_value.HasKey(it.key()))
+      removed_keys.push_back(it.key());
   }
-};
-
-template<>
-struct Converter<const base::ListValue*> {
-  static v8::Local<v8::Value> ToV8(
-      v8::Isolate* isolate,
-      const base::ListValue* val) {
-    std::unique_ptr<atom::V8ValueConverter>
-        converter(new atom::V8ValueConverter);
-    return converter->ToV8Value(val, isolate->GetCurrentContext());
+  for (const std::string& key : removed_keys) {
+    path->push_back(key);
+    removed->Append(PathToList(*path));
+    path->pop_back();
+    old_value->RemoveWithoutPathExpansion(key, nullptr);
   }
-};
 
-}  // namespace mate
+  for (base::DictionaryValue::Iterator it(new_value); !it.IsAtEnd();
+       it.Advance()) {
+    path->push_back(it.key());
+    base::Value* old_child = nullptr;
+    if (!old_value->GetWithoutPathExpansion(it.key(), &old_child)) {
+      AppendEntry(added, *path, it.value());
+      old_value->SetWithoutPathExpansion(it.key(), it.value().CreateDeepCopy());
+    } else if (old_child->IsType(base::Value::Type::DICTIONARY) &&
+               it.value().IsType(base::Value::Type::DICTIONARY)) {
+      DiffDictionaries(static_cast<base::DictionaryValue*>(old_child),
+                       static_cast<const base::DictionaryValue&>(it.value()),
+                       path, added, changed, removed);
+    } else if (!old_child->Equals(&it.value())) {
+      AppendEntry(changed, *path, it.value());
+      old_value->SetWithoutPathExpansion(it.key(), it.value().CreateDeepCopy());
+    }
+    path->pop_back();
+  }
+}
 
-namespace atom {
+}  // namespace
 
-namespace api {
+UserPrefs::DictionaryPrefObservers::DictionaryPrefObservers()
+    : notifying(false) {}
+
+UserPrefs::DictionaryPrefObservers::~DictionaryPrefObservers() {}
 
 UserPrefs::UserPrefs(v8::Isolate* isolate,
                  content::BrowserContext* browser_context)
-      : browser_context_(browser_context) {
+      : browser_context_(browser_context),
+        next_observer_id_(0),
+        weak_factory_(this) {
   Init(isolate);
 }
 
@@ -111,13 +162,72 @@ std::string UserPrefs::GetStringPref(const std::string& path) {
   return profile()->GetPrefs()->GetString(path);
 }
 
-const base::DictionaryValue* UserPrefs::GetDictionaryPref(
-      const std::string& path) {
-  return profile()->GetPrefs()->GetDictionary(path);
+v8::Local<v8::Value> UserPrefs::GetDictionaryPref(const std::string& path,
+                                                mate::Arguments* args) {
+  return ConvertPref(path, profile()->GetPrefs()->GetDictionary(path), args);
+}
+
+v8::Local<v8::Value> UserPrefs::GetListPref(const std::string& path,
+                                          mate::Arguments* args) {
+  return ConvertPref(path, profile()->GetPrefs()->GetList(path), args);
+}
+
+v8::Local<v8::Value> UserPrefs::ConvertPref(const std::string& path,
+                                            const base::Value* value,
+                                            mate::Arguments* args) {
+  IncrementalV8ValueConverter::Callback callback;
+  if (!args->GetNext(&callback)) {
+    V8ValueConverter converter;
+    return converter.ToV8Value(value, isolate()->GetCurrentContext());
+  }
+
+  // The pref is read in place, and counting its changes lets the converter
+  // tell when its pointers into it are stale.
+  PrefConversions& conversions = pref_conversions_[path];
+  if (!conversions.pending++) {
+    if (!conversion_registrar_) {
+      conversion_registrar_.reset(new PrefChangeRegistrar);
+      conversion_registrar_->Init(profile()->GetPrefs());
+    }
+    conversions.version = 0;
+    conversion_registrar_->Add(
+        path, base::Bind(&UserPrefs::OnConvertedPrefChanged,
+                         base::Unretained(this)));
+  }
+
+  IncrementalV8ValueConverter::Convert(
+      base::Bind(&UserPrefs::GetConvertedPref, weak_factory_.GetWeakPtr(),
+                 path),
+      isolate()->GetCurrentContext(),
+      base::Bind(&UserPrefs::OnPrefConverted, weak_factory_.GetWeakPtr(),
+                 path, callback));
+  return v8::Undefined(isolate());
+}
+
+// static
+const base::Value* UserPrefs::GetConvertedPref(base::WeakPtr<UserPrefs> self,
+                                               const std::string& path,
+                                               int* version) {
+  if (!self)
+    return nullptr;
+  *version = self->pref_conversions_[path].version;
+  return self->profile()->GetPrefs()->Get(path);
+}
+
+void UserPrefs::OnConvertedPrefChanged(const std::string& path) {
+  pref_conversions_[path].version++;
 }
 
-const base::ListValue* UserPrefs::GetListPref(const std::string& path) {
-  return profile()->GetPrefs()->GetList(path);
+void UserPrefs::OnPrefConverted(
+    const std::string& path,
+    const base::Callback<void(v8::Local<v8::Value>)>& callback,
+    v8::Local<v8::Value> value) {
+  auto it = pref_conversions_.find(path);
+  if (it != pref_conversions_.end() && !--it->second.pending) {
+    conversion_registrar_->Remove(path);
+    pref_conversions_.erase(it);
+  }
+  callback.Run(value);
 }
 
 bool UserPrefs::GetBooleanPref(const std::string& path) {
@@ -162,6 +272,111 @@ void UserPrefs::SetDoublePref(const std::string& path,
   profile()->GetPrefs()->SetDouble(path, value);
 }
 
+int UserPrefs::AddDictionaryPrefObserver(const std::string& path,
+                                         const DiffCallback& callback) {
+  const PrefService::Preference* pref =
+      profile()->GetPrefs()->FindPreference(path);
+  if (!pref || pref->GetType() != base::Value::Type::DICTIONARY)
+    return 0;
+
+  std::unique_ptr<DictionaryPrefObservers>& observers =
+      dictionary_pref_observers_[path];
+  if (!observers) {
+    if (!registrar_) {
+      registrar_.reset(new PrefChangeRegistrar);
+      registrar_->Init(profile()->GetPrefs());
+    }
+    observers.reset(new DictionaryPrefObservers);
+    observers->snapshot =
+        profile()->GetPrefs()->GetDictionary(path)->CreateDeepCopy();
+    registrar_->Add(path, base::Bind(&UserPrefs::OnDictionaryPrefChanged,
+                                     base::Unretained(this)));
+  }
+
+  int id = ++next_observer_id_;
+  observers->callbacks[id] = callback;
+  return id;
+}
+
+void UserPrefs::RemoveDictionaryPrefObserver(int id) {
+  for (auto it = dictionary_pref_observers_.begin();
+       it != dictionary_pref_observers_.end(); ++it) {
+    if (!it->second->callbacks.erase(id))
+      continue;
+    if (it->second->callbacks.empty()) {
+      registrar_->Remove(it->first);
+      dictionary_pref_observers_.erase(it);
+    }
+    return;
+  }
+}
+
+void UserPrefs::OnDictionaryPrefChanged(const std::string& path) {
+  auto it = dictionary_pref_observers_.find(path);
+  if (it == dictionary_pref_observers_.end())
+    return;
+
+  std::unique_ptr<base::ListValue> added(new base::ListValue);
+  std::unique_ptr<base::ListValue> changed(new base::ListValue);
+  std::unique_ptr<base::ListValue> removed(new base::ListValue);
+  {
+    atom::ScopedPerfTimer timer(atom::PerfMetric::PREFS_DIFF);
+    std::vector<std::string> key_path;
+    DiffDictionaries(it->second->snapshot.get(),
+                     *profile()->GetPrefs()->GetDictionary(path), &key_path,
+                     added.get(), changed.get(), removed.get());
+  }
+  if (added->empty() && changed->empty() && removed->empty())
+    return;
+
+  std::unique_ptr<base::DictionaryValue> diff(new base::DictionaryValue);
+  diff->Set("added", std::move(added));
+  diff->Set("changed", std::move(changed));
+  diff->Set("removed", std::move(removed));
+  it->second->pending_diffs.push_back(std::move(diff));
+
+  // A set from inside an observer lands here while the previous diff is
+  // still being delivered; the outer call delivers it once that's done, so
+  // every observer sees the diffs in order.
+  if (it->second->notifying)
+    return;
+  it->second->notifying = true;
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Context> context = GetWrapper()->CreationContext();
+  v8::Context::Scope context_scope(context);
+  V8ValueConverter converter;
+  while (!it->second->pending_diffs.empty()) {
+    std::unique_ptr<base::DictionaryValue> next =
+        std::move(it->second->pending_diffs.front());
+    it->second->pending_diffs.pop_front();
+
+    std::vector<int> ids;
+    for (const auto& callback : it->second->callbacks)
+      ids.push_back(callback.first);
+
+    v8::HandleScope diff_scope(isolate());
+    v8::Local<v8::Value> diff_v8 = converter.ToV8Value(next.get(), context);
+    for (int id : ids) {
+      // Observers may remove themselves or each other, and with the last one
+      // gone the observers of |path| and their pending diffs are freed.
+      it = dictionary_pref_observers_.find(path);
+      if (it == dictionary_pref_observers_.end())
+        return;
+      auto callback = it->second->callbacks.find(id);
+      if (callback == it->second->callbacks.end())
+        continue;
+      DiffCallback run = callback->second;
+      run.Run(diff_v8);
+    }
+    it = dictionary_pref_observers_.find(path);
+    if (it == dictionary_pref_observers_.end())
+      return;
+  }
+  it->second->notifying = false;
+}
+
 double UserPrefs::GetDefaultZoomLevel() {
   return profile()->GetZoomLevelPrefs()->GetDefaultZoomLevelPref();
 }
@@ -208,6 +423,10 @@ void UserPrefs::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setDoublePref", &UserPrefs::SetDoublePref)
       // .SetMethod("setFilePathPref", &UserPrefs::SetFilePathPref)
 
+      .SetMethod("addDictionaryPrefObserver",
+                 &UserPrefs::AddDictionaryPrefObserver)
+      .SetMethod("removeDictionaryPrefObserver",
+                 &UserPrefs::RemoveDictionaryPrefObserver)
       .SetMethod("getDefaultZoomLevel", &UserPrefs::GetDefaultZoomLevel)
       .SetMethod("setDefaultZoomLevel", &UserPrefs::SetDefaultZoomLevel);
 }
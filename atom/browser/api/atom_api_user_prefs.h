@@ -5,18 +5,28 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_USER_PREFS_H_
 #define ATOM_BROWSER_API_ATOM_API_USER_PREFS_H_
 
+#include <deque>
+#include <map>
+#include <memory>
 #include <string>
 
 #include "atom/browser/api/trackable_object.h"
 #include "base/callback.h"
+#include "base/memory/weak_ptr.h"
 #include "brave/browser/brave_browser_context.h"
 #include "native_mate/handle.h"
 
 namespace base {
 class DictionaryValue;
 class ListValue;
+class Value;
 }
 
+namespace mate {
+class Arguments;
+}
+
+class PrefChangeRegistrar;
 class Profile;
 
 namespace atom {
@@ -25,6 +35,8 @@ namespace api {
 
 class UserPrefs : public mate::TrackableObject<UserPrefs> {
  public:
+  using DiffCallback = base::Callback<void(v8::Local<v8::Value>)>;
+
   static mate::Handle<UserPrefs> Create(v8::Isolate* isolate,
                                   content::BrowserContext* browser_context);
 
@@ -50,8 +62,12 @@ class UserPrefs : public mate::TrackableObject<UserPrefs> {
       double default_value, bool overlay);
 
   std::string GetStringPref(const std::string& path);
-  const base::DictionaryValue* GetDictionaryPref(const std::string& path);
-  const base::ListValue* GetListPref(const std::string& path);
+  // With a callback the value is passed to it instead of being returned, and
+  // converted in slices so a large pref doesn't stall the main thread.
+  v8::Local<v8::Value> GetDictionaryPref(const std::string& path,
+                                         mate::Arguments* args);
+  v8::Local<v8::Value> GetListPref(const std::string& path,
+                                   mate::Arguments* args);
   bool GetBooleanPref(const std::string& path);
   int GetIntegerPref(const std::string& path);
   double GetDoublePref(const std::string& path);
@@ -76,11 +92,68 @@ class UserPrefs : public mate::TrackableObject<UserPrefs> {
   double GetDefaultZoomLevel();
   void SetDefaultZoomLevel(double zoom);
 
+  // Calls |callback| with what changed every time the dictionary pref at
+  // |path| is set, as {added, changed, removed}. Added and changed entries
+  // are {path, value}, removed ones a path, and paths are arrays of keys.
+  // Dictionaries are compared key by key, any other value as a whole. The
+  // diff is computed and converted once for all the observers of |path|.
+  // Returns an id for RemoveDictionaryPrefObserver, or 0 if |path| isn't a
+  // dictionary pref.
+  int AddDictionaryPrefObserver(const std::string& path,
+                                const DiffCallback& callback);
+  void RemoveDictionaryPrefObserver(int id);
+
   Profile* profile();
 
+  v8::Local<v8::Value> ConvertPref(const std::string& path,
+                                   const base::Value* value,
+                                   mate::Arguments* args);
+
  private:
+  struct DictionaryPrefObservers {
+    DictionaryPrefObservers();
+    ~DictionaryPrefObservers();
+
+    // The value the last diff was computed against.
+    std::unique_ptr<base::DictionaryValue> snapshot;
+    std::map<int, DiffCallback> callbacks;
+    // Diffs not yet delivered to every observer. A change made by an
+    // observer queues its diff behind the one being delivered.
+    std::deque<std::unique_ptr<base::DictionaryValue>> pending_diffs;
+    bool notifying;
+  };
+
+  void OnDictionaryPrefChanged(const std::string& path);
+
+  // The pref at |path| for IncrementalV8ValueConverter, whose |version| is
+  // the number of times it changed while it was being converted.
+  static const base::Value* GetConvertedPref(base::WeakPtr<UserPrefs> self,
+                                             const std::string& path,
+                                             int* version);
+  void OnConvertedPrefChanged(const std::string& path);
+  void OnPrefConverted(const std::string& path,
+                       const base::Callback<void(v8::Local<v8::Value>)>&
+                           callback,
+                       v8::Local<v8::Value> value);
+
   content::BrowserContext* browser_context_;  // not owned
 
+  std::unique_ptr<PrefChangeRegistrar> registrar_;
+  std::map<std::string, std::unique_ptr<DictionaryPrefObservers>>
+      dictionary_pref_observers_;
+  int next_observer_id_;
+
+  // Conversions in progress and the versions of the prefs they read, by
+  // path.
+  struct PrefConversions {
+    int pending;
+    int version;
+  };
+  std::unique_ptr<PrefChangeRegistrar> conversion_registrar_;
+  std::map<std::string, PrefConversions> pref_conversions_;
+
+  base::WeakPtrFactory<UserPrefs> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(UserPrefs);
 };
 
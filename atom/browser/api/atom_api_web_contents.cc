@@ -2,6 +2,7 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <memory>
 #include <set>
 #include <string>
@@ -14,12 +15,14 @@
 #include "atom/browser/api/atom_api_session.h"
 #include "atom/browser/api/atom_api_web_request.h"
 #include "atom/browser/api/atom_api_window.h"
+#include "atom/browser/api/capture_page_scheduler.h"
 #include "atom/browser/api/event.h"
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/autofill/atom_autofill_client.h"
 #include "atom/browser/browser.h"
+#include "atom/browser/javascript_idle_scheduler.h"
 #include "atom/browser/lib/bluetooth_chooser.h"
 #include "atom/browser/native_window.h"
 #include "atom/browser/net/atom_network_delegate.h"
@@ -31,6 +34,7 @@
 #include "atom/common/color_util.h"
 #include "atom/common/mouse_util.h"
 #include "atom/common/native_mate_converters/blink_converter.h"
+#include "atom/common/native_mate_converters/buffer_converter.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/content_converter.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
@@ -41,14 +45,17 @@
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/options_switches.h"
+#include "atom/common/perf_counters.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/trace_event/trace_event.h"
 #include "brave/browser/brave_browser_context.h"
 #include "brave/browser/brave_content_browser_client.h"
 #include "brave/browser/guest_view/tab_view/tab_view_guest.h"
 #include "brave/browser/password_manager/brave_password_manager_client.h"
 #include "brave/browser/plugins/brave_plugin_service_filter.h"
 #include "brave/browser/renderer_preferences_helper.h"
+#include "brave/browser/resource_coordinator/guest_tab_manager.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
 #include "brightray/browser/inspectable_web_contents.h"
 #include "brightray/browser/inspectable_web_contents_view.h"
@@ -393,6 +400,13 @@ struct FrameDispatchHelper {
     web_contents->OnRendererMessageSync(
         render_frame_host, channel, args, message);
   }
+
+  void OnChannelMessageSync(uint32_t channel_id,
+                            const base::ListValue& args,
+                            IPC::Message* message) {
+    web_contents->OnChannelMessageSync(
+        render_frame_host, channel_id, args, message);
+  }
 };
 
 namespace {
@@ -410,6 +424,9 @@ mate::Handle<api::Session> SessionFromOptions(v8::Isolate* isolate,
     if (options.Get("parent_partition", &parent_partition)) {
       session_options.SetString("parent_partition", parent_partition);
     }
+    bool ephemeral = false;
+    if (options.Get("ephemeral", &ephemeral))
+      session_options.SetBoolean("ephemeral", ephemeral);
     session = Session::FromPartition(isolate, partition, session_options);
   } else {
     // Use the default session if not specified.
@@ -419,6 +436,35 @@ mate::Handle<api::Session> SessionFromOptions(v8::Isolate* isolate,
   return session;
 }
 
+// Builds a restored navigation entry from {url, title, faviconUrl}.
+std::unique_ptr<content::NavigationEntry> CreateRestoredNavigationEntry(
+    const mate::Dictionary& options) {
+  std::string url;
+  if (!options.Get("url", &url))
+    return nullptr;
+
+  std::unique_ptr<content::NavigationEntryImpl> entry =
+      base::WrapUnique(new content::NavigationEntryImpl);
+  entry->SetURL(GURL(url));
+  entry->SetVirtualURL(GURL(url));
+
+  std::string title;
+  if (options.Get("title", &title)) {
+    entry->SetTitle(base::UTF8ToUTF16(title));
+  }
+
+  std::string favicon_url;
+  if (options.Get("faviconUrl", &favicon_url) ||
+      options.Get("favIconUrl", &favicon_url)) {
+    content::FaviconStatus status;
+    status.valid = true;
+    status.url = GURL(favicon_url);
+    entry->GetFavicon() = status;
+  }
+
+  return std::move(entry);
+}
+
 content::ServiceWorkerContext* GetServiceWorkerContext(
     const content::WebContents* web_contents) {
   auto context = web_contents->GetBrowserContext();
@@ -434,13 +480,6 @@ content::ServiceWorkerContext* GetServiceWorkerContext(
   return storage_partition->GetServiceWorkerContext();
 }
 
-// Called when CapturePage is done.
-void OnCapturePageDone(base::Callback<void(const gfx::Image&)> callback,
-                       const SkBitmap& bitmap,
-                       content::ReadbackResponse response) {
-  callback.Run(gfx::Image::CreateFrom1xBitmap(bitmap));
-}
-
 }  // namespace
 
 WebContents::WebContents(v8::Isolate* isolate,
@@ -1299,6 +1338,11 @@ void WebContents::RenderViewDeleted(content::RenderViewHost* render_view_host) {
   Emit("render-view-deleted", render_view_host->GetProcess()->GetID());
 }
 
+void WebContents::RenderFrameDeleted(
+    content::RenderFrameHost* render_frame_host) {
+  ipc_channels_.RemoveFrame(render_frame_host);
+}
+
 void WebContents::RenderProcessGone(base::TerminationStatus status) {
   Emit("crashed");
 }
@@ -1333,6 +1377,13 @@ void WebContents::RenderViewCreated(content::RenderViewHost* render_view_host) {
   Emit("render-view-created", render_view_host->GetProcess()->GetID());
 }
 
+void WebContents::DidGetUserInteraction(
+    const blink::WebInputEvent::Type type) {
+  // Keep the browser isolate from starting idle GC work while the page
+  // handles the input.
+  JavascriptIdleScheduler::DidReceiveInput();
+}
+
 void WebContents::DocumentAvailableInMainFrame() {
   Emit("document-available");
 }
@@ -1529,6 +1580,11 @@ bool WebContents::OnMessageReceived(const IPC::Message& message,
     IPC_MESSAGE_FORWARD_DELAY_REPLY(AtomViewHostMsg_Message_Sync, &helper,
                                     FrameDispatchHelper::OnRendererMessageSync)
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_Shared, OnRendererMessageShared)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_RegisterChannel, OnRegisterChannel)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_ChannelMessage, OnChannelMessage)
+    IPC_MESSAGE_FORWARD_DELAY_REPLY(AtomViewHostMsg_ChannelMessage_Sync,
+                                    &helper,
+                                    FrameDispatchHelper::OnChannelMessageSync)
     IPC_MESSAGE_HANDLER_CODE(ViewHostMsg_SetCursor, OnCursorChange,
                              handled = false)
     IPC_MESSAGE_UNHANDLED(handled = false)
@@ -2283,6 +2339,20 @@ void WebContents::Discard() {
   }
 }
 
+bool WebContents::AutoDiscard(const base::DictionaryValue& details) {
+  auto tab_helper = extensions::TabHelper::FromWebContents(web_contents());
+  if (!tab_helper)
+    return false;
+
+  if (!Emit("will-discard", details) && tab_helper->Discard()) {
+    Emit("discarded", details);
+    return true;
+  }
+
+  Emit("discard-aborted", details);
+  return false;
+}
+
 #if BUILDFLAG(ENABLE_EXTENSIONS)
 bool WebContents::ExecuteScriptInTab(mate::Arguments* args) {
   auto tab_helper = extensions::TabHelper::FromWebContents(web_contents());
@@ -2344,6 +2414,38 @@ bool WebContents::SendIPCMessage(int render_process_id,
   return rfh->Send(new AtomViewMsg_Message(rfh->GetRoutingID(), channel, args));
 }
 
+// static
+int WebContents::SendIPCMessageToAll(
+    v8::Isolate* isolate,
+    const std::vector<v8::Local<v8::Value>>& targets,
+    const base::string16& channel,
+    const base::ListValue& args) {
+  TRACE_EVENT1("browser", "WebContents::SendIPCMessageToAll",
+               "targets", targets.size());
+  ScopedPerfTimer timer(PerfMetric::IPC_BROADCAST);
+
+  // Pickling |args| is most of the cost of a message, every frame gets a
+  // copy of the pickled buffer with its routing id patched in instead.
+  const AtomViewMsg_Message message(MSG_ROUTING_NONE, channel, args);
+  int sent = 0;
+  for (const auto& target : targets) {
+    mate::Handle<WebContents> contents;
+    if (!mate::ConvertFromV8(isolate, target, &contents) ||
+        !contents->web_contents() || contents->is_being_destroyed_)
+      continue;
+
+    auto rfh = contents->web_contents()->GetMainFrame();
+    if (!rfh)
+      continue;
+
+    IPC::Message* copy = new IPC::Message(message);
+    copy->set_routing_id(rfh->GetRoutingID());
+    if (rfh->Send(copy))
+      ++sent;
+  }
+  return sent;
+}
+
 void WebContents::SendInputEvent(v8::Isolate* isolate,
                                  v8::Local<v8::Value> input_event) {
   const auto view = web_contents()->GetRenderWidgetHostView();
@@ -2413,41 +2515,47 @@ void WebContents::StartDrag(const mate::Dictionary& item,
 
 void WebContents::CapturePage(mate::Arguments* args) {
   gfx::Rect rect;
-  base::Callback<void(const gfx::Image&)> callback;
-
-  if (!(args->Length() == 1 && args->GetNext(&callback)) &&
-      !(args->Length() == 2 && args->GetNext(&rect)
-                            && args->GetNext(&callback))) {
-    args->ThrowError();
+  mate::Dictionary options = mate::Dictionary::CreateEmpty(isolate());
+  v8::Local<v8::Value> callback;
+
+  bool valid = false;
+  if (args->Length() == 1) {
+    valid = args->GetNext(&callback);
+  } else if (args->Length() == 2) {
+    valid = args->GetNext(&rect) && args->GetNext(&callback);
+  } else if (args->Length() == 3) {
+    // A null |rect| captures the whole page.
+    v8::Local<v8::Value> null_rect;
+    valid = (args->PeekNext()->IsNull() ? args->GetNext(&null_rect)
+                                        : args->GetNext(&rect)) &&
+            args->GetNext(&options) && args->GetNext(&callback);
+  }
+
+  std::unique_ptr<CapturePageScheduler::Request> request(
+      new CapturePageScheduler::Request);
+  request->rect = rect;
+
+  std::string format;
+  if (valid && options.Get("format", &format) &&
+      !CapturePageScheduler::FormatFromString(format, &request->format)) {
+    args->ThrowError("Unsupported capture format: " + format);
     return;
   }
+  options.Get("size", &request->max_size);
+  options.Get("quality", &request->quality);
 
-  const auto view = web_contents()->GetRenderWidgetHostView();
-  const auto host = view ? view->GetRenderWidgetHost() : nullptr;
-  if (!view || !host) {
-    callback.Run(gfx::Image());
+  if (valid) {
+    valid = request->format == CapturePageScheduler::FORMAT_IMAGE ?
+        mate::ConvertFromV8(isolate(), callback, &request->image_callback) :
+        mate::ConvertFromV8(isolate(), callback, &request->buffer_callback);
+  }
+  if (!valid) {
+    args->ThrowError();
     return;
   }
 
-  // Capture full page if user doesn't specify a |rect|.
-  const gfx::Size view_size = rect.IsEmpty() ? view->GetViewBounds().size() :
-                                               rect.size();
-
-  // By default, the requested bitmap size is the view size in screen
-  // coordinates.  However, if there's more pixel detail available on the
-  // current system, increase the requested bitmap size to capture it all.
-  gfx::Size bitmap_size = view_size;
-  const gfx::NativeView native_view = view->GetNativeView();
-  const float scale =
-      display::Screen::GetScreen()->GetDisplayNearestView(native_view)
-      .device_scale_factor();
-  if (scale > 1.0f)
-    bitmap_size = gfx::ScaleToCeiledSize(view_size, scale);
-
-  host->GetView()->CopyFromSurface(gfx::Rect(rect.origin(), view_size),
-      bitmap_size,
-      base::Bind(&OnCapturePageDone, callback),
-      kBGRA_8888_SkColorType);
+  CapturePageScheduler::GetInstance()->Capture(web_contents(),
+                                               std::move(request));
 }
 
 void WebContents::GetPreferredSize(mate::Arguments* args) {
@@ -2565,6 +2673,60 @@ v8::Local<v8::Value> WebContents::TabValue() {
       value.get(), isolate()->GetCurrentContext());
 }
 
+v8::Local<v8::Value> WebContents::UpdateTabValue() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  auto tab_helper = extensions::TabHelper::FromWebContents(web_contents());
+  if (!tab_helper)
+    return v8::Null(isolate());
+
+  uint32_t changes = tab_helper->UpdateTabState();
+  if (!changes)
+    return v8::Null(isolate());
+
+  std::unique_ptr<base::DictionaryValue> tab(
+      ExtensionTabUtil::CreateTabObject(web_contents())->ToValue().release());
+
+  // extensions see the same keys they would get from diffing two tab values
+  static const struct {
+    uint32_t field;
+    const char* key;
+  } kChangeKeys[] = {
+    { extensions::TabState::WINDOW_ID, "windowId" },
+    { extensions::TabState::INDEX, "index" },
+    { extensions::TabState::ACTIVE, "active" },
+    { extensions::TabState::ACTIVE, "selected" },
+    { extensions::TabState::HIGHLIGHTED, "highlighted" },
+    { extensions::TabState::PINNED, "pinned" },
+    { extensions::TabState::AUDIBLE, "audible" },
+    { extensions::TabState::MUTED, "mutedInfo" },
+    { extensions::TabState::DISCARDED, "discarded" },
+    { extensions::TabState::AUTO_DISCARDABLE, "autoDiscardable" },
+    { extensions::TabState::STATUS, "status" },
+    { extensions::TabState::INCOGNITO, "incognito" },
+    { extensions::TabState::SIZE, "width" },
+    { extensions::TabState::SIZE, "height" },
+    { extensions::TabState::URL, "url" },
+    { extensions::TabState::TITLE, "title" },
+    { extensions::TabState::FAV_ICON_URL, "favIconUrl" },
+    { extensions::TabState::OPENER_TAB_ID, "openerTabId" },
+  };
+
+  std::unique_ptr<base::DictionaryValue> change_info(
+      new base::DictionaryValue);
+  for (const auto& change_key : kChangeKeys) {
+    const base::Value* value = nullptr;
+    if ((changes & change_key.field) && tab->Get(change_key.key, &value))
+      change_info->Set(change_key.key, value->CreateDeepCopy());
+  }
+
+  base::DictionaryValue result;
+  result.Set("changeInfo", std::move(change_info));
+  result.Set("tab", std::move(tab));
+  return content::V8ValueConverter::Create()->ToV8Value(
+      &result, isolate()->GetCurrentContext());
+}
+
 int32_t WebContents::ID() const {
   if (IsRemote() && !GetMainFrame().IsEmpty())
     return GetMainFrame()->weak_map_id();
@@ -2722,6 +2884,7 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("executeScriptInTab", &WebContents::ExecuteScriptInTab)
       .SetMethod("isBackgroundPage", &WebContents::IsBackgroundPage)
       .SetMethod("tabValue", &WebContents::TabValue)
+      .SetMethod("updateTabValue", &WebContents::UpdateTabValue)
 #endif
       .SetMethod("close", &WebContents::CloseContents)
       .SetMethod("forceClose", &WebContents::DestroyWebContents)
@@ -2749,6 +2912,7 @@ AtomBrowserContext* WebContents::GetBrowserContext() const {
 void WebContents::OnRendererMessage(content::RenderFrameHost* sender,
                                     const base::string16& channel,
                                     const base::ListValue& args) {
+  ScopedPerfTimer timer(PerfMetric::IPC_MESSAGE);
   EmitWithSender(base::UTF16ToUTF8(channel), sender, nullptr, args);
 }
 
@@ -2756,6 +2920,7 @@ void WebContents::OnRendererMessageSync(content::RenderFrameHost* sender,
                                         const base::string16& channel,
                                         const base::ListValue& args,
                                         IPC::Message* message) {
+  ScopedPerfTimer timer(PerfMetric::IPC_MESSAGE_SYNC);
   EmitWithSender(base::UTF16ToUTF8(channel), sender, message, args);
 }
 
@@ -2763,6 +2928,7 @@ void WebContents::OnRendererMessageShared(
     content::RenderFrameHost* sender,
     const base::string16& channel,
     const base::SharedMemoryHandle& handle) {
+  ScopedPerfTimer timer(PerfMetric::IPC_MESSAGE_SHARED);
   std::vector<v8::Local<v8::Value>> args = {
     mate::StringToV8(isolate(), channel),
     brave::SharedMemoryWrapper::CreateFrom(isolate(), handle).ToV8(),
@@ -2772,6 +2938,63 @@ void WebContents::OnRendererMessageShared(
   Emit("ipc-message", args);
 }
 
+void WebContents::OnRegisterChannel(content::RenderFrameHost* sender,
+                                    uint32_t channel_id,
+                                    const std::string& event,
+                                    const std::string& channel) {
+  PerfCounters::Increment(PerfMetric::IPC_CHANNEL_REGISTERED);
+  if (!ipc_channels_.Register(isolate(), sender, channel_id, event, channel))
+    LOG(ERROR) << "Invalid ipc channel id " << channel_id;
+}
+
+void WebContents::OnChannelMessage(content::RenderFrameHost* sender,
+                                   uint32_t channel_id,
+                                   const base::ListValue& args) {
+  ScopedPerfTimer timer(PerfMetric::IPC_MESSAGE);
+  EmitChannelMessage(sender, channel_id, args, nullptr);
+}
+
+void WebContents::OnChannelMessageSync(content::RenderFrameHost* sender,
+                                       uint32_t channel_id,
+                                       const base::ListValue& args,
+                                       IPC::Message* message) {
+  ScopedPerfTimer timer(PerfMetric::IPC_MESSAGE_SYNC);
+  EmitChannelMessage(sender, channel_id, args, message);
+}
+
+void WebContents::EmitChannelMessage(content::RenderFrameHost* sender,
+                                     uint32_t channel_id,
+                                     const base::ListValue& args,
+                                     IPC::Message* message) {
+  const IPCChannelTable::Channel* channel =
+      ipc_channels_.Find(sender, channel_id);
+  if (!channel) {
+    LOG(ERROR) << "Message on unregistered ipc channel " << channel_id;
+    // Don't leave a synchronous sender blocked. The reply is parsed as JSON,
+    // so sendSync returns null.
+    if (message) {
+      AtomViewHostMsg_ChannelMessage_Sync::WriteReplyParams(
+          message, base::ASCIIToUTF16("null"));
+      sender->Send(message);
+    }
+    return;
+  }
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Array> values =
+      mate::ConvertToV8(isolate(), args).As<v8::Array>();
+  v8::Local<v8::Array> channel_args =
+      v8::Array::New(isolate(), values->Length() + 1);
+  channel_args->Set(0, channel->name.Get(isolate()));
+  for (uint32_t i = 0; i < values->Length(); ++i)
+    channel_args->Set(i + 1, values->Get(i));
+
+  // webContents.emit(event, new Event(sender, message), [channel, ...args]);
+  EmitWithSender(channel->event, sender, message,
+                 v8::Local<v8::Value>(channel_args));
+}
+
 // static
 mate::Handle<WebContents> WebContents::FromTabID(v8::Isolate* isolate,
     int tab_id) {
@@ -2779,6 +3002,43 @@ mate::Handle<WebContents> WebContents::FromTabID(v8::Isolate* isolate,
       extensions::TabHelper::GetTabById(tab_id));
 }
 
+// static
+std::vector<mate::Handle<WebContents>> WebContents::QueryTabs(
+    v8::Isolate* isolate, const base::DictionaryValue& query_info) {
+  extensions::TabQuery query;
+  int int_value = 0;
+  bool bool_value = false;
+  std::string string_value;
+  base::string16 string16_value;
+  if (query_info.GetInteger("windowId", &int_value))
+    query.window_id = int_value;
+  if (query_info.GetInteger("index", &int_value))
+    query.index = int_value;
+  if (query_info.GetBoolean("active", &bool_value))
+    query.active = bool_value;
+  if (query_info.GetBoolean("highlighted", &bool_value))
+    query.highlighted = bool_value;
+  if (query_info.GetBoolean("pinned", &bool_value))
+    query.pinned = bool_value;
+  if (query_info.GetBoolean("audible", &bool_value))
+    query.audible = bool_value;
+  if (query_info.GetBoolean("muted", &bool_value))
+    query.muted = bool_value;
+  if (query_info.GetBoolean("discarded", &bool_value))
+    query.discarded = bool_value;
+  if (query_info.GetString("status", &string_value))
+    query.loading = string_value == "loading";
+  if (query_info.GetString("url", &string_value))
+    query.url = string_value;
+  if (query_info.GetString("title", &string16_value))
+    query.title = string16_value;
+
+  std::vector<mate::Handle<WebContents>> result;
+  for (auto* contents : extensions::TabHelper::QueryTabs(query))
+    result.push_back(CreateFrom(isolate, contents));
+  return result;
+}
+
 void WebContents::OnTabCreated(const mate::Dictionary& options,
     base::Callback<void(content::WebContents*)> callback,
     content::WebContents* tab) {
@@ -2824,36 +3084,49 @@ void WebContents::OnTabCreated(const mate::Dictionary& options,
   int opener_tab_id = TabStripModel::kNoTab;
     options.Get("openerTabId", &opener_tab_id);
 
-  bool discarded = false;
-  if (options.Get("discarded", &discarded) && discarded && !active) {
-    std::string url;
-    if (options.Get("url", &url)) {
-      std::unique_ptr<content::NavigationEntryImpl> entry =
-          base::WrapUnique(new content::NavigationEntryImpl);
-      entry->SetURL(GURL(url));
-      entry->SetVirtualURL(GURL(url));
-
-      std::string title;
-      if (options.Get("title", &title)) {
-        entry->SetTitle(base::UTF8ToUTF16(title));
-      }
+  // Restored tabs are always created as placeholders and loaded later by the
+  // restore scheduler, even the active one
+  bool restore = false;
+  options.Get("restore", &restore);
 
-      std::string favicon_url;
-      if (options.Get("faviconUrl", &favicon_url) ||
-          options.Get("favIconUrl", &favicon_url)) {
-        content::FaviconStatus status;
-        status.valid = true;
-        status.url = GURL(favicon_url);
-        entry->GetFavicon() = status;
+  bool discarded = false;
+  if ((options.Get("discarded", &discarded) && discarded && !active) ||
+      restore) {
+    std::vector<std::unique_ptr<content::NavigationEntry>> entries;
+    std::vector<mate::Dictionary> navigation_entries;
+    if (options.Get("navigationEntries", &navigation_entries)) {
+      for (const auto& navigation_entry : navigation_entries) {
+        auto entry = CreateRestoredNavigationEntry(navigation_entry);
+        if (entry)
+          entries.push_back(std::move(entry));
       }
+    } else {
+      auto entry = CreateRestoredNavigationEntry(options);
+      if (entry)
+        entries.push_back(std::move(entry));
+    }
 
-      std::vector<std::unique_ptr<content::NavigationEntry>> entries;
-      entries.push_back(std::move(entry));
-      tab->GetController().Restore(entries.size() - 1,
+    if (!entries.empty()) {
+      int entry_index = entries.size() - 1;
+      options.Get("currentEntryIndex", &entry_index);
+      entry_index = std::max(0, std::min(entry_index,
+          static_cast<int>(entries.size()) - 1));
+      tab->GetController().Restore(entry_index,
           content::RestoreType::CURRENT_SESSION, &entries);
     }
 
     tab_helper->Discard();
+
+    if (restore) {
+      double last_active = 0;
+      options.Get("lastActive", &last_active);
+      auto tab_manager = static_cast<resource_coordinator::GuestTabManager*>(
+          g_browser_process->GetTabManager());
+      if (tab_manager) {
+        tab_manager->restore_scheduler()->AddTab(tab,
+            base::Time::FromJsTime(last_active));
+      }
+    }
   }
 
   int window_id = -1;
@@ -3010,9 +3283,11 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("create", &WebContents::Create);
   dict.SetMethod("createTab", &WebContents::CreateTab);
   dict.SetMethod("fromTabID", &WebContents::FromTabID);
+  dict.SetMethod("queryTabs", &WebContents::QueryTabs);
   dict.SetMethod("fromId", &mate::TrackableObject<WebContents>::FromWeakMapID);
   dict.SetMethod("getAllWebContents",
                  &mate::TrackableObject<WebContents>::GetAll);
+  dict.SetMethod("_sendToAll", &WebContents::SendIPCMessageToAll);
 }
 
 }  // namespace
@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 
+#include "atom/browser/api/ipc_channel_table.h"
 #include "atom/browser/api/save_page_handler.h"
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/common_web_contents_delegate.h"
@@ -116,6 +117,8 @@ class WebContents : public mate::TrackableObject<WebContents>,
       base::Callback<void(v8::Local<v8::Value>, v8::Local<v8::Value>)>;
 
   // Get the webcontents by tabId.
+  static std::vector<mate::Handle<WebContents>> QueryTabs(
+      v8::Isolate* isolate, const base::DictionaryValue& query_info);
   static mate::Handle<WebContents> FromTabID(
     v8::Isolate* isolate, int tab_id);
 
@@ -240,6 +243,8 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void SetPinned(bool pinned);
   void SetAutoDiscardable(bool auto_discardable);
   void Discard();
+  // Discard requested by the tab discard policy, |details| explains why.
+  bool AutoDiscard(const base::DictionaryValue& details);
 
   // Zoom
   void SetZoomLevel(double zoom);
@@ -263,6 +268,15 @@ class WebContents : public mate::TrackableObject<WebContents>,
                                   const base::string16& channel,
                                   base::SharedMemory* shared_memory);
 
+  // Sends one message to the main frame of every WebContents in |targets|,
+  // the arguments are serialized once for all of them. Returns the number of
+  // frames it was sent to.
+  static int SendIPCMessageToAll(
+      v8::Isolate* isolate,
+      const std::vector<v8::Local<v8::Value>>& targets,
+      const base::string16& channel,
+      const base::ListValue& args);
+
   // Send WebInputEvent to the page.
   void SendInputEvent(v8::Isolate* isolate, v8::Local<v8::Value> input_event);
 
@@ -463,6 +477,7 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void BeforeUnloadFired(const base::TimeTicks& proceed_time) override;
   void RenderViewReady() override;
   void RenderViewDeleted(content::RenderViewHost*) override;
+  void RenderFrameDeleted(content::RenderFrameHost* render_frame_host) override;
   void RenderProcessGone(base::TerminationStatus status) override;
   void DocumentAvailableInMainFrame() override;
   void DocumentOnLoadCompletedInMainFrame() override;
@@ -501,6 +516,7 @@ class WebContents : public mate::TrackableObject<WebContents>,
                            const MediaPlayerId& id) override;
   void DidChangeThemeColor(SkColor theme_color) override;
   void RenderViewCreated(content::RenderViewHost* render_view_host) override;
+  void DidGetUserInteraction(const blink::WebInputEvent::Type type) override;
 
   // brightray::InspectableWebContentsDelegate:
   void DevToolsReloadPage() override;
@@ -519,6 +535,7 @@ class WebContents : public mate::TrackableObject<WebContents>,
 
   bool IsBackgroundPage();
   v8::Local<v8::Value> TabValue();
+  v8::Local<v8::Value> UpdateTabValue();
 
  private:
   friend brave::TabViewGuest;
@@ -553,6 +570,30 @@ class WebContents : public mate::TrackableObject<WebContents>,
                                const base::string16& channel,
                                const base::SharedMemoryHandle& shared_memory);
 
+  // Called when a frame assigns an id to a channel.
+  void OnRegisterChannel(content::RenderFrameHost* sender,
+                         uint32_t channel_id,
+                         const std::string& event,
+                         const std::string& channel);
+
+  // Called when received a message on a registered channel.
+  void OnChannelMessage(content::RenderFrameHost* sender,
+                        uint32_t channel_id,
+                        const base::ListValue& args);
+
+  // Called when received a synchronous message on a registered channel.
+  void OnChannelMessageSync(content::RenderFrameHost* render_frame_host,
+                            uint32_t channel_id,
+                            const base::ListValue& args,
+                            IPC::Message* message);
+
+  // Emits the event of |channel_id| with the channel name prepended to
+  // |args|, like OnRendererMessage does for unregistered channels.
+  void EmitChannelMessage(content::RenderFrameHost* sender,
+                          uint32_t channel_id,
+                          const base::ListValue& args,
+                          IPC::Message* message);
+
   v8::Global<v8::Value> session_;
   v8::Global<v8::Value> devtools_web_contents_;
   v8::Global<v8::Value> debugger_;
@@ -573,6 +614,9 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // the context menu params for the current context menu;
   content::ContextMenuParams context_menu_params_;
 
+  // Channels registered by the frames of this WebContents.
+  IPCChannelTable ipc_channels_;
+
   base::WeakPtrFactory<WebContents> weak_ptr_factory_;
 
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
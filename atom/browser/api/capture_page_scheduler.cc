@@ -0,0 +1,307 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/capture_page_scheduler.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/singleton.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/trace_event/trace_event.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_widget_host.h"
+#include "content/public/browser/render_widget_host_view.h"
+#include "content/public/browser/web_contents.h"
+#include "third_party/libwebp/src/webp/encode.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/display/display.h"
+#include "ui/display/screen.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/geometry/size_conversions.h"
+#include "ui/gfx/image/image.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+// Readbacks allowed in flight at once across all web contents
+const int kMaxConcurrentCaptures = 2;
+
+const int kDefaultQuality = 90;
+
+// Time spent in a capture on the UI thread, recorded per capture
+class ScopedUIThreadTimer {
+ public:
+  explicit ScopedUIThreadTimer(base::TimeDelta* total)
+      : total_(total), start_(base::TimeTicks::Now()) {}
+  ~ScopedUIThreadTimer() { *total_ += base::TimeTicks::Now() - start_; }
+
+ private:
+  base::TimeDelta* total_;
+  base::TimeTicks start_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedUIThreadTimer);
+};
+
+}  // namespace
+
+CapturePageScheduler::Request::Request()
+    : format(FORMAT_IMAGE),
+      quality(kDefaultQuality),
+      process_id(0),
+      routing_id(0) {}
+
+CapturePageScheduler::Request::~Request() {}
+
+// static
+CapturePageScheduler* CapturePageScheduler::GetInstance() {
+  return base::Singleton<CapturePageScheduler>::get();
+}
+
+// static
+bool CapturePageScheduler::FormatFromString(const std::string& format,
+                                            Format* out) {
+  if (format == "image")
+    *out = FORMAT_IMAGE;
+  else if (format == "png")
+    *out = FORMAT_PNG;
+  else if (format == "jpeg")
+    *out = FORMAT_JPEG;
+  else if (format == "webp")
+    *out = FORMAT_WEBP;
+  else
+    return false;
+  return true;
+}
+
+CapturePageScheduler::CapturePageScheduler()
+    : in_flight_(0),
+      window_captures_(0) {}
+
+CapturePageScheduler::~CapturePageScheduler() {}
+
+void CapturePageScheduler::Capture(content::WebContents* contents,
+                                   std::unique_ptr<Request> request) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  const auto view = contents->GetRenderWidgetHostView();
+  const auto host = view ? view->GetRenderWidgetHost() : nullptr;
+  if (!view || !host) {
+    RunCallback(*request, gfx::Image(), nullptr);
+    return;
+  }
+
+  // The page may navigate or close while the request is queued so look the
+  // widget up again when the capture starts.
+  request->process_id = host->GetProcess()->GetID();
+  request->routing_id = host->GetRoutingID();
+  request->queued_time = base::TimeTicks::Now();
+  TRACE_EVENT_ASYNC_BEGIN0("browser", "CapturePage", request.get());
+
+  pending_.push_back(std::move(request));
+  StartNextCaptures();
+}
+
+void CapturePageScheduler::StartNextCaptures() {
+  while (in_flight_ < kMaxConcurrentCaptures && !pending_.empty()) {
+    std::unique_ptr<Request> request = std::move(pending_.front());
+    pending_.pop_front();
+    StartCapture(std::move(request));
+  }
+}
+
+void CapturePageScheduler::StartCapture(std::unique_ptr<Request> request) {
+  auto host = content::RenderWidgetHost::FromID(request->process_id,
+                                                request->routing_id);
+  auto view = host ? host->GetView() : nullptr;
+  if (!view) {
+    RunCallback(*request, gfx::Image(), nullptr);
+    TRACE_EVENT_ASYNC_END0("browser", "CapturePage", request.get());
+    return;
+  }
+
+  // |request| is handed to the readback callback, which may run before
+  // CopyFromSurface returns, so the UI thread time is added up front.
+  base::TimeTicks ui_start = base::TimeTicks::Now();
+  request->readback_start_time = ui_start;
+  UMA_HISTOGRAM_TIMES("CapturePage.QueueTime",
+      request->readback_start_time - request->queued_time);
+
+  // Capture full page if user doesn't specify a |rect|.
+  const gfx::Rect& rect = request->rect;
+  const gfx::Size view_size = rect.IsEmpty() ? view->GetViewBounds().size() :
+                                               rect.size();
+
+  // By default, the requested bitmap size is the view size in screen
+  // coordinates.  However, if there's more pixel detail available on the
+  // current system, increase the requested bitmap size to capture it all.
+  gfx::Size bitmap_size = view_size;
+  const gfx::NativeView native_view = view->GetNativeView();
+  const float scale =
+      display::Screen::GetScreen()->GetDisplayNearestView(native_view)
+      .device_scale_factor();
+  if (scale > 1.0f)
+    bitmap_size = gfx::ScaleToCeiledSize(view_size, scale);
+
+  // Let the compositor scale the copy down instead of reading back every
+  // pixel and resizing it afterwards.
+  const gfx::Size& max_size = request->max_size;
+  if (!max_size.IsEmpty() && !bitmap_size.IsEmpty()) {
+    float fit = std::min(
+        static_cast<float>(max_size.width()) / bitmap_size.width(),
+        static_cast<float>(max_size.height()) / bitmap_size.height());
+    if (fit < 1.0f) {
+      bitmap_size = gfx::ScaleToFlooredSize(bitmap_size, fit);
+      bitmap_size.SetToMax(gfx::Size(1, 1));
+    }
+  }
+
+  in_flight_++;
+  request->ui_thread_time += base::TimeTicks::Now() - ui_start;
+  view->CopyFromSurface(gfx::Rect(rect.origin(), view_size),
+      bitmap_size,
+      base::Bind(&CapturePageScheduler::OnCaptureDone,
+                 base::Unretained(this), base::Passed(&request)),
+      kBGRA_8888_SkColorType);
+}
+
+void CapturePageScheduler::OnCaptureDone(std::unique_ptr<Request> request,
+                                         const SkBitmap& bitmap,
+                                         content::ReadbackResponse response) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  in_flight_--;
+
+  UMA_HISTOGRAM_TIMES("CapturePage.ReadbackTime",
+      base::TimeTicks::Now() - request->readback_start_time);
+
+  if (request->format == FORMAT_IMAGE) {
+    {
+      ScopedUIThreadTimer ui_timer(&request->ui_thread_time);
+      RunCallback(*request, gfx::Image::CreateFrom1xBitmap(bitmap), nullptr);
+    }
+    Finish(std::move(request));
+  } else if (response != content::READBACK_SUCCESS || bitmap.drawsNothing()) {
+    {
+      ScopedUIThreadTimer ui_timer(&request->ui_thread_time);
+      RunCallback(*request, gfx::Image(), nullptr);
+    }
+    Finish(std::move(request));
+  } else {
+    Format format = request->format;
+    int quality = request->quality;
+    base::PostTaskWithTraitsAndReplyWithResult(
+        FROM_HERE,
+        {base::TaskPriority::USER_VISIBLE,
+         base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+        base::Bind(&CapturePageScheduler::Encode, bitmap, format, quality),
+        base::Bind(&CapturePageScheduler::OnEncodeDone,
+                   base::Unretained(this), base::Passed(&request)));
+  }
+
+  StartNextCaptures();
+}
+
+void CapturePageScheduler::OnEncodeDone(
+    std::unique_ptr<Request> request,
+    scoped_refptr<base::RefCountedMemory> data) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  {
+    ScopedUIThreadTimer ui_timer(&request->ui_thread_time);
+    // Handing over the only reference lets the Buffer wrap the data without
+    // copying it.
+    RunCallback(*request, gfx::Image(), std::move(data));
+  }
+  Finish(std::move(request));
+}
+
+void CapturePageScheduler::Finish(std::unique_ptr<Request> request) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  TRACE_EVENT_ASYNC_END0("browser", "CapturePage", request.get());
+  UMA_HISTOGRAM_TIMES("CapturePage.TotalTime", now - request->queued_time);
+  UMA_HISTOGRAM_TIMES("CapturePage.UIThreadTime", request->ui_thread_time);
+
+  // Throughput is sampled in one second windows while captures are running
+  if (window_start_.is_null() ||
+      now - window_start_ >= base::TimeDelta::FromSeconds(1)) {
+    if (!window_start_.is_null() &&
+        now - window_start_ < base::TimeDelta::FromSeconds(2)) {
+      UMA_HISTOGRAM_COUNTS_100("CapturePage.CapturesPerSecond",
+                               window_captures_);
+    }
+    window_start_ = now;
+    window_captures_ = 0;
+  }
+  window_captures_++;
+}
+
+// static
+scoped_refptr<base::RefCountedMemory> CapturePageScheduler::Encode(
+    const SkBitmap& bitmap, Format format, int quality) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  quality = std::max(0, std::min(quality, 100));
+
+  const unsigned char* pixels =
+      static_cast<const unsigned char*>(bitmap.getPixels());
+  std::vector<unsigned char> output;
+  bool success = false;
+  switch (format) {
+    case FORMAT_PNG:
+      success = gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &output);
+      break;
+    case FORMAT_JPEG:
+      success = gfx::JPEGCodec::Encode(pixels, gfx::JPEGCodec::FORMAT_BGRA,
+                                       bitmap.width(), bitmap.height(),
+                                       static_cast<int>(bitmap.rowBytes()),
+                                       quality, &output);
+      break;
+    case FORMAT_WEBP: {
+      uint8_t* webp = nullptr;
+      size_t size = WebPEncodeBGRA(pixels, bitmap.width(), bitmap.height(),
+                                   static_cast<int>(bitmap.rowBytes()),
+                                   quality, &webp);
+      if (webp) {
+        output.assign(webp, webp + size);
+        free(webp);
+      }
+      success = size > 0;
+      break;
+    }
+    case FORMAT_IMAGE:
+      NOTREACHED();
+      break;
+  }
+
+  UMA_HISTOGRAM_TIMES("CapturePage.EncodeTime",
+                      base::TimeTicks::Now() - start);
+  if (!success)
+    return nullptr;
+  return base::RefCountedBytes::TakeVector(&output);
+}
+
+// static
+void CapturePageScheduler::RunCallback(
+    const Request& request,
+    const gfx::Image& image,
+    scoped_refptr<base::RefCountedMemory> data) {
+  if (request.format == FORMAT_IMAGE)
+    request.image_callback.Run(image);
+  else
+    request.buffer_callback.Run(std::move(data));
+}
+
+}  // namespace api
+
+}  // namespace atom
@@ -0,0 +1,121 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_CAPTURE_PAGE_SCHEDULER_H_
+#define ATOM_BROWSER_API_CAPTURE_PAGE_SCHEDULER_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/time/time.h"
+#include "content/public/browser/readback_types.h"
+#include "ui/gfx/geometry/rect.h"
+#include "ui/gfx/geometry/size.h"
+
+class SkBitmap;
+
+namespace base {
+template <typename T> struct DefaultSingletonTraits;
+}
+
+namespace content {
+class WebContents;
+}
+
+namespace gfx {
+class Image;
+}
+
+namespace atom {
+
+namespace api {
+
+// Runs capturePage readbacks for all web contents. Only a few readbacks are
+// in flight at once, the copy is scaled down by the compositor when a target
+// size is given and encoding happens on a background sequence, so a burst of
+// thumbnail captures does not stall the UI thread.
+class CapturePageScheduler {
+ public:
+  enum Format {
+    // Deliver a NativeImage instead of encoded data.
+    FORMAT_IMAGE,
+    FORMAT_PNG,
+    FORMAT_JPEG,
+    FORMAT_WEBP,
+  };
+
+  struct Request {
+    Request();
+    ~Request();
+
+    // Area of the page to capture. Empty captures the whole view.
+    gfx::Rect rect;
+    // The capture is scaled down to fit in |max_size| if it is not empty.
+    gfx::Size max_size;
+    Format format;
+    // Quality for lossy formats, 0 - 100.
+    int quality;
+
+    // Exactly one of these is run, depending on |format|.
+    base::Callback<void(const gfx::Image&)> image_callback;
+    base::Callback<void(scoped_refptr<base::RefCountedMemory>)>
+        buffer_callback;
+
+    // Bookkeeping filled in by the scheduler.
+    int process_id;
+    int routing_id;
+    base::TimeTicks queued_time;
+    base::TimeTicks readback_start_time;
+    base::TimeDelta ui_thread_time;
+  };
+
+  static CapturePageScheduler* GetInstance();
+
+  static bool FormatFromString(const std::string& format, Format* out);
+
+  // Queues a capture of |contents|. The callback in |request| always runs,
+  // with an empty result if the page could not be captured.
+  void Capture(content::WebContents* contents,
+               std::unique_ptr<Request> request);
+
+ private:
+  friend struct base::DefaultSingletonTraits<CapturePageScheduler>;
+
+  CapturePageScheduler();
+  ~CapturePageScheduler();
+
+  void StartNextCaptures();
+  void StartCapture(std::unique_ptr<Request> request);
+  void OnCaptureDone(std::unique_ptr<Request> request,
+                     const SkBitmap& bitmap,
+                     content::ReadbackResponse response);
+  void OnEncodeDone(std::unique_ptr<Request> request,
+                    scoped_refptr<base::RefCountedMemory> data);
+  void Finish(std::unique_ptr<Request> request);
+
+  static scoped_refptr<base::RefCountedMemory> Encode(const SkBitmap& bitmap,
+                                                      Format format,
+                                                      int quality);
+  static void RunCallback(const Request& request, const gfx::Image& image,
+                          scoped_refptr<base::RefCountedMemory> data);
+
+  std::deque<std::unique_ptr<Request>> pending_;
+  int in_flight_;
+
+  // Completed captures in the current one second throughput window.
+  base::TimeTicks window_start_;
+  int window_captures_;
+
+  DISALLOW_COPY_AND_ASSIGN(CapturePageScheduler);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_CAPTURE_PAGE_SCHEDULER_H_
@@ -52,6 +52,8 @@ bool Event::SendReply(const base::string16& json) {
   if (message_ == nullptr || sender_ == nullptr)
     return false;
 
+  // Also replies to AtomViewHostMsg_ChannelMessage_Sync, which has the same
+  // reply params.
   AtomViewHostMsg_Message_Sync::WriteReplyParams(message_, json);
   bool success = sender_->Send(message_);
   message_ = nullptr;
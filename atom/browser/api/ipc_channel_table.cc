@@ -0,0 +1,65 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/ipc_channel_table.h"
+
+#include <utility>
+
+#include "atom/common/atom_constants.h"
+#include "native_mate/converter.h"
+
+namespace atom {
+
+namespace api {
+
+IPCChannelTable::Channel::Channel() {}
+
+IPCChannelTable::Channel::Channel(Channel&& other)
+    : event(std::move(other.event)), name(std::move(other.name)) {}
+
+IPCChannelTable::Channel::~Channel() {}
+
+IPCChannelTable::IPCChannelTable() {}
+
+IPCChannelTable::~IPCChannelTable() {}
+
+bool IPCChannelTable::Register(v8::Isolate* isolate,
+                               content::RenderFrameHost* frame,
+                               uint32_t channel_id,
+                               const std::string& event,
+                               const std::string& channel) {
+  if (channel_id >= kMaxIPCChannels)
+    return false;
+
+  std::vector<Channel>& channels = frames_[frame];
+  if (channel_id >= channels.size())
+    channels.resize(channel_id + 1);
+
+  v8::HandleScope handle_scope(isolate);
+  channels[channel_id].event = event;
+  channels[channel_id].name.Reset(isolate,
+                                  mate::StringToSymbol(isolate, channel));
+  return true;
+}
+
+const IPCChannelTable::Channel* IPCChannelTable::Find(
+    content::RenderFrameHost* frame,
+    uint32_t channel_id) const {
+  auto it = frames_.find(frame);
+  if (it == frames_.end() || channel_id >= it->second.size())
+    return nullptr;
+
+  const Channel& channel = it->second[channel_id];
+  if (channel.name.IsEmpty())
+    return nullptr;
+  return &channel;
+}
+
+void IPCChannelTable::RemoveFrame(content::RenderFrameHost* frame) {
+  frames_.erase(frame);
+}
+
+}  // namespace api
+
+}  // namespace atom
@@ -0,0 +1,65 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_IPC_CHANNEL_TABLE_H_
+#define ATOM_BROWSER_API_IPC_CHANNEL_TABLE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "v8/include/v8.h"
+
+namespace content {
+class RenderFrameHost;
+}
+
+namespace atom {
+
+namespace api {
+
+// The ipc channels registered by the frames of a WebContents, indexed by the
+// ids their IPCChannelRegistry assigned.
+class IPCChannelTable {
+ public:
+  struct Channel {
+    Channel();
+    Channel(Channel&& other);
+    ~Channel();
+
+    // The event emitted on the WebContents, ipc-message or ipc-message-sync.
+    std::string event;
+    // Created once so dispatching a message doesn't convert the name.
+    v8::Global<v8::String> name;
+  };
+
+  IPCChannelTable();
+  ~IPCChannelTable();
+
+  // Returns false if |channel_id| is out of range. A renderer process that
+  // replaces a crashed one registers its ids again, overwriting the old ones.
+  bool Register(v8::Isolate* isolate,
+                content::RenderFrameHost* frame,
+                uint32_t channel_id,
+                const std::string& event,
+                const std::string& channel);
+
+  // Returns nullptr if |frame| hasn't registered |channel_id|.
+  const Channel* Find(content::RenderFrameHost* frame,
+                      uint32_t channel_id) const;
+
+  void RemoveFrame(content::RenderFrameHost* frame);
+
+ private:
+  std::map<content::RenderFrameHost*, std::vector<Channel>> frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(IPCChannelTable);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_IPC_CHANNEL_TABLE_H_
@@ -2,6 +2,8 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <map>
+#include <string>
 #include <utility>
 
 #include "atom/browser/atom_browser_main_parts.h"
@@ -17,16 +19,21 @@
 #include "atom/common/api/atom_bindings.h"
 #include "atom/common/node_bindings.h"
 #include "atom/common/node_includes.h"
+#include "atom/common/options_switches.h"
 #include "base/allocator/allocator_extension.h"
 #include "base/command_line.h"
 #include "base/feature_list.h"
 #include "base/files/file_util.h"
 #include "base/memory/memory_pressure_monitor.h"
+#include "base/metrics/field_trial.h"
+#include "base/metrics/field_trial_params.h"
 #include "base/path_service.h"
 #include "base/profiler/stack_sampling_profiler.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/time/default_tick_clock.h"
 #include "base/trace_event/trace_event.h"
+#include "brave/browser/profile_read_ahead.h"
 #include "browser/media/media_capture_devices_dispatcher.h"
 #include "chrome/browser/browser_shutdown.h"
 #include "chrome/browser/profiles/profile_manager.h"
@@ -107,6 +114,25 @@ void InitializeWindowProcExceptions() {
 }
 #endif  // defined (OS_WIN)
 
+// The trial content reads the parallel download params from.
+const char kParallelDownloadingTrial[] = "ParallelDownloading";
+const char kParallelDownloadingGroup[] = "Enabled";
+
+// Returns the trial that enables parallel downloading with |segments| range
+// requests, or nullptr if downloads use a single request.
+base::FieldTrial* CreateParallelDownloadingTrial(int segments) {
+  if (segments < 2)
+    return nullptr;
+
+  std::map<std::string, std::string> params;
+  params["request_count"] = base::IntToString(segments);
+  if (!base::AssociateFieldTrialParams(kParallelDownloadingTrial,
+                                       kParallelDownloadingGroup, params))
+    return nullptr;
+  return base::FieldTrialList::CreateFieldTrial(kParallelDownloadingTrial,
+                                                kParallelDownloadingGroup);
+}
+
 }  // namespace
 
 // A provider of Geolocation services to override AccessTokenStore.
@@ -249,7 +275,7 @@ void AtomBrowserMainParts::OnMemoryPressure(
   base::allocator::ReleaseFreeMemory();
 
   if (js_env_.get() && js_env_->isolate()) {
-    js_env_->isolate()->LowMemoryNotification();
+    js_env_->OnMemoryPressure(memory_pressure_level);
   }
 }
 
@@ -268,6 +294,8 @@ void AtomBrowserMainParts::PreMainMessageLoopStart() {
 #endif
 
 void AtomBrowserMainParts::PreMainMessageLoopRun() {
+  TRACE_EVENT0("startup", "AtomBrowserMainParts::PreMainMessageLoopRun");
+
 #if defined(USE_AURA)
   if (content::ServiceManagerConnection::GetForProcess() &&
       service_manager::ServiceManagerIsRemote()) {
@@ -284,20 +312,37 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
   content::WebUIControllerFactory::RegisterFactory(
       ChromeWebUIControllerFactory::GetInstance());
 
-  js_env_.reset(new JavascriptEnvironment);
-  js_env_->isolate()->Enter();
+  // Overlap the default profile's disk reads with the JS bootstrap.
+  base::FilePath user_data;
+  if (PathService::Get(chrome::DIR_USER_DATA, &user_data))
+    brave::ProfileReadAhead::Start(user_data);
+
+  {
+    TRACE_EVENT0("startup",
+      "AtomBrowserMainParts::PreMainMessageLoopRun:InitJavascriptEnvironment");
+    js_env_.reset(new JavascriptEnvironment);
+    js_env_->isolate()->Enter();
 
-  node_bindings_->Initialize();
+    node_bindings_->Initialize();
+  }
 
-  // Create the global environment.
-  node::Environment* env =
-      node_bindings_->CreateEnvironment(js_env_->context());
+  node::Environment* env;
+  {
+    TRACE_EVENT0("startup",
+      "AtomBrowserMainParts::PreMainMessageLoopRun:CreateEnvironment");
+    // Create the global environment.
+    env = node_bindings_->CreateEnvironment(js_env_->context());
 
-  // Add atom-shell extended APIs.
-  atom_bindings_->BindTo(js_env_->isolate(), env->process_object());
+    // Add atom-shell extended APIs.
+    atom_bindings_->BindTo(js_env_->isolate(), env->process_object());
+  }
 
-  // Load everything.
-  node_bindings_->LoadEnvironment(env);
+  {
+    TRACE_EVENT0("startup",
+      "AtomBrowserMainParts::PreMainMessageLoopRun:LoadEnvironment");
+    // Load everything.
+    node_bindings_->LoadEnvironment(env);
+  }
 
   // Wrap the uv loop with global env.
   node_bindings_->set_uv_env(env);
@@ -316,31 +361,42 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
         base::Unretained(this))));
 
   // Make sure the userData directory is created.
-  base::FilePath user_data;
   if (PathService::Get(chrome::DIR_USER_DATA, &user_data))
     base::CreateDirectoryAndGetError(user_data, nullptr);
 
   // PreProfileInit
-  EnsureBrowserContextKeyedServiceFactoriesBuilt();
+  {
+    TRACE_EVENT0("startup",
+      "AtomBrowserMainParts::PreMainMessageLoopRun:BuildServiceFactories");
+    EnsureBrowserContextKeyedServiceFactoriesBuilt();
+  }
   auto command_line = base::CommandLine::ForCurrentProcess();
 #if defined(OS_LINUX)
-  std::unique_ptr<os_crypt::Config> config(new os_crypt::Config());
-  // Forward to os_crypt the flag to use a specific password store.
-  config->store =
-      command_line->GetSwitchValueASCII(switches::kPasswordStore);
-  // Forward the product name
-  config->product_name = l10n_util::GetStringUTF8(IDS_PRODUCT_NAME);
-  // OSCrypt may target keyring, which requires calls from the main thread.
-  config->main_thread_runner = content::BrowserThread::GetTaskRunnerForThread(
-      content::BrowserThread::UI);
-  // OSCrypt can be disabled in a special settings file.
-  config->should_use_preference =
-      command_line->HasSwitch(switches::kEnableEncryptionSelection);
-  chrome::GetDefaultUserDataDirectory(&config->user_data_path);
-  OSCrypt::SetConfig(std::move(config));
+  {
+    TRACE_EVENT0("startup",
+      "AtomBrowserMainParts::PreMainMessageLoopRun:ConfigureOSCrypt");
+    std::unique_ptr<os_crypt::Config> config(new os_crypt::Config());
+    // Forward to os_crypt the flag to use a specific password store.
+    config->store =
+        command_line->GetSwitchValueASCII(::switches::kPasswordStore);
+    // Forward the product name
+    config->product_name = l10n_util::GetStringUTF8(IDS_PRODUCT_NAME);
+    // OSCrypt may target keyring, which requires calls from the main thread.
+    config->main_thread_runner = content::BrowserThread::GetTaskRunnerForThread(
+        content::BrowserThread::UI);
+    // OSCrypt can be disabled in a special settings file.
+    config->should_use_preference =
+        command_line->HasSwitch(::switches::kEnableEncryptionSelection);
+    chrome::GetDefaultUserDataDirectory(&config->user_data_path);
+    OSCrypt::SetConfig(std::move(config));
+  }
 #endif
 
-  browser_context_ = ProfileManager::GetActiveUserProfile();
+  {
+    TRACE_EVENT0("startup",
+      "AtomBrowserMainParts::PreMainMessageLoopRun:GetActiveUserProfile");
+    browser_context_ = ProfileManager::GetActiveUserProfile();
+  }
   brightray::BrowserMainParts::PreMainMessageLoopRun();
 
   js_env_->OnMessageLoopCreated();
@@ -358,9 +414,12 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
   Browser::Get()->DidFinishLaunching(*empty_info);
 #endif
 
+  // Field trials are only used to pass params to features below.
+  field_trial_list_.reset(new base::FieldTrialList(nullptr));
+
   base::FeatureList::InitializeInstance(
-      command_line->GetSwitchValueASCII(switches::kEnableFeatures),
-      command_line->GetSwitchValueASCII(switches::kDisableFeatures));
+      command_line->GetSwitchValueASCII(::switches::kEnableFeatures),
+      command_line->GetSwitchValueASCII(::switches::kDisableFeatures));
   auto feature_list = base::FeatureList::GetInstance();
   // temporary workaround for flash
   auto field_trial =
@@ -378,6 +437,18 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
   feature_list->RegisterFieldTrialOverride(
                       features::kGuestViewCrossProcessFrames.name,
                       base::FeatureList::OVERRIDE_DISABLE_FEATURE, field_trial);
+
+  int download_segments = 0;
+  base::StringToInt(command_line->GetSwitchValueASCII(
+                        switches::kParallelDownloadSegments),
+                    &download_segments);
+  field_trial = CreateParallelDownloadingTrial(download_segments);
+  if (field_trial) {
+    feature_list->RegisterFieldTrialOverride(
+                        features::kParallelDownloading.name,
+                        base::FeatureList::OVERRIDE_ENABLE_FEATURE,
+                        field_trial);
+  }
 }
 
 
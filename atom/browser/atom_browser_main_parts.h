@@ -20,6 +20,10 @@
 
 class BrowserProcessImpl;
 
+namespace base {
+class FieldTrialList;
+}
+
 namespace brightray {
 class BrowserContext;
 }
@@ -106,6 +110,7 @@ class AtomBrowserMainParts : public brightray::BrowserMainParts {
 
   base::Timer gc_timer_;
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  std::unique_ptr<base::FieldTrialList> field_trial_list_;
 
   // Members needed across shutdown methods.
   bool restart_last_session_ = false;
@@ -4,7 +4,9 @@
 
 #include "atom/browser/extensions/tab_helper.h"
 
+#include <algorithm>
 #include <map>
+#include <set>
 #include <utility>
 #include "atom/browser/extensions/api/atom_extensions_api_client.h"
 #include "atom/browser/extensions/atom_extension_web_contents_observer.h"
@@ -12,12 +14,17 @@
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/perf_counters.h"
+#include "base/bind.h"
+#include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/browser/brave_browser_context.h"
 #include "brave/browser/guest_view/tab_view/tab_view_guest.h"
+#include "brave/browser/guest_view/tab_view/tab_view_guest_pool.h"
 #include "brave/browser/resource_coordinator/guest_tab_manager.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/browser_shutdown.h"
+#include "chrome/browser/extensions/extension_tab_util.h"
 #include "chrome/browser/sessions/session_tab_helper.h"
 #include "chrome/browser/ui/browser.h"
 #include "chrome/browser/ui/browser_list.h"
@@ -26,6 +33,7 @@
 #include "chrome/browser/ui/tabs/tab_strip_model_order_controller.h"
 #include "components/sessions/core/session_id.h"
 #include "content/public/browser/browser_context.h"
+#include "content/public/browser/favicon_status.h"
 #include "content/public/browser/navigation_entry.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
@@ -75,8 +83,108 @@ TabManager* GetTabManager() {
   return g_browser_process->GetTabManager();
 }
 
+// Tabs by the id of the window they are in, used by QueryTabs.
+std::map<int32_t, std::set<TabHelper*>> window_tabs_map_;
+
+// The master Brave container window is never reported to extensions.
+const char kBraveContainerPrefix[] = "chrome://brave";
+
+// Records how long the tab took to create, including the wait for a new guest.
+void OnTabCreated(base::TimeTicks start,
+                  const GuestViewManager::WebContentsCreatedCallback& callback,
+                  content::WebContents* tab) {
+  atom::PerfCounters::AddTime(atom::PerfMetric::TAB_CREATE,
+                              base::TimeTicks::Now() - start);
+  callback.Run(tab);
+}
+
 }  // namespace
 
+TabState::TabState()
+    : window_id(-1),
+      index(TabStripModel::kNoTab),
+      active(false),
+      highlighted(false),
+      pinned(false),
+      audible(false),
+      muted(false),
+      discarded(false),
+      auto_discardable(true),
+      loading(false),
+      incognito(false),
+      opener_tab_id(TabStripModel::kNoTab) {}
+
+TabState::TabState(const TabState& other) = default;
+
+TabState::~TabState() {}
+
+uint32_t TabState::Diff(const TabState& other) const {
+  uint32_t changes = 0;
+  if (window_id != other.window_id)
+    changes |= WINDOW_ID;
+  if (index != other.index)
+    changes |= INDEX;
+  if (active != other.active)
+    changes |= ACTIVE;
+  if (highlighted != other.highlighted)
+    changes |= HIGHLIGHTED;
+  if (pinned != other.pinned)
+    changes |= PINNED;
+  if (audible != other.audible)
+    changes |= AUDIBLE;
+  if (muted != other.muted)
+    changes |= MUTED;
+  if (discarded != other.discarded)
+    changes |= DISCARDED;
+  if (auto_discardable != other.auto_discardable)
+    changes |= AUTO_DISCARDABLE;
+  if (loading != other.loading)
+    changes |= STATUS;
+  if (incognito != other.incognito)
+    changes |= INCOGNITO;
+  if (size != other.size)
+    changes |= SIZE;
+  if (url != other.url)
+    changes |= URL;
+  if (title != other.title)
+    changes |= TITLE;
+  if (fav_icon_url != other.fav_icon_url)
+    changes |= FAV_ICON_URL;
+  if (opener_tab_id != other.opener_tab_id)
+    changes |= OPENER_TAB_ID;
+  return changes;
+}
+
+TabQuery::TabQuery() {}
+
+TabQuery::~TabQuery() {}
+
+bool TabQuery::Matches(const TabState& state) const {
+  if (window_id && *window_id != state.window_id)
+    return false;
+  if (index && *index != state.index)
+    return false;
+  if (active && *active != state.active)
+    return false;
+  if (highlighted && *highlighted != state.highlighted)
+    return false;
+  if (pinned && *pinned != state.pinned)
+    return false;
+  if (audible && *audible != state.audible)
+    return false;
+  if (muted && *muted != state.muted)
+    return false;
+  if (discarded && *discarded != state.discarded)
+    return false;
+  if (loading && *loading != state.loading)
+    return false;
+  if (url && *url != state.url.spec())
+    return false;
+  if (title && *title != state.title)
+    return false;
+  return true;
+}
+
 TabHelper::TabHelper(content::WebContents* contents)
     : content::WebContentsObserver(contents),
       values_(new base::DictionaryValue),
@@ -89,9 +197,12 @@ TabHelper::TabHelper(content::WebContents* contents)
       is_placeholder_(false),
       window_closing_(false),
       opener_tab_id_(TabStripModel::kNoTab),
+      has_tab_state_(false),
+      indexed_window_id_(-1),
       browser_(nullptr) {
   SessionTabHelper::CreateForWebContents(contents);
   SetWindowId(-1);
+  UpdateWindowIndex(window_id());
 
   RenderViewCreated(contents->GetRenderViewHost());
   contents->ForEachFrame(
@@ -103,6 +214,13 @@ TabHelper::TabHelper(content::WebContents* contents)
 
 TabHelper::~TabHelper() {
   BrowserList::RemoveObserver(this);
+
+  auto it = window_tabs_map_.find(indexed_window_id_);
+  if (it != window_tabs_map_.end()) {
+    it->second.erase(this);
+    if (it->second.empty())
+      window_tabs_map_.erase(it);
+  }
 }
 
 // static
@@ -127,10 +245,20 @@ void TabHelper::CreateTab(content::WebContents* owner,
         profile->original_context()->partition_with_prefix());
   }
 
+  GuestViewManager::WebContentsCreatedCallback timed_callback =
+      base::Bind(&OnTabCreated, base::TimeTicks::Now(), callback);
+  content::WebContents* pooled_contents =
+      brave::TabViewGuestPool::GetInstance()->Take(
+          owner, browser_context, *params.get());
+  if (pooled_contents) {
+    timed_callback.Run(pooled_contents);
+    return;
+  }
+
   guest_view_manager->CreateGuest(brave::TabViewGuest::Type,
                                   owner,
                                   *params.get(),
-                                  callback);
+                                  timed_callback);
 }
 
 // static
@@ -339,6 +467,17 @@ void TabHelper::TabReplacedAt(TabStripModel* tab_strip_model,
   new_guest->AttachGuest(new_guest->guest_instance_id());
 }
 
+void TabHelper::TabInsertedAt(TabStripModel* tab_strip_model,
+                              content::WebContents* contents,
+                              int index,
+                              bool foreground) {
+  if (contents != web_contents())
+    return;
+
+  // The browser assigns its window id to tabs inserted into it
+  UpdateWindowIndex(window_id());
+}
+
 void TabHelper::TabDetachedAt(content::WebContents* contents, int index) {
   if (contents != web_contents())
     return;
@@ -380,17 +519,23 @@ void TabHelper::SetActive(bool active) {
 }
 
 void TabHelper::WasShown() {
-  if (discarded_) {
-    // load the tab if it is shown without being activate (tab preview)
-    discarded_ = false;
-    SetAutoDiscardable(true);
-    auto helper = content::RestoreHelper::FromWebContents(web_contents());
-    if (helper) {
-      helper->RemoveRestoreHelper();
-    }
+  // load the tab if it is shown without being activate (tab preview)
+  LoadDiscarded();
+}
 
-    web_contents()->GetController().Reload(content::ReloadType::NORMAL, true);
+bool TabHelper::LoadDiscarded() {
+  if (!discarded_)
+    return false;
+
+  discarded_ = false;
+  SetAutoDiscardable(true);
+  auto helper = content::RestoreHelper::FromWebContents(web_contents());
+  if (helper) {
+    helper->RemoveRestoreHelper();
   }
+
+  web_contents()->GetController().Reload(content::ReloadType::NORMAL, true);
+  return true;
 }
 
 void TabHelper::UpdateBrowser(Browser* browser) {
@@ -456,6 +601,7 @@ void TabHelper::SetWindowId(const int32_t& id) {
   SessionID session;
   session.set_id(id);
   SessionTabHelper::FromWebContents(web_contents())->SetWindowID(session);
+  UpdateWindowIndex(id);
 }
 
 int32_t TabHelper::window_id() const {
@@ -533,6 +679,123 @@ brave::TabViewGuest* TabHelper::guest() const {
   return guest;
 }
 
+TabState TabHelper::GetCurrentTabState() const {
+  content::WebContents* contents = web_contents();
+  TabStripModel* tab_strip = nullptr;
+  int tab_index = TabStripModel::kNoTab;
+  ExtensionTabUtil::GetTabStripModel(contents, &tab_strip, &tab_index);
+
+  TabState state;
+  state.window_id = ExtensionTabUtil::GetWindowIdOfTab(contents);
+  state.index = get_index();
+  state.active = is_active();
+  state.highlighted = tab_strip && tab_strip->IsTabSelected(tab_index);
+  state.pinned = is_pinned();
+  state.audible = contents->WasRecentlyAudible();
+  state.muted = contents->IsAudioMuted();
+  state.discarded = const_cast<TabHelper*>(this)->IsDiscarded();
+  state.auto_discardable = GetTabManager()->IsTabAutoDiscardable(contents);
+  state.loading = contents->IsLoading();
+  state.incognito = contents->GetBrowserContext()->IsOffTheRecord();
+  state.size = contents->GetContainerBounds().size();
+  state.url = contents->GetURL();
+  state.title = contents->GetTitle();
+  content::NavigationEntry* entry =
+      contents->GetController().GetVisibleEntry();
+  if (entry && entry->GetFavicon().valid)
+    state.fav_icon_url = entry->GetFavicon().url;
+  state.opener_tab_id = opener_tab_id_;
+  return state;
+}
+
+uint32_t TabHelper::UpdateTabState() {
+  TabState state = GetCurrentTabState();
+  uint32_t changes =
+      has_tab_state_ ? state.Diff(tab_state_) : TabState::ALL_FIELDS;
+  tab_state_ = state;
+  has_tab_state_ = true;
+
+  if (changes & TabState::WINDOW_ID)
+    UpdateWindowIndex(window_id());
+  return changes;
+}
+
+void TabHelper::UpdateWindowIndex(int32_t window_id) {
+  if (window_id == indexed_window_id_ &&
+      window_tabs_map_[window_id].count(this))
+    return;
+
+  auto it = window_tabs_map_.find(indexed_window_id_);
+  if (it != window_tabs_map_.end()) {
+    it->second.erase(this);
+    if (it->second.empty())
+      window_tabs_map_.erase(it);
+  }
+
+  indexed_window_id_ = window_id;
+  window_tabs_map_[window_id].insert(this);
+}
+
+bool TabHelper::MayMatch(const TabQuery& query) const {
+  content::WebContents* contents = web_contents();
+  const GURL& url = contents->GetURL();
+  if (base::StartsWith(url.spec(), kBraveContainerPrefix,
+                       base::CompareCase::SENSITIVE))
+    return false;
+  if (query.url && *query.url != url.spec())
+    return false;
+  if (query.pinned && *query.pinned != is_pinned())
+    return false;
+  if (query.active && *query.active != is_active())
+    return false;
+  if (query.loading && *query.loading != contents->IsLoading())
+    return false;
+  if (query.muted && *query.muted != contents->IsAudioMuted())
+    return false;
+  if (query.audible && *query.audible != contents->WasRecentlyAudible())
+    return false;
+  return true;
+}
+
+// static
+std::vector<content::WebContents*> TabHelper::QueryTabs(
+    const TabQuery& query) {
+  std::vector<TabHelper*> candidates;
+  if (query.window_id) {
+    auto it = window_tabs_map_.find(*query.window_id);
+    if (it != window_tabs_map_.end())
+      candidates.assign(it->second.begin(), it->second.end());
+  } else {
+    for (const auto& window : window_tabs_map_)
+      candidates.insert(candidates.end(),
+                        window.second.begin(), window.second.end());
+  }
+
+  std::vector<std::pair<int32_t, content::WebContents*>> matches;
+  for (TabHelper* tab_helper : candidates) {
+    if (!tab_helper->web_contents())
+      continue;
+
+    // The index only narrows the search by window. Fields that are cheap to
+    // read rule out most tabs before the full state is built for the rest
+    if (!tab_helper->MayMatch(query))
+      continue;
+
+    TabState state = tab_helper->GetCurrentTabState();
+    if (!query.Matches(state))
+      continue;
+
+    matches.push_back(
+        std::make_pair(tab_helper->session_id(), tab_helper->web_contents()));
+  }
+
+  std::sort(matches.begin(), matches.end());
+  std::vector<content::WebContents*> result;
+  for (const auto& match : matches)
+    result.push_back(match.second);
+  return result;
+}
+
 void TabHelper::SetTabValues(const base::DictionaryValue& values) {
   values_->MergeDictionary(&values);
 }
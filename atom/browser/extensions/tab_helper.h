@@ -7,9 +7,12 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "atom/browser/native_window_observer.h"
 #include "base/macros.h"
+#include "base/optional.h"
+#include "base/strings/string16.h"
 #include "chrome/browser/ui/browser_list_observer.h"
 #include "chrome/browser/ui/tabs/tab_strip_model_observer.h"
 #include "components/guest_view/browser/guest_view_manager.h"
@@ -18,6 +21,8 @@
 #include "extensions/browser/extension_function_dispatcher.h"
 #include "extensions/browser/script_execution_observer.h"
 #include "extensions/browser/script_executor.h"
+#include "ui/gfx/geometry/size.h"
+#include "url/gurl.h"
 
 class Browser;
 
@@ -54,6 +59,75 @@ namespace extensions {
 
 class Extension;
 
+// Snapshot of the tab properties reported by the tabs API. Comparing two
+// snapshots gives the set of fields that changed, so tab events can be
+// produced without building and diffing tab dictionaries.
+struct TabState {
+  enum Field : uint32_t {
+    WINDOW_ID = 1 << 0,
+    INDEX = 1 << 1,
+    ACTIVE = 1 << 2,
+    HIGHLIGHTED = 1 << 3,
+    PINNED = 1 << 4,
+    AUDIBLE = 1 << 5,
+    MUTED = 1 << 6,
+    DISCARDED = 1 << 7,
+    AUTO_DISCARDABLE = 1 << 8,
+    STATUS = 1 << 9,
+    INCOGNITO = 1 << 10,
+    SIZE = 1 << 11,
+    URL = 1 << 12,
+    TITLE = 1 << 13,
+    FAV_ICON_URL = 1 << 14,
+    OPENER_TAB_ID = 1 << 15,
+    ALL_FIELDS = (1 << 16) - 1,
+  };
+
+  TabState();
+  TabState(const TabState& other);
+  ~TabState();
+
+  // Returns the fields that differ from |other|.
+  uint32_t Diff(const TabState& other) const;
+
+  int32_t window_id;
+  int index;
+  bool active;
+  bool highlighted;
+  bool pinned;
+  bool audible;
+  bool muted;
+  bool discarded;
+  bool auto_discardable;
+  bool loading;
+  bool incognito;
+  gfx::Size size;
+  GURL url;
+  base::string16 title;
+  GURL fav_icon_url;
+  int opener_tab_id;
+};
+
+// Properties to match in TabHelper::QueryTabs. Unset fields match any tab.
+struct TabQuery {
+  TabQuery();
+  ~TabQuery();
+
+  bool Matches(const TabState& state) const;
+
+  base::Optional<int32_t> window_id;
+  base::Optional<int> index;
+  base::Optional<bool> active;
+  base::Optional<bool> highlighted;
+  base::Optional<bool> pinned;
+  base::Optional<bool> audible;
+  base::Optional<bool> muted;
+  base::Optional<bool> discarded;
+  base::Optional<bool> loading;
+  base::Optional<std::string> url;
+  base::Optional<base::string16> title;
+};
+
 // This class keeps the extension API's windowID up-to-date with the current
 // window of the tab.
 class TabHelper : public content::WebContentsObserver,
@@ -98,8 +172,24 @@ class TabHelper : public content::WebContentsObserver,
 
   bool IsDiscarded();
 
+  // Loads a tab that was discarded before it was attached (e.g. a restored
+  // tab). Returns false if there was nothing to load.
+  bool LoadDiscarded();
+
   void DidAttach();
 
+  // Refreshes the tab state from the web contents and returns the
+  // TabState::Field bits that changed since the previous call. The first call
+  // reports every field.
+  uint32_t UpdateTabState();
+  const TabState& tab_state() const { return tab_state_; }
+
+  // Returns the tabs matching |query| in tab id order. Tabs are indexed by
+  // window so a query for a single window only looks at that window's tabs.
+  // Other properties are not indexed, the tabs in the searched windows are
+  // filtered on cheap fields before their full state is built.
+  static std::vector<content::WebContents*> QueryTabs(const TabQuery& query);
+
   void SetTabValues(const base::DictionaryValue& values);
   base::DictionaryValue* getTabValues() {
     return values_.get();
@@ -148,6 +238,10 @@ class TabHelper : public content::WebContentsObserver,
   explicit TabHelper(content::WebContents* contents);
   friend class content::WebContentsUserData<TabHelper>;
 
+  void TabInsertedAt(TabStripModel* tab_strip_model,
+                     content::WebContents* contents,
+                     int index,
+                     bool foreground) override;
   void TabDetachedAt(content::WebContents* contents, int index) override;
   void TabReplacedAt(TabStripModel* tab_strip_model,
                      content::WebContents* old_contents,
@@ -164,6 +258,12 @@ class TabHelper : public content::WebContentsObserver,
   void MaybeAttachOrCreatePinnedTab();
   void MaybeRequestWindowClose();
 
+  TabState GetCurrentTabState() const;
+  // False if |query| can't match the tab, checking only the fields that
+  // don't need the full state. Container pages never match.
+  bool MayMatch(const TabQuery& query) const;
+  void UpdateWindowIndex(int32_t window_id);
+
   // atom::NativeWindowObserver overrides.
   void WillCloseWindow(bool* prevent_default) override;
 
@@ -201,6 +301,13 @@ class TabHelper : public content::WebContentsObserver,
   bool window_closing_;
   int opener_tab_id_;
 
+  // Last state returned by UpdateTabState.
+  TabState tab_state_;
+  bool has_tab_state_;
+
+  // The window this tab is filed under in the query index.
+  int32_t indexed_window_id_;
+
   Browser* browser_;
 
   DISALLOW_COPY_AND_ASSIGN(TabHelper);
@@ -9,6 +9,7 @@
 #include <utility>
 #include <vector>
 
+#include "atom/browser/javascript_idle_scheduler.h"
 #include "base/base_paths.h"
 #include "base/command_line.h"
 #include "base/files/file_path.h"
@@ -128,8 +129,11 @@ JavascriptEnvironment::JavascriptEnvironment()
       isolate_scope_(isolate_),
       locker_(isolate_),
       handle_scope_(isolate_),
+      idle_scheduler_(new JavascriptIdleScheduler(isolate_)),
       context_holder_(new gin::ContextHolder(isolate_)),
       source_map_(GetModuleSearchPaths()) {
+  isolate_holder_->EnableIdleTasks(idle_scheduler_->CreateIdleTaskRunner());
+
   v8::Local<v8::ObjectTemplate> templ = ObjectTemplateBuilder(isolate_).Build();
   ModuleRegistry::RegisterGlobals(isolate_, templ);
 
@@ -195,12 +199,19 @@ JavascriptEnvironment::~JavascriptEnvironment() {
 
 void JavascriptEnvironment::OnMessageLoopCreated() {
   isolate_holder_->AddRunMicrotasksObserver();
+  idle_scheduler_->OnMessageLoopCreated();
 }
 
 void JavascriptEnvironment::OnMessageLoopDestroying() {
+  idle_scheduler_->OnMessageLoopDestroying();
   isolate_holder_->RemoveRunMicrotasksObserver();
 }
 
+void JavascriptEnvironment::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  idle_scheduler_->OnMemoryPressure(memory_pressure_level);
+}
+
 bool JavascriptEnvironment::Initialize() {
   auto cmd = base::CommandLine::ForCurrentProcess();
 
@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "brave/common/extensions/asar_source_map.h"
 #include "extensions/renderer/script_context.h"
 #include "gin/modules/module_runner_delegate.h"
@@ -21,6 +22,8 @@ class ModuleSystem;
 
 namespace atom {
 
+class JavascriptIdleScheduler;
+
 class JavascriptEnvironment {
  public:
   JavascriptEnvironment();
@@ -29,6 +32,10 @@ class JavascriptEnvironment {
   void OnMessageLoopCreated();
   void OnMessageLoopDestroying();
 
+  // Collects garbage without blocking the thread while input is handled.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
   v8::Isolate* isolate() const { return isolate_; }
   extensions::ScriptContext* script_context() const {
     return script_context_.get();
@@ -51,6 +58,7 @@ class JavascriptEnvironment {
   v8::Isolate::Scope isolate_scope_;
   v8::Locker locker_;
   v8::HandleScope handle_scope_;
+  std::unique_ptr<JavascriptIdleScheduler> idle_scheduler_;
   std::unique_ptr<gin::ContextHolder> context_holder_;
   brave::AsarSourceMap source_map_;
   std::unique_ptr<extensions::ScriptContext> script_context_;
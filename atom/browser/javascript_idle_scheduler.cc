@@ -0,0 +1,280 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/javascript_idle_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/lazy_instance.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/synchronization/lock.h"
+#include "base/trace_event/trace_event.h"
+#include "gin/public/v8_idle_task_runner.h"
+
+namespace atom {
+
+namespace {
+
+// How long the message loop has to be quiet before an idle period starts.
+const int kQuiescentDelayMs = 100;
+// The longest idle period, matching the one used by Blink.
+const int kMaxIdlePeriodMs = 50;
+// No idle period starts this long after an input event.
+const int kInputQuietPeriodMs = 250;
+// Wait after V8 reported it had no idle work left.
+const int kIdleBackoffMs = 1000;
+
+struct LastInput {
+  base::Lock lock;
+  base::TimeTicks time;
+};
+
+base::LazyInstance<LastInput>::Leaky g_last_input = LAZY_INSTANCE_INITIALIZER;
+
+base::TimeTicks GetLastInputTime() {
+  LastInput& last_input = g_last_input.Get();
+  base::AutoLock auto_lock(last_input.lock);
+  return last_input.time;
+}
+
+bool IsInputRecent(base::TimeTicks now) {
+  base::TimeTicks last_input = GetLastInputTime();
+  return !last_input.is_null() &&
+      now - last_input < base::TimeDelta::FromMilliseconds(kInputQuietPeriodMs);
+}
+
+// V8 and gin measure time in seconds on the base::TimeTicks clock.
+double ToV8Seconds(base::TimeTicks time) {
+  return (time - base::TimeTicks()).InSecondsF();
+}
+
+const char* GCTypeName(v8::GCType type) {
+  return type == v8::kGCTypeScavenge ? "Scavenge" : "MarkSweepCompact";
+}
+
+}  // namespace
+
+// Owned by the isolate's gin::PerIsolateData, which outlives the scheduler.
+class JavascriptIdleScheduler::IdleTaskRunner : public gin::V8IdleTaskRunner {
+ public:
+  explicit IdleTaskRunner(base::WeakPtr<JavascriptIdleScheduler> scheduler)
+      : scheduler_(scheduler) {}
+  ~IdleTaskRunner() override {}
+
+  // gin::V8IdleTaskRunner:
+  void PostIdleTask(v8::IdleTask* task) override {
+    std::unique_ptr<v8::IdleTask> idle_task(task);
+    if (scheduler_)
+      scheduler_->PostIdleTask(std::move(idle_task));
+  }
+
+ private:
+  base::WeakPtr<JavascriptIdleScheduler> scheduler_;
+
+  DISALLOW_COPY_AND_ASSIGN(IdleTaskRunner);
+};
+
+JavascriptIdleScheduler::JavascriptIdleScheduler(v8::Isolate* isolate)
+    : isolate_(isolate),
+      in_idle_timer_(false),
+      full_gc_pending_(false),
+      observing_(false),
+      weak_ptr_factory_(this) {
+  const v8::GCType gc_types = static_cast<v8::GCType>(
+      v8::kGCTypeScavenge | v8::kGCTypeMarkSweepCompact);
+  isolate_->AddGCPrologueCallback(&OnGCPrologue, this, gc_types);
+  isolate_->AddGCEpilogueCallback(&OnGCEpilogue, this, gc_types);
+}
+
+JavascriptIdleScheduler::~JavascriptIdleScheduler() {
+  OnMessageLoopDestroying();
+  isolate_->RemoveGCPrologueCallback(&OnGCPrologue, this);
+  isolate_->RemoveGCEpilogueCallback(&OnGCEpilogue, this);
+}
+
+std::unique_ptr<gin::V8IdleTaskRunner>
+JavascriptIdleScheduler::CreateIdleTaskRunner() {
+  return std::unique_ptr<gin::V8IdleTaskRunner>(
+      new IdleTaskRunner(weak_ptr_factory_.GetWeakPtr()));
+}
+
+void JavascriptIdleScheduler::OnMessageLoopCreated() {
+  if (observing_)
+    return;
+
+  observing_ = true;
+  base::MessageLoop::current()->AddTaskObserver(this);
+  ScheduleIdlePeriod(base::TimeDelta::FromMilliseconds(kQuiescentDelayMs));
+}
+
+void JavascriptIdleScheduler::OnMessageLoopDestroying() {
+  if (!observing_)
+    return;
+
+  observing_ = false;
+  base::MessageLoop::current()->RemoveTaskObserver(this);
+  idle_timer_.Stop();
+}
+
+void JavascriptIdleScheduler::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  if (memory_pressure_level ==
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE)
+    return;
+
+  if (memory_pressure_level ==
+          base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL &&
+      !IsInputRecent(base::TimeTicks::Now())) {
+    full_gc_pending_ = false;
+    isolate_->LowMemoryNotification();
+    return;
+  }
+
+  // Start incremental marking now and finish it in idle time, a blocking
+  // full GC would stall the input being handled.
+  isolate_->MemoryPressureNotification(v8::MemoryPressureLevel::kModerate);
+  if (memory_pressure_level ==
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL)
+    full_gc_pending_ = true;
+  next_idle_period_ = base::TimeTicks();
+  ScheduleIdlePeriod(base::TimeDelta::FromMilliseconds(kQuiescentDelayMs));
+}
+
+// static
+void JavascriptIdleScheduler::DidReceiveInput() {
+  LastInput& last_input = g_last_input.Get();
+  base::AutoLock auto_lock(last_input.lock);
+  last_input.time = base::TimeTicks::Now();
+}
+
+void JavascriptIdleScheduler::WillProcessTask(
+    const base::PendingTask& pending_task) {}
+
+void JavascriptIdleScheduler::DidProcessTask(
+    const base::PendingTask& pending_task) {
+  if (in_idle_timer_) {
+    in_idle_timer_ = false;
+    return;
+  }
+
+  last_task_end_ = base::TimeTicks::Now();
+  ScheduleIdlePeriod(base::TimeDelta::FromMilliseconds(kQuiescentDelayMs));
+}
+
+void JavascriptIdleScheduler::PostIdleTask(std::unique_ptr<v8::IdleTask> task) {
+  idle_tasks_.push_back(std::move(task));
+  ScheduleIdlePeriod(base::TimeDelta::FromMilliseconds(kQuiescentDelayMs));
+}
+
+void JavascriptIdleScheduler::ScheduleIdlePeriod(base::TimeDelta delay) {
+  // The timer checks again for activity when it fires, so it doesn't need
+  // to be pushed back by every task.
+  if (!observing_ || idle_timer_.IsRunning())
+    return;
+
+  idle_timer_.Start(FROM_HERE, delay,
+                    base::Bind(&JavascriptIdleScheduler::OnIdleTimer,
+                               base::Unretained(this)));
+}
+
+void JavascriptIdleScheduler::OnIdleTimer() {
+  in_idle_timer_ = true;
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeTicks start = std::max(
+      last_task_end_ + base::TimeDelta::FromMilliseconds(kQuiescentDelayMs),
+      next_idle_period_);
+  base::TimeTicks last_input = GetLastInputTime();
+  if (!last_input.is_null()) {
+    start = std::max(
+        start,
+        last_input + base::TimeDelta::FromMilliseconds(kInputQuietPeriodMs));
+  }
+  if (now < start) {
+    ScheduleIdlePeriod(start - now);
+    return;
+  }
+
+  if (RunIdlePeriod(now + base::TimeDelta::FromMilliseconds(kMaxIdlePeriodMs)))
+    next_idle_period_ = base::TimeTicks::Now() +
+        base::TimeDelta::FromMilliseconds(kIdleBackoffMs);
+  else
+    ScheduleIdlePeriod(base::TimeDelta());
+}
+
+bool JavascriptIdleScheduler::RunIdlePeriod(base::TimeTicks deadline) {
+  TRACE_EVENT1("v8", "JavascriptIdleScheduler::RunIdlePeriod",
+               "idle_tasks", static_cast<int>(idle_tasks_.size()));
+
+  if (full_gc_pending_) {
+    full_gc_pending_ = false;
+    isolate_->LowMemoryNotification();
+    return false;
+  }
+
+  const double deadline_in_seconds = ToV8Seconds(deadline);
+
+  // Tasks posted while running are left for the next period.
+  size_t count = idle_tasks_.size();
+  while (count-- && base::TimeTicks::Now() < deadline) {
+    std::unique_ptr<v8::IdleTask> task = std::move(idle_tasks_.front());
+    idle_tasks_.pop_front();
+    task->Run(deadline_in_seconds);
+  }
+
+  if (base::TimeTicks::Now() >= deadline)
+    return false;
+
+  return isolate_->IdleNotificationDeadline(deadline_in_seconds) &&
+      idle_tasks_.empty();
+}
+
+// static
+void JavascriptIdleScheduler::OnGCPrologue(v8::Isolate* isolate,
+                                           v8::GCType type,
+                                           v8::GCCallbackFlags flags,
+                                           void* data) {
+  JavascriptIdleScheduler* self = static_cast<JavascriptIdleScheduler*>(data);
+  if (!self->gc_start_.is_null())
+    return;
+
+  self->gc_start_ = base::TimeTicks::Now();
+  TRACE_EVENT_BEGIN1("v8", "JavascriptIdleScheduler::GCPause",
+                     "type", GCTypeName(type));
+}
+
+// static
+void JavascriptIdleScheduler::OnGCEpilogue(v8::Isolate* isolate,
+                                           v8::GCType type,
+                                           v8::GCCallbackFlags flags,
+                                           void* data) {
+  JavascriptIdleScheduler* self = static_cast<JavascriptIdleScheduler*>(data);
+  if (self->gc_start_.is_null())
+    return;
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  int64_t pause_us = (now - self->gc_start_).InMicroseconds();
+  self->gc_start_ = base::TimeTicks();
+  TRACE_EVENT_END1("v8", "JavascriptIdleScheduler::GCPause",
+                   "pause_us", pause_us);
+
+  // Pauses are recorded in microseconds, most scavenges take less than a
+  // millisecond.
+  if (type == v8::kGCTypeScavenge) {
+    UMA_HISTOGRAM_CUSTOM_COUNTS("JavascriptEnvironment.GC.ScavengePauseUs",
+                                pause_us, 1, 1000000, 100);
+  } else {
+    UMA_HISTOGRAM_CUSTOM_COUNTS(
+        "JavascriptEnvironment.GC.MarkSweepCompactPauseUs",
+        pause_us, 1, 10000000, 100);
+    if (IsInputRecent(now)) {
+      UMA_HISTOGRAM_CUSTOM_COUNTS(
+          "JavascriptEnvironment.GC.MarkSweepCompactPauseDuringInputUs",
+          pause_us, 1, 10000000, 100);
+    }
+  }
+}
+
+}  // namespace atom
@@ -0,0 +1,101 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_JAVASCRIPT_IDLE_SCHEDULER_H_
+#define ATOM_BROWSER_JAVASCRIPT_IDLE_SCHEDULER_H_
+
+#include <deque>
+#include <memory>
+
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/weak_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "v8/include/v8.h"
+
+namespace gin {
+class V8IdleTaskRunner;
+}
+
+namespace atom {
+
+// Gives an isolate the idle time of the thread it runs on.
+//
+// Once the message loop has been quiet for a short while, V8's idle tasks
+// run and IdleNotificationDeadline is fed with a bounded idle period, which
+// lets incremental marking and the memory reducer finish major GCs there
+// instead of in the middle of a task. While input has been received
+// recently no idle period is started, and a critical memory pressure
+// notification only starts incremental marking, the blocking full GC waits
+// for the next idle period. GC pauses are traced and recorded in UMA.
+class JavascriptIdleScheduler : public base::MessageLoop::TaskObserver {
+ public:
+  explicit JavascriptIdleScheduler(v8::Isolate* isolate);
+  ~JavascriptIdleScheduler() override;
+
+  // Returns the runner V8 posts its idle tasks to, for
+  // gin::IsolateHolder::EnableIdleTasks.
+  std::unique_ptr<gin::V8IdleTaskRunner> CreateIdleTaskRunner();
+
+  // Starts and stops watching the current thread's message loop.
+  void OnMessageLoopCreated();
+  void OnMessageLoopDestroying();
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
+  // Called on any thread when an input event is received.
+  static void DidReceiveInput();
+
+  // base::MessageLoop::TaskObserver:
+  void WillProcessTask(const base::PendingTask& pending_task) override;
+  void DidProcessTask(const base::PendingTask& pending_task) override;
+
+ private:
+  class IdleTaskRunner;
+
+  void PostIdleTask(std::unique_ptr<v8::IdleTask> task);
+
+  void ScheduleIdlePeriod(base::TimeDelta delay);
+  void OnIdleTimer();
+  // Runs idle work until |deadline|, returns true if V8 has nothing left.
+  bool RunIdlePeriod(base::TimeTicks deadline);
+
+  static void OnGCPrologue(v8::Isolate* isolate,
+                           v8::GCType type,
+                           v8::GCCallbackFlags flags,
+                           void* data);
+  static void OnGCEpilogue(v8::Isolate* isolate,
+                           v8::GCType type,
+                           v8::GCCallbackFlags flags,
+                           void* data);
+
+  v8::Isolate* isolate_;
+
+  std::deque<std::unique_ptr<v8::IdleTask>> idle_tasks_;
+
+  base::OneShotTimer idle_timer_;
+  base::TimeTicks last_task_end_;
+  // No idle period starts before this, set when V8 reported it had nothing
+  // left to do.
+  base::TimeTicks next_idle_period_;
+  // The task running OnIdleTimer does not count as activity.
+  bool in_idle_timer_;
+  // A full GC requested under critical memory pressure, run at the next
+  // idle period.
+  bool full_gc_pending_;
+  bool observing_;
+
+  base::TimeTicks gc_start_;
+
+  base::WeakPtrFactory<JavascriptIdleScheduler> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(JavascriptIdleScheduler);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_JAVASCRIPT_IDLE_SCHEDULER_H_
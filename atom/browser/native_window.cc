@@ -11,6 +11,7 @@
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/browser.h"
+#include "atom/browser/startup_timeline.h"
 #include "atom/browser/unresponsive_suppressor.h"
 #include "atom/browser/web_contents_preferences.h"
 #include "atom/browser/window_list.h"
@@ -586,6 +587,8 @@ void NativeWindow::BeforeUnloadDialogCancelled() {
 }
 
 void NativeWindow::DidFirstVisuallyNonEmptyPaint() {
+  StartupTimeline::DidFirstPaint();
+
   if (IsVisible())
     return;
 
@@ -4,10 +4,17 @@
 
 #include "atom/browser/net/atom_cert_verifier.h"
 
+#include <tuple>
+#include <utility>
+
 #include "atom/browser/browser.h"
 #include "atom/common/native_mate_converters/net_converter.h"
+#include "atom/common/perf_counters.h"
+#include "base/memory/weak_ptr.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/net_errors.h"
+#include "net/cert/cert_status_flags.h"
+#include "net/cert/cert_verify_result.h"
 #include "net/cert/crl_set.h"
 #include "net/cert/x509_certificate.h"
 
@@ -17,17 +24,121 @@ namespace atom {
 
 namespace {
 
-void OnResult(
-    net::CertVerifyResult* verify_result,
-    const net::CompletionCallback& callback,
-    bool result) {
-  BrowserThread::PostTask(
-      BrowserThread::IO, FROM_HERE,
-      base::Bind(callback, result ? net::OK : net::ERR_FAILED));
-}
+// Verdicts of a proc that sees many hosts are dropped rather than evicted one
+// by one.
+const size_t kMaxCachedVerdicts = 1000;
 
 }  // namespace
 
+// Waits for the default verifier and, unless there is a cached verdict, for
+// the verify proc. Owned by the caller of Verify, deleting it cancels both.
+class AtomCertVerifier::VerifyRequest : public net::CertVerifier::Request {
+ public:
+  VerifyRequest(AtomCertVerifier* verifier,
+                const RequestParams& params,
+                net::CertVerifyResult* verify_result,
+                const net::CompletionCallback& callback)
+      : verifier_(verifier),
+        params_(params),
+        verify_result_(verify_result),
+        callback_(callback),
+        default_result_(net::OK),
+        start_(base::TimeTicks::Now()),
+        weak_factory_(this) {}
+  ~VerifyRequest() override {}
+
+  std::unique_ptr<Request>* default_request() { return &default_request_; }
+
+  // Returns ERR_IO_PENDING if the verify proc has to be asked.
+  int OnDefaultVerified(int result) {
+    default_result_ = result;
+
+    VerdictKey key = GetVerdictKey();
+    bool accepted = false;
+    if (verifier_->GetCachedVerdict(key, &accepted)) {
+      PerfCounters::Increment(PerfMetric::CERT_VERDICT_CACHE_HIT);
+      return Finish(ApplyVerdict(accepted));
+    }
+
+    PerfCounters::Increment(PerfMetric::CERT_VERDICT_CACHE_MISS);
+    BrowserThread::PostTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(verifier_->verify_proc_, params_.hostname(),
+                   params_.certificate(),
+                   base::Bind(&VerifyRequest::OnVerdictInUI,
+                              weak_factory_.GetWeakPtr()),
+                   net::ErrorToString(result)));
+    return net::ERR_IO_PENDING;
+  }
+
+  void OnDefaultVerifiedAsync(int result) {
+    result = OnDefaultVerified(result);
+    if (result != net::ERR_IO_PENDING)
+      Complete(result);
+  }
+
+ private:
+  static void OnVerdictInUI(base::WeakPtr<VerifyRequest> request,
+                            bool accepted) {
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&VerifyRequest::OnVerdict, request, accepted));
+  }
+
+  void OnVerdict(bool accepted) {
+    verifier_->CacheVerdict(GetVerdictKey(), accepted);
+    Complete(ApplyVerdict(accepted));
+  }
+
+  VerdictKey GetVerdictKey() const {
+    const net::X509Certificate* cert = params_.certificate().get();
+    return {params_.hostname(),
+            net::X509Certificate::CalculateChainFingerprint256(
+                cert->os_cert_handle(), cert->GetIntermediateCertificates())};
+  }
+
+  // An accepted certificate is valid even if the default verifier rejected
+  // it.
+  int ApplyVerdict(bool accepted) {
+    if (!accepted)
+      return net::ERR_FAILED;
+    if (default_result_ != net::OK) {
+      verify_result_->verified_cert = params_.certificate();
+      verify_result_->cert_status &= ~net::CERT_STATUS_ALL_ERRORS;
+    }
+    return net::OK;
+  }
+
+  int Finish(int result) {
+    PerfCounters::AddTime(PerfMetric::CERT_VERIFY,
+                          base::TimeTicks::Now() - start_);
+    return result;
+  }
+
+  // The callback may delete this.
+  void Complete(int result) {
+    net::CompletionCallback callback = callback_;
+    callback.Run(Finish(result));
+  }
+
+  AtomCertVerifier* verifier_;
+  const RequestParams params_;
+  net::CertVerifyResult* verify_result_;
+  net::CompletionCallback callback_;
+  std::unique_ptr<Request> default_request_;
+  int default_result_;
+  base::TimeTicks start_;
+
+  base::WeakPtrFactory<VerifyRequest> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(VerifyRequest);
+};
+
+bool AtomCertVerifier::VerdictKey::operator<(const VerdictKey& other) const {
+  return std::tie(hostname, fingerprint) <
+         std::tie(other.hostname, other.fingerprint);
+}
+
 AtomCertVerifier::AtomCertVerifier()
     : default_cert_verifier_(net::CertVerifier::CreateDefault()) {
 }
@@ -35,8 +146,12 @@ AtomCertVerifier::AtomCertVerifier()
 AtomCertVerifier::~AtomCertVerifier() {
 }
 
-void AtomCertVerifier::SetVerifyProc(const VerifyProc& proc) {
+void AtomCertVerifier::SetVerifyProc(const VerifyProc& proc,
+                                     base::TimeDelta verdict_ttl) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
   verify_proc_ = proc;
+  verdict_ttl_ = verdict_ttl;
+  verdicts_.clear();
 }
 
 int AtomCertVerifier::Verify(
@@ -52,15 +167,50 @@ int AtomCertVerifier::Verify(
     return default_cert_verifier_->Verify(
         params, crl_set, verify_result, callback, out_req, net_log);
 
-  BrowserThread::PostTask(
-      BrowserThread::UI, FROM_HERE,
-      base::Bind(verify_proc_, params.hostname(), params.certificate(),
-                 base::Bind(OnResult, verify_result, callback)));
-  return net::ERR_IO_PENDING;
+  std::unique_ptr<VerifyRequest> request(
+      new VerifyRequest(this, params, verify_result, callback));
+  int result = default_cert_verifier_->Verify(
+      params, crl_set, verify_result,
+      base::Bind(&VerifyRequest::OnDefaultVerifiedAsync,
+                 base::Unretained(request.get())),
+      request->default_request(), net_log);
+  if (result != net::ERR_IO_PENDING)
+    result = request->OnDefaultVerified(result);
+
+  if (result == net::ERR_IO_PENDING)
+    *out_req = std::move(request);
+  return result;
 }
 
 bool AtomCertVerifier::SupportsOCSPStapling() {
   return true;
 }
 
+bool AtomCertVerifier::GetCachedVerdict(const VerdictKey& key,
+                                        bool* accepted) const {
+  auto it = verdicts_.find(key);
+  if (it == verdicts_.end() || it->second.expiry <= base::TimeTicks::Now())
+    return false;
+  *accepted = it->second.accepted;
+  return true;
+}
+
+void AtomCertVerifier::CacheVerdict(const VerdictKey& key, bool accepted) {
+  if (verdict_ttl_.is_zero())
+    return;
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (verdicts_.size() >= kMaxCachedVerdicts) {
+    for (auto it = verdicts_.begin(); it != verdicts_.end();) {
+      if (it->second.expiry <= now)
+        it = verdicts_.erase(it);
+      else
+        ++it;
+    }
+    if (verdicts_.size() >= kMaxCachedVerdicts)
+      verdicts_.clear();
+  }
+  verdicts_[key] = {accepted, now + verdict_ttl_};
+}
+
 }  // namespace atom
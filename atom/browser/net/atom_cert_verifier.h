@@ -5,13 +5,22 @@
 #ifndef ATOM_BROWSER_NET_ATOM_CERT_VERIFIER_H_
 #define ATOM_BROWSER_NET_ATOM_CERT_VERIFIER_H_
 
+#include <map>
 #include <memory>
 #include <string>
 
+#include "base/time/time.h"
+#include "net/base/hash_value.h"
 #include "net/cert/cert_verifier.h"
 
 namespace atom {
 
+// Runs the default verifier and then the session's verify proc, if there is
+// one, with the default verifier's result. The proc's verdict is final.
+//
+// With a verdict TTL, verdicts are kept per hostname and certificate chain so
+// connections to a host the proc has already seen don't wait for the UI
+// thread. Only accessed on the IO thread.
 class AtomCertVerifier : public net::CertVerifier {
  public:
   AtomCertVerifier();
@@ -20,9 +29,11 @@ class AtomCertVerifier : public net::CertVerifier {
   using VerifyProc =
       base::Callback<void(const std::string& hostname,
                           scoped_refptr<net::X509Certificate>,
-                          const base::Callback<void(bool)>&)>;
+                          const base::Callback<void(bool)>&,
+                          const std::string& verification_result)>;
 
-  void SetVerifyProc(const VerifyProc& proc);
+  // Forgets the cached verdicts of the previous proc.
+  void SetVerifyProc(const VerifyProc& proc, base::TimeDelta verdict_ttl);
 
  protected:
   // net::CertVerifier:
@@ -35,9 +46,30 @@ class AtomCertVerifier : public net::CertVerifier {
   bool SupportsOCSPStapling() override;
 
  private:
+  class VerifyRequest;
+
+  struct VerdictKey {
+    std::string hostname;
+    net::SHA256HashValue fingerprint;
+
+    bool operator<(const VerdictKey& other) const;
+  };
+
+  struct Verdict {
+    bool accepted;
+    base::TimeTicks expiry;
+  };
+
+  // Returns false if there is no unexpired verdict for |key|.
+  bool GetCachedVerdict(const VerdictKey& key, bool* accepted) const;
+  void CacheVerdict(const VerdictKey& key, bool accepted);
+
   VerifyProc verify_proc_;
   std::unique_ptr<net::CertVerifier> default_cert_verifier_;
 
+  base::TimeDelta verdict_ttl_;
+  std::map<VerdictKey, Verdict> verdicts_;
+
   DISALLOW_COPY_AND_ASSIGN(AtomCertVerifier);
 };
 
@@ -9,6 +9,7 @@
 
 #include "atom/browser/extensions/tab_helper.h"
 #include "atom/common/native_mate_converters/net_converter.h"
+#include "atom/common/perf_counters.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "chrome/browser/extensions/api/tabs/tabs_constants.h"
@@ -452,7 +453,8 @@ int AtomNetworkDelegate::HandleResponseEvent(
 
   ResponseCallback response =
       base::Bind(&AtomNetworkDelegate::OnListenerResultInUI<Out>,
-                 weak_factory_.GetWeakPtr(), request->identifier(), out);
+                 weak_factory_.GetWeakPtr(), request->identifier(), out,
+                 base::TimeTicks::Now());
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
       base::Bind(RunResponseListener, info.listener, base::Passed(&details),
@@ -468,6 +470,8 @@ void AtomNetworkDelegate::HandleSimpleEvent(
   if (!MatchesFilterCondition(request, info.url_patterns))
     return;
 
+  PerfCounters::Increment(PerfMetric::WEB_REQUEST_EVENT);
+
   std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
   FillDetailsObject(details.get(), request, args...);
 
@@ -486,7 +490,11 @@ void AtomNetworkDelegate::HandleSimpleEvent(
 
 template<typename T>
 void AtomNetworkDelegate::OnListenerResultInIO(
-    uint64_t id, T out, std::unique_ptr<base::DictionaryValue> response) {
+    uint64_t id, T out, base::TimeTicks start,
+    std::unique_ptr<base::DictionaryValue> response) {
+  PerfCounters::AddTime(PerfMetric::WEB_REQUEST_BLOCKING_EVENT,
+                        base::TimeTicks::Now() - start);
+
   // The request has been destroyed.
   if (!base::ContainsKey(callbacks_, id))
     return;
@@ -501,12 +509,13 @@ void AtomNetworkDelegate::OnListenerResultInIO(
 template<typename T>
 void AtomNetworkDelegate::OnListenerResultInUI(
     uint64_t id,
-    T out, const base::DictionaryValue& response) {
+    T out, base::TimeTicks start, const base::DictionaryValue& response) {
   std::unique_ptr<base::DictionaryValue> copy = response.CreateDeepCopy();
   BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
       base::Bind(&AtomNetworkDelegate::OnListenerResultInIO<T>,
-                 weak_factory_.GetWeakPtr(), id, out, base::Passed(&copy)));
+                 weak_factory_.GetWeakPtr(), id, out, start,
+                 base::Passed(&copy)));
 }
 
 }  // namespace atom
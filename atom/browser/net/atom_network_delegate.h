@@ -13,6 +13,7 @@
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "brightray/browser/network_delegate.h"
 #include "content/public/browser/resource_request_info.h"
@@ -111,11 +112,12 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
   // Deal with the results of Listener.
   template<typename T>
   void OnListenerResultInIO(
-      uint64_t id, T out, std::unique_ptr<base::DictionaryValue> response);
+      uint64_t id, T out, base::TimeTicks start,
+      std::unique_ptr<base::DictionaryValue> response);
   template<typename T>
   void OnListenerResultInUI(
       uint64_t id,
-      T out, const base::DictionaryValue& response);
+      T out, base::TimeTicks start, const base::DictionaryValue& response);
 
   std::map<SimpleEvent, SimpleListenerInfo> simple_listeners_;
   std::map<ResponseEvent, ResponseListenerInfo> response_listeners_;
@@ -32,10 +32,12 @@ using BeforeStartCallback =
 using ResponseCallback =
     base::Callback<void(bool, std::unique_ptr<base::Value> options)>;
 
-// Ask handler for options in UI thread.
+// Ask handler for options in UI thread. When |convert_options| is false the
+// job reads everything it needs in |before_start| and gets a null value.
 void AskForOptions(v8::Isolate* isolate,
                    const JavaScriptHandler& handler,
                    std::unique_ptr<base::DictionaryValue> request_details,
+                   bool convert_options,
                    const BeforeStartCallback& before_start,
                    const ResponseCallback& callback);
 
@@ -64,6 +66,10 @@ class JsAsker : public RequestJob {
   virtual void BeforeStartInUI(v8::Isolate*, v8::Local<v8::Value>) {}
   virtual void StartAsync(std::unique_ptr<base::Value> options) = 0;
 
+  // Whether the handler's response should be converted to a base::Value for
+  // |StartAsync|. Jobs that hold on to live JS objects return false.
+  virtual bool ShouldConvertOptions() const { return true; }
+
   net::URLRequestContextGetter* request_context_getter() const {
     return request_context_getter_;
   }
@@ -80,6 +86,7 @@ class JsAsker : public RequestJob {
                    isolate_,
                    handler_,
                    base::Passed(&request_details),
+                   ShouldConvertOptions(),
                    base::Bind(&JsAsker::BeforeStartInUI,
                               weak_factory_.GetWeakPtr()),
                    base::Bind(&JsAsker::OnResponse,
@@ -0,0 +1,378 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_request_stream_job.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "atom/common/atom_constants.h"
+#include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/value_converter.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "native_mate/dictionary.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_status_code.h"
+
+#include "atom/common/node_includes.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// The stream is paused once this much data is waiting to be read and resumed
+// when it drops below the low water mark.
+const size_t kHighWaterMark = 512 * 1024;
+const size_t kLowWaterMark = 128 * 1024;
+
+}  // namespace
+
+// Subscribes to the data, end and error events of a readable stream on the
+// UI thread and forwards them to the job on the IO thread.
+class URLRequestStreamJob::StreamReader {
+ public:
+  StreamReader(v8::Isolate* isolate,
+               v8::Local<v8::Object> stream,
+               base::WeakPtr<URLRequestStreamJob> job)
+      : isolate_(isolate),
+        stream_(isolate, stream),
+        ended_(false),
+        job_(job),
+        weak_factory_(this) {
+    AddListener("data", base::Bind(&StreamReader::OnData,
+                                   weak_factory_.GetWeakPtr()));
+    AddListener("end", base::Bind(&StreamReader::OnEnd,
+                                  weak_factory_.GetWeakPtr()));
+    AddListener("error", base::Bind(&StreamReader::OnError,
+                                    weak_factory_.GetWeakPtr()));
+  }
+
+  ~StreamReader() {
+    v8::Locker locker(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    for (auto& listener : listeners_) {
+      v8::Local<v8::Value> args[] = {
+        mate::StringToV8(isolate_, listener.first),
+        v8::Local<v8::Value>::New(isolate_, listener.second),
+      };
+      CallMethod("removeListener", arraysize(args), args);
+    }
+
+    // Nobody reads the rest of the response, stop producing it.
+    if (!ended_)
+      CallMethod("destroy", 0, nullptr);
+  }
+
+  void Pause() { CallMethod("pause", 0, nullptr); }
+  void Resume() { CallMethod("resume", 0, nullptr); }
+
+ private:
+  void AddListener(const std::string& event,
+                   const base::Callback<void(mate::Arguments*)>& callback) {
+    v8::Locker locker(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    v8::Local<v8::Value> listener = mate::ConvertToV8(isolate_, callback);
+    listeners_.push_back(
+        std::make_pair(event, v8::Global<v8::Value>(isolate_, listener)));
+
+    v8::Local<v8::Value> args[] = {
+      mate::StringToV8(isolate_, event),
+      listener,
+    };
+    CallMethod("on", arraysize(args), args);
+  }
+
+  // Calls stream[method](...args) if the stream has such a method.
+  void CallMethod(const char* method, int argc, v8::Local<v8::Value>* argv) {
+    v8::Locker locker(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    v8::Local<v8::Object> stream = v8::Local<v8::Object>::New(isolate_,
+                                                              stream_);
+    v8::Context::Scope context_scope(stream->CreationContext());
+
+    v8::Local<v8::Value> function;
+    if (!mate::Dictionary(isolate_, stream).Get(method, &function) ||
+        !function->IsFunction())
+      return;
+
+    v8::MicrotasksScope script_scope(
+        isolate_, v8::MicrotasksScope::kRunMicrotasks);
+    node::MakeCallback(isolate_, stream, method, argc, argv);
+  }
+
+  void OnData(mate::Arguments* args) {
+    v8::Local<v8::Value> value;
+    if (!args->GetNext(&value))
+      return;
+
+    std::unique_ptr<std::string> chunk(new std::string);
+    if (node::Buffer::HasInstance(value)) {
+      chunk->assign(node::Buffer::Data(value), node::Buffer::Length(value));
+    } else if (!mate::ConvertFromV8(isolate_, value, chunk.get())) {
+      return;
+    }
+
+    BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+        base::Bind(&URLRequestStreamJob::OnStreamData, job_,
+                   base::Passed(&chunk)));
+  }
+
+  void OnEnd(mate::Arguments* args) {
+    ended_ = true;
+    BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+        base::Bind(&URLRequestStreamJob::OnStreamEnd, job_));
+  }
+
+  void OnError(mate::Arguments* args) {
+    ended_ = true;
+    BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+        base::Bind(&URLRequestStreamJob::OnStreamError, job_,
+                   static_cast<int>(net::ERR_FAILED)));
+  }
+
+  v8::Isolate* isolate_;
+  v8::Global<v8::Object> stream_;
+  std::vector<std::pair<std::string, v8::Global<v8::Value>>> listeners_;
+  bool ended_;
+
+  // Only dereferenced on the IO thread.
+  base::WeakPtr<URLRequestStreamJob> job_;
+
+  base::WeakPtrFactory<StreamReader> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamReader);
+};
+
+URLRequestStreamJob::URLRequestStreamJob(
+    net::URLRequest* request, net::NetworkDelegate* network_delegate)
+    : JsAsker<net::URLRequestJob>(request, network_delegate),
+      start_error_(net::OK),
+      reader_(nullptr),
+      chunk_offset_(0),
+      buffered_bytes_(0),
+      peak_buffered_bytes_(0),
+      paused_(false),
+      ended_(false),
+      stream_error_(net::OK),
+      pending_buffer_size_(0),
+      start_time_(base::TimeTicks::Now()),
+      received_first_byte_(false),
+      weak_ptr_factory_(this) {
+  weak_ptr_ = weak_ptr_factory_.GetWeakPtr();
+}
+
+URLRequestStreamJob::~URLRequestStreamJob() {
+  if (reader_)
+    BrowserThread::DeleteSoon(BrowserThread::UI, FROM_HERE, reader_);
+
+  if (received_first_byte_) {
+    UMA_HISTOGRAM_MEMORY_KB("Net.StreamProtocol.PeakBufferedKB",
+                            peak_buffered_bytes_ / 1024);
+  }
+}
+
+void URLRequestStreamJob::BeforeStartInUI(
+    v8::Isolate* isolate, v8::Local<v8::Value> value) {
+  if (value->IsNumber()) {
+    mate::ConvertFromV8(isolate, value, &start_error_);
+    return;
+  }
+
+  // Either the stream itself or { statusCode, headers, data }.
+  mate::Dictionary options;
+  if (!mate::ConvertFromV8(isolate, value, &options)) {
+    start_error_ = net::ERR_NOT_IMPLEMENTED;
+    return;
+  }
+
+  int error = net::OK;
+  if (options.Get("error", &error)) {
+    start_error_ = error;
+    return;
+  }
+
+  v8::Local<v8::Object> stream = options.GetHandle();
+  options.Get("data", &stream);
+  v8::Local<v8::Value> on;
+  if (!mate::Dictionary(isolate, stream).Get("on", &on) ||
+      !on->IsFunction()) {
+    start_error_ = net::ERR_NOT_IMPLEMENTED;
+    return;
+  }
+
+  int status_code = net::HTTP_OK;
+  options.Get("statusCode", &status_code);
+  if (status_code < 100 || status_code > 599) {
+    start_error_ = net::ERR_INVALID_RESPONSE;
+    return;
+  }
+
+  std::string status("HTTP/1.1 ");
+  status.append(base::IntToString(status_code));
+  status.append(" ");
+  status.append(net::GetHttpReasonPhrase(
+      static_cast<net::HttpStatusCode>(status_code)));
+  status.append("\0\0", 2);
+  response_headers_ = new net::HttpResponseHeaders(status);
+  response_headers_->AddHeader(kCORSHeader);
+
+  base::DictionaryValue headers;
+  if (options.Get("headers", &headers)) {
+    for (base::DictionaryValue::Iterator it(headers); !it.IsAtEnd();
+         it.Advance()) {
+      std::string header_value;
+      const base::ListValue* values = nullptr;
+      if (it.value().GetAsString(&header_value)) {
+        response_headers_->AddHeader(it.key() + ": " + header_value);
+      } else if (it.value().GetAsList(&values)) {
+        for (const auto& item : *values) {
+          if (item.GetAsString(&header_value))
+            response_headers_->AddHeader(it.key() + ": " + header_value);
+        }
+      }
+    }
+  }
+
+  reader_ = new StreamReader(isolate, stream, weak_ptr_);
+}
+
+bool URLRequestStreamJob::ShouldConvertOptions() const {
+  // The response holds a live stream, everything else is read in
+  // BeforeStartInUI.
+  return false;
+}
+
+void URLRequestStreamJob::StartAsync(std::unique_ptr<base::Value> options) {
+  if (start_error_ != net::OK || !reader_) {
+    NotifyStartError(net::URLRequestStatus(net::URLRequestStatus::FAILED,
+        start_error_ != net::OK ? start_error_ : net::ERR_NOT_IMPLEMENTED));
+    return;
+  }
+
+  NotifyHeadersComplete();
+}
+
+void URLRequestStreamJob::Kill() {
+  weak_ptr_factory_.InvalidateWeakPtrs();
+  JsAsker<URLRequestJob>::Kill();
+}
+
+int URLRequestStreamJob::ReadRawData(net::IOBuffer* dest, int dest_size) {
+  if (buffered_bytes_ > 0)
+    return CopyBufferedData(dest, dest_size);
+
+  if (stream_error_ != net::OK)
+    return stream_error_;
+
+  if (ended_)
+    return 0;
+
+  // Wait for the stream to produce more data.
+  pending_buffer_ = dest;
+  pending_buffer_size_ = dest_size;
+  return net::ERR_IO_PENDING;
+}
+
+bool URLRequestStreamJob::GetMimeType(std::string* mime_type) const {
+  if (!response_headers_)
+    return false;
+
+  return response_headers_->GetMimeType(mime_type);
+}
+
+void URLRequestStreamJob::GetResponseInfo(net::HttpResponseInfo* info) {
+  if (response_headers_)
+    info->headers = response_headers_;
+  else
+    info->headers = new net::HttpResponseHeaders("");
+}
+
+int URLRequestStreamJob::GetResponseCode() const {
+  if (!response_headers_)
+    return -1;
+
+  return response_headers_->response_code();
+}
+
+void URLRequestStreamJob::OnStreamData(std::unique_ptr<std::string> chunk) {
+  if (chunk->empty())
+    return;
+
+  if (!received_first_byte_) {
+    received_first_byte_ = true;
+    UMA_HISTOGRAM_TIMES("Net.StreamProtocol.TimeToFirstByte",
+                        base::TimeTicks::Now() - start_time_);
+  }
+
+  buffered_bytes_ += chunk->size();
+  peak_buffered_bytes_ = std::max(peak_buffered_bytes_, buffered_bytes_);
+  chunks_.push_back(std::move(chunk));
+
+  if (pending_buffer_) {
+    CompletePendingRead(
+        CopyBufferedData(pending_buffer_.get(), pending_buffer_size_));
+  }
+
+  if (!paused_ && buffered_bytes_ >= kHighWaterMark && reader_) {
+    paused_ = true;
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+        base::Bind(&StreamReader::Pause, base::Unretained(reader_)));
+  }
+}
+
+void URLRequestStreamJob::OnStreamEnd() {
+  ended_ = true;
+  UMA_HISTOGRAM_MEDIUM_TIMES("Net.StreamProtocol.TotalTime",
+                             base::TimeTicks::Now() - start_time_);
+
+  if (pending_buffer_)
+    CompletePendingRead(0);
+}
+
+void URLRequestStreamJob::OnStreamError(int error) {
+  stream_error_ = error;
+
+  if (pending_buffer_)
+    CompletePendingRead(error);
+}
+
+int URLRequestStreamJob::CopyBufferedData(net::IOBuffer* dest,
+                                          int dest_size) {
+  size_t copied = 0;
+  while (copied < static_cast<size_t>(dest_size) && !chunks_.empty()) {
+    const std::string& chunk = *chunks_.front();
+    size_t length = std::min(static_cast<size_t>(dest_size) - copied,
+                             chunk.size() - chunk_offset_);
+    memcpy(dest->data() + copied, chunk.data() + chunk_offset_, length);
+    copied += length;
+    chunk_offset_ += length;
+    if (chunk_offset_ == chunk.size()) {
+      chunks_.pop_front();
+      chunk_offset_ = 0;
+    }
+  }
+  buffered_bytes_ -= copied;
+
+  if (paused_ && buffered_bytes_ <= kLowWaterMark && reader_) {
+    paused_ = false;
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+        base::Bind(&StreamReader::Resume, base::Unretained(reader_)));
+  }
+
+  return static_cast<int>(copied);
+}
+
+void URLRequestStreamJob::CompletePendingRead(int result) {
+  pending_buffer_ = nullptr;
+  pending_buffer_size_ = 0;
+  ReadRawDataComplete(result);
+}
+
+}  // namespace atom
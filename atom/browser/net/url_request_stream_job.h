@@ -0,0 +1,83 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+#define ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "atom/browser/net/js_asker.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "net/base/io_buffer.h"
+#include "net/http/http_response_headers.h"
+#include "net/url_request/url_request_job.h"
+
+namespace atom {
+
+// Pipes a Node.js readable stream into the response. Chunks are read on the
+// UI thread as the stream emits them and handed to the network stack as it
+// asks for them, pausing the stream while too much data is waiting.
+class URLRequestStreamJob : public JsAsker<net::URLRequestJob> {
+ public:
+  URLRequestStreamJob(net::URLRequest*, net::NetworkDelegate*);
+  ~URLRequestStreamJob() override;
+
+ protected:
+  // JsAsker:
+  void BeforeStartInUI(v8::Isolate*, v8::Local<v8::Value>) override;
+  void StartAsync(std::unique_ptr<base::Value> options) override;
+  bool ShouldConvertOptions() const override;
+
+  // net::URLRequestJob:
+  void Kill() override;
+  int ReadRawData(net::IOBuffer* buf, int buf_size) override;
+  bool GetMimeType(std::string* mime_type) const override;
+  void GetResponseInfo(net::HttpResponseInfo* info) override;
+  int GetResponseCode() const override;
+
+ private:
+  class StreamReader;
+
+  // Called by |StreamReader|.
+  void OnStreamData(std::unique_ptr<std::string> chunk);
+  void OnStreamEnd();
+  void OnStreamError(int error);
+
+  // Moves buffered data into |dest| and resumes the stream once enough of
+  // it has been consumed.
+  int CopyBufferedData(net::IOBuffer* dest, int dest_size);
+  void CompletePendingRead(int result);
+
+  // Set on the UI thread before |StartAsync|.
+  int start_error_;
+  scoped_refptr<net::HttpResponseHeaders> response_headers_;
+  StreamReader* reader_;  // Lives and is deleted on the UI thread.
+
+  std::deque<std::unique_ptr<std::string>> chunks_;
+  size_t chunk_offset_;
+  size_t buffered_bytes_;
+  size_t peak_buffered_bytes_;
+  bool paused_;
+  bool ended_;
+  int stream_error_;
+
+  // Saved arguments passed to ReadRawData.
+  scoped_refptr<net::IOBuffer> pending_buffer_;
+  int pending_buffer_size_;
+
+  base::TimeTicks start_time_;
+  bool received_first_byte_;
+
+  base::WeakPtrFactory<URLRequestStreamJob> weak_ptr_factory_;
+  base::WeakPtr<URLRequestStreamJob> weak_ptr_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestStreamJob);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
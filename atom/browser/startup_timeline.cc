@@ -0,0 +1,90 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/startup_timeline.h"
+
+#include "atom/common/options_switches.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_log.h"
+#include "components/tracing/common/tracing_switches.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/tracing_controller.h"
+
+namespace atom {
+
+namespace {
+
+// Only ends the timeline if no window ever paints.
+const char kFallbackDurationSeconds[] = "60";
+
+bool g_recording = false;
+
+void OnTimelineWritten(const base::FilePath& path) {
+  LOG(INFO) << "Startup timeline written to " << path.value();
+}
+
+}  // namespace
+
+const char StartupTimeline::kCategories[] =
+    "startup,browser,v8,toplevel,ipc,navigation";
+
+// static
+void StartupTimeline::MaybeStart(base::CommandLine* command_line) {
+  if (!command_line->HasSwitch(switches::kStartupTimeline))
+    return;
+
+  base::FilePath path =
+      command_line->GetSwitchValuePath(switches::kStartupTimeline);
+  if (path.empty()) {
+    LOG(ERROR) << "--" << switches::kStartupTimeline << " needs a file path";
+    return;
+  }
+
+  // Hand the session to content's startup tracing so the tracing controller
+  // owns it and child processes join it, it is stopped early by
+  // DidFirstPaint.
+  command_line->AppendSwitchASCII(::switches::kTraceStartup, kCategories);
+  command_line->AppendSwitchPath(::switches::kTraceStartupFile, path);
+  command_line->AppendSwitchASCII(::switches::kTraceStartupDuration,
+                                  kFallbackDurationSeconds);
+
+  // Content may already have looked for the switches, start recording here
+  // so the phases before the browser main loop are not lost.
+  base::trace_event::TraceLog* trace_log =
+      base::trace_event::TraceLog::GetInstance();
+  if (!trace_log->IsEnabled()) {
+    trace_log->SetEnabled(
+        base::trace_event::TraceConfig(kCategories,
+                                       base::trace_event::RECORD_UNTIL_FULL),
+        base::trace_event::TraceLog::RECORDING_MODE);
+  }
+  g_recording = true;
+}
+
+// static
+void StartupTimeline::DidFirstPaint() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!g_recording)
+    return;
+  g_recording = false;
+
+  TRACE_EVENT_INSTANT0("startup", "StartupTimeline::FirstPaint",
+                       TRACE_EVENT_SCOPE_PROCESS);
+
+  base::FilePath path = base::CommandLine::ForCurrentProcess()->
+      GetSwitchValuePath(switches::kStartupTimeline);
+  bool stopped = content::TracingController::GetInstance()->StopTracing(
+      content::TracingController::CreateFileEndpoint(
+          path, base::Bind(&OnTimelineWritten, path)));
+  if (!stopped) {
+    LOG(WARNING) << "Startup timeline will be written after "
+                 << kFallbackDurationSeconds << "s";
+  }
+}
+
+}  // namespace atom
@@ -0,0 +1,42 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_STARTUP_TIMELINE_H_
+#define ATOM_BROWSER_STARTUP_TIMELINE_H_
+
+#include "base/macros.h"
+
+namespace base {
+class CommandLine;
+}
+
+namespace atom {
+
+// Records a trace of the browser process bootstrap when started with
+// --startup-timeline=<path> and writes it to <path> as JSON once the first
+// window has painted.
+//
+// The bootstrap phases, asar archive reads and the modules required by
+// browser/init.js are traced in the "startup" category.
+class StartupTimeline {
+ public:
+  // The categories recorded for the timeline, also exposed to JS as
+  // contentTracing.startupCategories.
+  static const char kCategories[];
+
+  // Starts recording if the switch is set. Called early in the browser
+  // process, before any thread is created.
+  static void MaybeStart(base::CommandLine* command_line);
+
+  // Called on the UI thread when a window paints, stops recording on the
+  // first call.
+  static void DidFirstPaint();
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(StartupTimeline);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_STARTUP_TIMELINE_H_
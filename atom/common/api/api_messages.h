@@ -4,6 +4,8 @@
 
 // Multiply-included file, no traditional include guard.
 
+#include <string>
+
 #include "base/strings/string16.h"
 #include "base/memory/shared_memory.h"
 #include "base/values.h"
@@ -29,6 +31,23 @@ IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message_Shared,
                     base::string16 /* channel */,
                     base::SharedMemoryHandle /* arguments */)
 
+// Assigns |channel_id| to |channel| for the |event| messages of the sending
+// frame. Sent once before the first AtomViewHostMsg_ChannelMessage that uses
+// the id, see atom/renderer/ipc_channel_registry.h.
+IPC_MESSAGE_ROUTED3(AtomViewHostMsg_RegisterChannel,
+                    uint32_t /* channel_id */,
+                    std::string /* event */,
+                    std::string /* channel */)
+
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_ChannelMessage,
+                    uint32_t /* channel_id */,
+                    base::ListValue /* arguments */)
+
+IPC_SYNC_MESSAGE_ROUTED2_1(AtomViewHostMsg_ChannelMessage_Sync,
+                           uint32_t /* channel_id */,
+                           base::ListValue /* arguments */,
+                           base::string16 /* result (in JSON) */)
+
 IPC_MESSAGE_ROUTED2(AtomViewMsg_Message,
                     base::string16 /* channel */,
                     base::ListValue /* arguments */)
@@ -45,3 +64,10 @@ IPC_MESSAGE_CONTROL1(AtomMsg_UpdateContentSettings, base::DictionaryValue)
 
 // Update renderer content settings
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdateWebKitPrefs, content::WebPreferences)
+
+// Publishes a compiled subresource filter snapshot in a read-only shared
+// memory region. An invalid handle clears the filter.
+IPC_MESSAGE_CONTROL3(AtomMsg_UpdateSubresourceFilter,
+                     base::SharedMemoryHandle /* snapshot */,
+                     uint32_t /* size */,
+                     int /* version */)
@@ -10,16 +10,18 @@
 #include "atom/common/api/atom_api_native_image.h"
 
 #include "atom/common/asar/asar_util.h"
+#include "atom/common/native_mate_converters/buffer_converter.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
-#include "base/base64.h"
 #include "base/files/file_util.h"
+#include "base/macros.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "net/base/data_url.h"
+#include "third_party/modp_b64/modp_b64.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
 #include "ui/base/layout.h"
 #include "ui/gfx/codec/jpeg_codec.h"
@@ -127,6 +129,8 @@ bool PopulateImageSkiaRepsFromPath(gfx::ImageSkia* image,
   return succeed;
 }
 
+// The cached encodings are shared by every call, so each Buffer gets its own
+// copy that scripts can modify.
 base::FilePath NormalizePath(const base::FilePath& path) {
   if (!path.ReferencesParent()) {
     return path;
@@ -184,13 +188,17 @@ void Noop(char*, void*) {
 }  // namespace
 
 NativeImage::NativeImage(v8::Isolate* isolate, const gfx::Image& image)
-    : image_(image) {
+    : image_(image),
+      jpeg_quality_(-1),
+      pixels_shared_(false) {
   Init(isolate);
 }
 
 #if defined(OS_WIN)
 NativeImage::NativeImage(v8::Isolate* isolate, const base::FilePath& hicon_path)
-    : hicon_path_(hicon_path) {
+    : hicon_path_(hicon_path),
+      jpeg_quality_(-1),
+      pixels_shared_(false) {
   // Use the 256x256 icon as fallback icon.
   gfx::ImageSkia image_skia;
   ReadImageSkiaFromICO(&image_skia, GetHICON(256));
@@ -222,11 +230,35 @@ HICON NativeImage::GetHICON(int size) {
 }
 #endif
 
+scoped_refptr<base::RefCountedMemory> NativeImage::GetPNG() {
+  if (pixels_shared_) {
+    // The image keeps the PNG it was created from, which may no longer match
+    // the pixels, so encode them directly.
+    std::vector<unsigned char> output;
+    gfx::PNGCodec::EncodeBGRASkBitmap(*image_.ToSkBitmap(), false, &output);
+    return base::RefCountedBytes::TakeVector(&output);
+  }
+  if (!png_)
+    png_ = image_.As1xPNGBytes();
+  return png_;
+}
+
+scoped_refptr<base::RefCountedMemory> NativeImage::GetJPEG(int quality) {
+  if (pixels_shared_ || !jpeg_ || jpeg_quality_ != quality) {
+    std::vector<unsigned char> output;
+    gfx::JPEG1xEncodedDataFromImage(image_, quality, &output);
+    scoped_refptr<base::RefCountedMemory> jpeg =
+        base::RefCountedBytes::TakeVector(&output);
+    if (pixels_shared_)
+      return jpeg;
+    jpeg_ = jpeg;
+    jpeg_quality_ = quality;
+  }
+  return jpeg_;
+}
+
 v8::Local<v8::Value> NativeImage::ToPNG(v8::Isolate* isolate) {
-  scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
-  return node::Buffer::Copy(isolate,
-                            reinterpret_cast<const char*>(png->front()),
-                            static_cast<size_t>(png->size())).ToLocalChecked();
+  return mate::ConvertToV8(isolate, GetPNG());
 }
 
 v8::Local<v8::Value> NativeImage::ToBitmap(v8::Isolate* isolate) {
@@ -238,24 +270,31 @@ v8::Local<v8::Value> NativeImage::ToBitmap(v8::Isolate* isolate) {
 }
 
 v8::Local<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
-  std::vector<unsigned char> output;
-  gfx::JPEG1xEncodedDataFromImage(image_, quality, &output);
-  return node::Buffer::Copy(
-      isolate,
-      reinterpret_cast<const char*>(&output.front()),
-      static_cast<size_t>(output.size())).ToLocalChecked();
+  return mate::ConvertToV8(isolate, GetJPEG(quality));
 }
 
 std::string NativeImage::ToDataURL() {
-  scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
-  std::string data_url;
-  data_url.insert(data_url.end(), png->front(), png->front() + png->size());
-  base::Base64Encode(data_url, &data_url);
-  data_url.insert(0, "data:image/png;base64,");
+  static const char kPrefix[] = "data:image/png;base64,";
+  const size_t prefix_length = arraysize(kPrefix) - 1;
+
+  // Encode straight into the result instead of copying the PNG bytes into a
+  // string and encoding that in place.
+  scoped_refptr<base::RefCountedMemory> png = GetPNG();
+  std::string data_url(kPrefix);
+  data_url.resize(prefix_length + modp_b64_encode_len(png->size()));
+  size_t length = modp_b64_encode(&data_url[prefix_length],
+                                  reinterpret_cast<const char*>(png->front()),
+                                  png->size());
+  data_url.resize(prefix_length + length);
   return data_url;
 }
 
 v8::Local<v8::Value> NativeImage::GetBitmap(v8::Isolate* isolate) {
+  // The Buffer can be written to, so nothing encoded from the pixels can be
+  // reused any more.
+  pixels_shared_ = true;
+  png_ = nullptr;
+  jpeg_ = nullptr;
   const SkBitmap* bitmap = image_.ToSkBitmap();
   SkPixelRef* ref = bitmap->pixelRef();
   return node::Buffer::New(isolate,
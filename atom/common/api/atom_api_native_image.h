@@ -8,6 +8,7 @@
 #include <map>
 #include <string>
 
+#include "base/memory/ref_counted_memory.h"
 #include "native_mate/handle.h"
 #include "native_mate/wrappable.h"
 #include "ui/gfx/image/image.h"
@@ -68,6 +69,11 @@ class NativeImage : public mate::Wrappable<NativeImage> {
   ~NativeImage() override;
 
  private:
+  // Encoded data is cached until getBitmap hands out the pixels, which scripts
+  // can change afterwards.
+  scoped_refptr<base::RefCountedMemory> GetPNG();
+  scoped_refptr<base::RefCountedMemory> GetJPEG(int quality);
+
   v8::Local<v8::Value> ToPNG(v8::Isolate* isolate);
   v8::Local<v8::Value> ToJPEG(v8::Isolate* isolate, int quality);
   v8::Local<v8::Value> ToBitmap(v8::Isolate* isolate);
@@ -91,6 +97,13 @@ class NativeImage : public mate::Wrappable<NativeImage> {
 
   gfx::Image image_;
 
+  // toPNG and toJPEG return copies of these. Data that isn't cached is handed
+  // to the Buffer without a copy.
+  scoped_refptr<base::RefCountedMemory> png_;
+  scoped_refptr<base::RefCountedMemory> jpeg_;
+  int jpeg_quality_;
+  bool pixels_shared_;
+
   DISALLOW_COPY_AND_ASSIGN(NativeImage);
 };
 
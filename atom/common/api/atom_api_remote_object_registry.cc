@@ -0,0 +1,155 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/common/api/atom_api_remote_object_registry.h"
+
+#include <limits>
+#include <utility>
+
+#include "native_mate/object_template_builder.h"
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+// Ids are positive int32s so they can be used as keys of IDWeakMap in the
+// renderer.
+const int32_t kMaxId = std::numeric_limits<int32_t>::max();
+
+// Same key as v8Util.setHiddenValue(object, 'atomId', id)
+const char kIdKey[] = "atomId";
+
+}  // namespace
+
+RemoteObjectRegistry::Entry::Entry()
+    : count(0) {}
+
+RemoteObjectRegistry::Entry::Entry(Entry&& other)
+    : object(std::move(other.object)),
+      count(other.count) {}
+
+RemoteObjectRegistry::Entry::~Entry() {}
+
+// static
+mate::Handle<RemoteObjectRegistry> RemoteObjectRegistry::Create(
+    v8::Isolate* isolate) {
+  return mate::CreateHandle(isolate, new RemoteObjectRegistry(isolate));
+}
+
+// static
+void RemoteObjectRegistry::BuildPrototype(
+    v8::Isolate* isolate, v8::Local<v8::FunctionTemplate> prototype) {
+  prototype->SetClassName(mate::StringToV8(isolate, "RemoteObjectRegistry"));
+  mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
+      .SetMethod("add", &RemoteObjectRegistry::Add)
+      .SetMethod("get", &RemoteObjectRegistry::Get)
+      .SetMethod("remove", &RemoteObjectRegistry::Remove)
+      .SetMethod("clear", &RemoteObjectRegistry::Clear)
+      .SetMethod("getCount", &RemoteObjectRegistry::GetCount);
+}
+
+RemoteObjectRegistry::RemoteObjectRegistry(v8::Isolate* isolate)
+    : last_id_(0) {
+  id_key_.Reset(isolate,
+      v8::Private::ForApi(isolate, mate::StringToV8(isolate, kIdKey)));
+  Init(isolate);
+}
+
+RemoteObjectRegistry::~RemoteObjectRegistry() {}
+
+int32_t RemoteObjectRegistry::Add(int32_t owner_id,
+                                  v8::Local<v8::Object> object) {
+  v8::Local<v8::Context> context = isolate()->GetCurrentContext();
+  v8::Local<v8::Private> id_key = v8::Local<v8::Private>::New(isolate(),
+                                                              id_key_);
+
+  // Reuse the id stored on the object if it still refers to it
+  int32_t id = 0;
+  v8::Local<v8::Value> stored_id;
+  if (object->GetPrivate(context, id_key).ToLocal(&stored_id) &&
+      stored_id->IsInt32()) {
+    id = stored_id->Int32Value(context).FromJust();
+    Entry* entry = GetEntry(id);
+    if (!entry || entry->object != object)
+      id = 0;
+  }
+
+  if (!id) {
+    if (last_id_ == kMaxId) {
+      isolate()->ThrowException(v8::Exception::Error(
+          mate::StringToV8(isolate(), "Remote object ids exhausted")));
+      return 0;
+    }
+
+    id = ++last_id_;
+    entries_[id].object.Reset(isolate(), object);
+    object->SetPrivate(context, id_key, v8::Integer::New(isolate(), id));
+  }
+
+  if (owners_[owner_id].insert(id).second)
+    GetEntry(id)->count++;
+  return id;
+}
+
+v8::Local<v8::Value> RemoteObjectRegistry::Get(int32_t id) {
+  Entry* entry = GetEntry(id);
+  if (!entry)
+    return v8::Undefined(isolate());
+  return v8::Local<v8::Object>::New(isolate(), entry->object);
+}
+
+void RemoteObjectRegistry::Remove(int32_t owner_id, int32_t id) {
+  // don't let an owner remove itself
+  if (owner_id == id)
+    return;
+
+  auto owner = owners_.find(owner_id);
+  if (owner == owners_.end() || !owner->second.erase(id))
+    return;
+
+  Dereference(id);
+}
+
+void RemoteObjectRegistry::Clear(int32_t owner_id) {
+  auto owner = owners_.find(owner_id);
+  if (owner == owners_.end())
+    return;
+
+  std::unordered_set<int32_t> ids;
+  ids.swap(owner->second);
+  owners_.erase(owner);
+  for (int32_t id : ids)
+    Dereference(id);
+}
+
+uint32_t RemoteObjectRegistry::GetCount() const {
+  return entries_.size();
+}
+
+RemoteObjectRegistry::Entry* RemoteObjectRegistry::GetEntry(int32_t id) {
+  auto it = entries_.find(id);
+  return it == entries_.end() ? nullptr : &it->second;
+}
+
+void RemoteObjectRegistry::Dereference(int32_t id) {
+  Entry* entry = GetEntry(id);
+  if (!entry || --entry->count > 0)
+    return;
+
+  // Overwrite rather than delete the hidden id, deleting would force the
+  // object into dictionary mode.
+  v8::Local<v8::Object> object =
+      v8::Local<v8::Object>::New(isolate(), entry->object);
+  object->SetPrivate(isolate()->GetCurrentContext(),
+                     v8::Local<v8::Private>::New(isolate(), id_key_),
+                     v8::Undefined(isolate()));
+
+  entries_.erase(id);
+}
+
+}  // namespace api
+
+}  // namespace atom
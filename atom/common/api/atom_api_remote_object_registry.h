@@ -0,0 +1,73 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_API_ATOM_API_REMOTE_OBJECT_REGISTRY_H_
+#define ATOM_COMMON_API_ATOM_API_REMOTE_OBJECT_REGISTRY_H_
+
+#include <stdint.h>
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "native_mate/handle.h"
+#include "native_mate/wrappable.h"
+
+namespace atom {
+
+namespace api {
+
+// Keeps the browser objects referenced by remote objects in renderers.
+//
+// Ids are never reused, so a stale id from a renderer never resolves to an
+// object registered after the original one was released. Every web contents
+// owns a set of ids and all of them are released at once when it goes away.
+class RemoteObjectRegistry : public mate::Wrappable<RemoteObjectRegistry> {
+ public:
+  static mate::Handle<RemoteObjectRegistry> Create(v8::Isolate* isolate);
+
+  static void BuildPrototype(v8::Isolate* isolate,
+                             v8::Local<v8::FunctionTemplate> prototype);
+
+ protected:
+  explicit RemoteObjectRegistry(v8::Isolate* isolate);
+  ~RemoteObjectRegistry() override;
+
+ private:
+  struct Entry {
+    Entry();
+    Entry(Entry&& other);
+    ~Entry();
+
+    v8::Global<v8::Object> object;
+    // Number of web contents referencing the object.
+    uint32_t count;
+  };
+
+  // Returns the id of |object| for |owner_id|, adding it if needed. Throws
+  // if every int32 id has been handed out.
+  int32_t Add(int32_t owner_id, v8::Local<v8::Object> object);
+  // Returns the object for |id|, or undefined if it has been released.
+  v8::Local<v8::Value> Get(int32_t id);
+  void Remove(int32_t owner_id, int32_t id);
+  // Releases every object referenced by |owner_id|.
+  void Clear(int32_t owner_id);
+  // Number of live objects.
+  uint32_t GetCount() const;
+
+  Entry* GetEntry(int32_t id);
+  void Dereference(int32_t id);
+
+  std::unordered_map<int32_t, Entry> entries_;
+  int32_t last_id_;
+  std::unordered_map<int32_t, std::unordered_set<int32_t>> owners_;
+  v8::Global<v8::Private> id_key_;
+
+  DISALLOW_COPY_AND_ASSIGN(RemoteObjectRegistry);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_API_ATOM_API_REMOTE_OBJECT_REGISTRY_H_
@@ -6,6 +6,7 @@
 #include <utility>
 
 #include "atom/common/api/atom_api_key_weak_map.h"
+#include "atom/common/api/atom_api_remote_object_registry.h"
 #include "atom/common/api/remote_callback_freer.h"
 #include "atom/common/api/remote_object_freer.h"
 #include "atom/common/native_mate_converters/content_converter.h"
@@ -105,6 +106,8 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("createIDWeakMap", &atom::api::KeyWeakMap<int32_t>::Create);
   dict.SetMethod("createDoubleIDWeakMap",
                  &atom::api::KeyWeakMap<std::pair<int32_t, int32_t>>::Create);
+  dict.SetMethod("createRemoteObjectRegistry",
+                 &atom::api::RemoteObjectRegistry::Create);
 }
 
 }  // namespace
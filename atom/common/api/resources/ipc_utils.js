@@ -6,10 +6,20 @@ var ipcRenderer = atom.v8.getHiddenValue('ipc')
 if (!ipcRenderer) {
   ipcRenderer = new EventEmitter
 
+  // Messages on string channels only carry an id once the channel has been
+  // used, see atom/renderer/ipc_channel_registry.h
+  var sendChannel = function (event, args) {
+    var channel = args[0]
+    if (typeof channel === 'string') {
+      return ipc.sendChannel(event, channel, $Array.slice(args, 1))
+    }
+    return ipc.send(event, $Array.slice(args))
+  }
+
   ipcRenderer.send = function () {
     var args
     args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
-    return ipc.send('ipc-message', $Array.slice(args))
+    return sendChannel('ipc-message', args)
   }
 
   ipcRenderer.sendShared = function (channel, shared) {
@@ -19,13 +29,18 @@ if (!ipcRenderer) {
   ipcRenderer.sendSync = function () {
     var args
     args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
+    var channel = args[0]
+    if (typeof channel === 'string') {
+      return $JSON.parse(ipc.sendChannelSync('ipc-message-sync', channel,
+                                             $Array.slice(args, 1)))
+    }
     return $JSON.parse(ipc.sendSync('ipc-message-sync', $Array.slice(args)))
   }
 
   ipcRenderer.sendToHost = function () {
     var args
     args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
-    return ipc.send('ipc-message-host', $Array.slice(args))
+    return sendChannel('ipc-message-host', args)
   }
 
   ipcRenderer.emit = function () {
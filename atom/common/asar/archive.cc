@@ -9,12 +9,14 @@
 #include <vector>
 
 #include "atom/common/asar/scoped_temporary_file.h"
+#include "atom/common/perf_counters.h"
 #include "base/files/file.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/pickle.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 
 #if defined(OS_WIN)
@@ -143,6 +145,9 @@ Archive::~Archive() {
 }
 
 bool Archive::Init() {
+  TRACE_EVENT1("startup", "asar::Archive::Init",
+               "path", path_.AsUTF8Unsafe());
+
   if (!file_.IsValid()) {
     if (file_.error_details() != base::File::FILE_ERROR_NOT_FOUND) {
       LOG(WARNING) << "Opening " << path_.value()
@@ -196,6 +201,7 @@ bool Archive::Init() {
 }
 
 bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
+  atom::ScopedPerfTimer timer(atom::PerfMetric::ASAR_LOOKUP);
   if (!header_)
     return false;
 
@@ -211,6 +217,7 @@ bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
 }
 
 bool Archive::Stat(const base::FilePath& path, Stats* stats) {
+  atom::ScopedPerfTimer timer(atom::PerfMetric::ASAR_LOOKUP);
   if (!header_)
     return false;
 
@@ -235,6 +242,7 @@ bool Archive::Stat(const base::FilePath& path, Stats* stats) {
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* list) {
+  atom::ScopedPerfTimer timer(atom::PerfMetric::ASAR_LOOKUP);
   if (!header_)
     return false;
 
@@ -255,6 +263,7 @@ bool Archive::Readdir(const base::FilePath& path,
 }
 
 bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
+  atom::ScopedPerfTimer timer(atom::PerfMetric::ASAR_LOOKUP);
   if (!header_)
     return false;
 
@@ -273,6 +282,7 @@ bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
 }
 
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
+  atom::ScopedPerfTimer timer(atom::PerfMetric::ASAR_COPY_FILE_OUT);
   auto it = external_files_.find(path.value());
   if (it != external_files_.end()) {
     *out = it->second->path();
@@ -24,4 +24,6 @@ const char kSecureProtocolDescription[] =
     "The connection to this site is using a strong protocol version "
     "and cipher suite.";
 
+const uint32_t kMaxIPCChannels = 1024;
+
 }  // namespace atom
@@ -5,6 +5,8 @@
 #ifndef ATOM_COMMON_ATOM_CONSTANTS_H_
 #define ATOM_COMMON_ATOM_CONSTANTS_H_
 
+#include <stdint.h>
+
 namespace atom {
 
 // Header to ignore CORS.
@@ -20,6 +22,10 @@ extern const char kValidCertificateDescription[];
 extern const char kSecureProtocol[];
 extern const char kSecureProtocolDescription[];
 
+// Number of ipc channels a frame can register, messages on any other channel
+// carry the channel name.
+extern const uint32_t kMaxIPCChannels;
+
 }  // namespace atom
 
 #endif  // ATOM_COMMON_ATOM_CONSTANTS_H_
@@ -11,8 +11,10 @@
 #include "atom/common/native_mate_converters/content_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/renderer/ipc_channel_registry.h"
 #include "base/memory/shared_memory.h"
 #include "base/memory/shared_memory_handle.h"
+#include "base/strings/utf_string_conversions.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
 #include "content/public/renderer/render_frame.h"
 #include "extensions/renderer/console.h"
@@ -34,6 +36,16 @@ std::vector<v8::Local<v8::Value>> ListValueToVector(v8::Isolate* isolate,
   return result;
 }
 
+// Arguments of a message sent by name when its channel can't be registered.
+base::ListValue PrependChannel(const std::string& channel,
+                               const base::ListValue& arguments) {
+  base::ListValue list;
+  list.AppendString(channel);
+  for (const auto& value : arguments)
+    list.Append(value.CreateDeepCopy());
+  return list;
+}
+
 }  // namespace
 
 JavascriptBindings::JavascriptBindings(content::RenderFrame* render_frame,
@@ -179,6 +191,54 @@ base::string16 JavascriptBindings::IPCSendSync(mate::Arguments* args,
   return json;
 }
 
+void JavascriptBindings::IPCSendChannel(mate::Arguments* args,
+          const std::string& event,
+          const std::string& channel,
+          const base::ListValue& arguments) {
+  if (!is_valid() || !render_frame())
+    return;
+
+  uint32_t channel_id;
+  if (!IPCChannelRegistry::FromFrame(render_frame())->GetChannelId(
+          event, channel, &channel_id)) {
+    IPCSend(args, base::UTF8ToUTF16(event), PrependChannel(channel, arguments));
+    return;
+  }
+
+  bool success = Send(new AtomViewHostMsg_ChannelMessage(
+      routing_id(), channel_id, arguments));
+
+  if (!success)
+    args->ThrowError("Unable to send AtomViewHostMsg_ChannelMessage");
+}
+
+base::string16 JavascriptBindings::IPCSendChannelSync(mate::Arguments* args,
+                        const std::string& event,
+                        const std::string& channel,
+                        const base::ListValue& arguments) {
+  base::string16 json;
+
+  if (!is_valid() || !render_frame()) {
+    return json;
+  }
+
+  uint32_t channel_id;
+  if (!IPCChannelRegistry::FromFrame(render_frame())->GetChannelId(
+          event, channel, &channel_id)) {
+    return IPCSendSync(args, base::UTF8ToUTF16(event),
+                       PrependChannel(channel, arguments));
+  }
+
+  IPC::SyncMessage* message = new AtomViewHostMsg_ChannelMessage_Sync(
+      routing_id(), channel_id, arguments, &json);
+  bool success = Send(message);
+
+  if (!success)
+    args->ThrowError("Unable to send AtomViewHostMsg_ChannelMessage_Sync");
+
+  return json;
+}
+
 void JavascriptBindings::GetBinding(
       const v8::FunctionCallbackInfo<v8::Value>& args) {
   blink::WebLocalFrame* frame = context()->web_frame();
@@ -192,6 +252,11 @@ void JavascriptBindings::GetBinding(
       base::Unretained(this)));
   ipc.SetMethod("sendSync", base::Bind(&JavascriptBindings::IPCSendSync,
       base::Unretained(this)));
+  ipc.SetMethod("sendChannel", base::Bind(&JavascriptBindings::IPCSendChannel,
+      base::Unretained(this)));
+  ipc.SetMethod("sendChannelSync",
+      base::Bind(&JavascriptBindings::IPCSendChannelSync,
+      base::Unretained(this)));
   ipc.SetMethod("sendShared", base::Bind(&JavascriptBindings::IPCSendShared,
       base::Unretained(this)));
   binding.Set("ipc", ipc.GetHandle());
@@ -5,6 +5,8 @@
 #ifndef ATOM_COMMON_JAVASCRIPT_BINDINGS_H_
 #define ATOM_COMMON_JAVASCRIPT_BINDINGS_H_
 
+#include <string>
+
 #include "content/public/renderer/render_frame_observer.h"
 #include "extensions/renderer/object_backed_native_handler.h"
 #include "extensions/renderer/script_context.h"
@@ -40,6 +42,16 @@ class JavascriptBindings : public content::RenderFrameObserver,
   void IPCSend(mate::Arguments* args,
                         const base::string16& channel,
                         const base::ListValue& arguments);
+  // Same as IPCSend and IPCSendSync with |channel| prepended to |arguments|,
+  // sent as an id registered in the frame's IPCChannelRegistry.
+  void IPCSendChannel(mate::Arguments* args,
+                      const std::string& event,
+                      const std::string& channel,
+                      const base::ListValue& arguments);
+  base::string16 IPCSendChannelSync(mate::Arguments* args,
+                                    const std::string& event,
+                                    const std::string& channel,
+                                    const base::ListValue& arguments);
   v8::Local<v8::Value> GetHiddenValue(v8::Isolate* isolate,
                                     v8::Local<v8::String> key);
   void SetHiddenValue(v8::Isolate* isolate,
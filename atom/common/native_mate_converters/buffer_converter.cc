@@ -0,0 +1,43 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/common/native_mate_converters/buffer_converter.h"
+
+#include "atom/common/node_includes.h"
+
+namespace mate {
+
+namespace {
+
+void ReleaseMemory(char*, void* hint) {
+  static_cast<base::RefCountedMemory*>(hint)->Release();
+}
+
+}  // namespace
+
+// static
+v8::Local<v8::Value> Converter<scoped_refptr<base::RefCountedMemory>>::ToV8(
+    v8::Isolate* isolate,
+    const scoped_refptr<base::RefCountedMemory>& val) {
+  if (!val || val->size() == 0)
+    return node::Buffer::New(isolate, 0).ToLocalChecked();
+
+  // Memory someone else holds on to may be read again after the Buffer is
+  // modified.
+  if (!val->HasOneRef()) {
+    return node::Buffer::Copy(isolate,
+                              reinterpret_cast<const char*>(val->front()),
+                              val->size()).ToLocalChecked();
+  }
+
+  val->AddRef();
+  return node::Buffer::New(isolate,
+                           reinterpret_cast<char*>(
+                               const_cast<unsigned char*>(val->front())),
+                           val->size(),
+                           &ReleaseMemory,
+                           val.get()).ToLocalChecked();
+}
+
+}  // namespace mate
@@ -0,0 +1,27 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_NATIVE_MATE_CONVERTERS_BUFFER_CONVERTER_H_
+#define ATOM_COMMON_NATIVE_MATE_CONVERTERS_BUFFER_CONVERTER_H_
+
+#include "base/memory/ref_counted_memory.h"
+#include "native_mate/converter.h"
+
+namespace mate {
+
+// Wraps the memory in a Buffer without copying it if |val| holds the only
+// reference, so callers that are done with the memory should pass it on with
+// std::move. It is copied otherwise. The Buffer keeps a reference to wrapped
+// memory until it is garbage collected, so it must be writable. A null
+// pointer becomes an empty Buffer.
+template<>
+struct Converter<scoped_refptr<base::RefCountedMemory>> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate,
+      const scoped_refptr<base::RefCountedMemory>& val);
+};
+
+}  // namespace mate
+
+#endif  // ATOM_COMMON_NATIVE_MATE_CONVERTERS_BUFFER_CONVERTER_H_
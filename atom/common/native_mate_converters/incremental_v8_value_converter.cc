@@ -0,0 +1,225 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/common/native_mate_converters/incremental_v8_value_converter.h"
+
+#include <utility>
+
+#include "atom/common/perf_counters.h"
+#include "base/bind.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
+#include "base/values.h"
+#include "native_mate/dictionary.h"
+
+namespace atom {
+
+namespace {
+
+// Long enough to make progress, short enough not to delay input.
+const int kSliceTimeMs = 5;
+
+// Reading the clock after every step would cost more than most steps.
+const int kStepsPerClockCheck = 64;
+
+}  // namespace
+
+IncrementalV8ValueConverter::Container::Container()
+    : value(nullptr), next(0) {}
+
+IncrementalV8ValueConverter::Container::Container(Container&& other)
+    : owned(std::move(other.owned)),
+      value(other.value),
+      target(std::move(other.target)),
+      keys(std::move(other.keys)),
+      next(other.next) {}
+
+IncrementalV8ValueConverter::Container::~Container() {}
+
+// static
+void IncrementalV8ValueConverter::Convert(std::unique_ptr<base::Value> value,
+                                          v8::Local<v8::Context> context,
+                                          const Callback& callback) {
+  std::unique_ptr<IncrementalV8ValueConverter> converter(
+      new IncrementalV8ValueConverter(context, callback));
+  const base::Value* unowned = value.get();
+  converter->Restart(context, unowned, std::move(value));
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, base::Bind(&IncrementalV8ValueConverter::ConvertSlice,
+                            base::Passed(&converter)));
+}
+
+// static
+void IncrementalV8ValueConverter::Convert(const GetValueCallback& get_value,
+                                          v8::Local<v8::Context> context,
+                                          const Callback& callback) {
+  std::unique_ptr<IncrementalV8ValueConverter> converter(
+      new IncrementalV8ValueConverter(context, callback));
+  const base::Value* value = get_value.Run(&converter->version_);
+  if (!value)
+    return;
+  converter->get_value_ = get_value;
+  converter->Restart(context, value, nullptr);
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, base::Bind(&IncrementalV8ValueConverter::ConvertSlice,
+                            base::Passed(&converter)));
+}
+
+IncrementalV8ValueConverter::IncrementalV8ValueConverter(
+    v8::Local<v8::Context> context,
+    const Callback& callback)
+    : isolate_(context->GetIsolate()),
+      context_(isolate_, context),
+      callback_(callback),
+      version_(0) {}
+
+IncrementalV8ValueConverter::~IncrementalV8ValueConverter() {}
+
+// static
+void IncrementalV8ValueConverter::ConvertSlice(
+    std::unique_ptr<IncrementalV8ValueConverter> converter) {
+  TRACE_EVENT0("browser", "IncrementalV8ValueConverter::ConvertSlice");
+  v8::Isolate* isolate = converter->isolate_;
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> context =
+      v8::Local<v8::Context>::New(isolate, converter->context_);
+  v8::Context::Scope context_scope(context);
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  if (!converter->CheckVersion(context))
+    return;
+
+  base::TimeTicks deadline =
+      start + base::TimeDelta::FromMilliseconds(kSliceTimeMs);
+  bool done = false;
+  for (int steps = 1; !done; ++steps) {
+    done = !converter->Step(context);
+    if (steps % kStepsPerClockCheck == 0 && base::TimeTicks::Now() >= deadline)
+      break;
+  }
+  PerfCounters::AddTime(PerfMetric::VALUE_CONVERT_SLICE,
+                        base::TimeTicks::Now() - start);
+
+  if (!done) {
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::Bind(&IncrementalV8ValueConverter::ConvertSlice,
+                              base::Passed(&converter)));
+    return;
+  }
+
+  converter->callback_.Run(
+      v8::Local<v8::Value>::New(isolate, converter->result_));
+}
+
+bool IncrementalV8ValueConverter::CheckVersion(
+    v8::Local<v8::Context> context) {
+  if (get_value_.is_null())
+    return true;
+
+  int version = 0;
+  const base::Value* value = get_value_.Run(&version);
+  if (!value)
+    return false;
+  if (version != version_) {
+    // The pointers into the old value are no longer valid. Copying the new
+    // one makes sure the conversion finishes even if it keeps changing.
+    get_value_.Reset();
+    Restart(context, value, value->CreateDeepCopy());
+  }
+  return true;
+}
+
+void IncrementalV8ValueConverter::Restart(v8::Local<v8::Context> context,
+                                          const base::Value* value,
+                                          std::unique_ptr<base::Value> owned) {
+  v8::HandleScope handle_scope(isolate_);
+  v8::Context::Scope context_scope(context);
+  stack_.clear();
+  if (owned)
+    value = owned.get();
+  result_.Reset(isolate_, Start(context, value, std::move(owned)));
+}
+
+v8::Local<v8::Value> IncrementalV8ValueConverter::Start(
+    v8::Local<v8::Context> context,
+    const base::Value* value,
+    std::unique_ptr<base::Value> owned) {
+  v8::Local<v8::Object> target;
+  Container container;
+  if (value->IsType(base::Value::Type::LIST)) {
+    target = v8::Array::New(isolate_);
+  } else if (value->IsType(base::Value::Type::DICTIONARY)) {
+    // Like V8ValueConverter::ToV8Object.
+    mate::Dictionary dictionary = mate::Dictionary::CreateEmpty(isolate_);
+    dictionary.SetHidden("simple", true);
+    target = dictionary.GetHandle();
+    const base::DictionaryValue* dict =
+        static_cast<const base::DictionaryValue*>(value);
+    container.keys.reserve(dict->size());
+    for (base::DictionaryValue::Iterator it(*dict); !it.IsAtEnd();
+         it.Advance())
+      container.keys.push_back(it.key());
+  } else {
+    return converter_.ToV8Value(value, context);
+  }
+
+  container.owned = std::move(owned);
+  container.value = value;
+  container.target.Reset(isolate_, target);
+  stack_.push_back(std::move(container));
+  return target;
+}
+
+bool IncrementalV8ValueConverter::Step(v8::Local<v8::Context> context) {
+  while (!stack_.empty()) {
+    Container& container = stack_.back();
+    const base::Value* child = nullptr;
+    // Lists are indexed and dictionaries named.
+    v8::Local<v8::String> name;
+    if (container.value->IsType(base::Value::Type::LIST)) {
+      auto list = static_cast<const base::ListValue*>(container.value);
+      if (container.next < list->GetSize())
+        list->Get(container.next, &child);
+    } else if (container.next < container.keys.size()) {
+      const std::string& key = container.keys[container.next];
+      name = mate::StringToV8(isolate_, key);
+      static_cast<const base::DictionaryValue*>(container.value)
+          ->GetWithoutPathExpansion(key, &child);
+    }
+
+    if (!child) {
+      // Frees the container's value if it is owned.
+      stack_.pop_back();
+      continue;
+    }
+
+    uint32_t index = static_cast<uint32_t>(container.next++);
+    v8::Local<v8::Object> target =
+        v8::Local<v8::Object>::New(isolate_, container.target);
+    std::unique_ptr<base::Value> owned_child;
+    if (container.owned) {
+      // Moves the child's contents out so they are freed once converted.
+      owned_child.reset(
+          new base::Value(std::move(*const_cast<base::Value*>(child))));
+      child = owned_child.get();
+    }
+    v8::Local<v8::Value> child_v8 =
+        Start(context, child, std::move(owned_child));
+
+    // Unlike Set, doesn't run setters on the prototype, so no script can
+    // change a value that is read in place during a slice.
+    v8::TryCatch try_catch(isolate_);
+    if (name.IsEmpty())
+      target->CreateDataProperty(context, index, child_v8).FromMaybe(false);
+    else
+      target->CreateDataProperty(context, name, child_v8).FromMaybe(false);
+    if (try_catch.HasCaught())
+      LOG(ERROR) << "Adding a converted value threw an exception.";
+    return true;
+  }
+  return false;
+}
+
+}  // namespace atom
@@ -0,0 +1,107 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_NATIVE_MATE_CONVERTERS_INCREMENTAL_V8_VALUE_CONVERTER_H_
+#define ATOM_COMMON_NATIVE_MATE_CONVERTERS_INCREMENTAL_V8_VALUE_CONVERTER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "atom/common/native_mate_converters/v8_value_converter.h"
+#include "base/callback.h"
+#include "base/macros.h"
+#include "v8/include/v8.h"
+
+namespace base {
+class Value;
+}
+
+namespace atom {
+
+// Converts a base::Value to V8 like V8ValueConverter, a few milliseconds at a
+// time with a task posted in between, so converting a large value doesn't
+// stall the thread.
+//
+// An owned value is freed a list or dictionary at a time once its contents
+// have been converted, so the value and the V8 copy don't both have to be
+// complete at the same time. A value owned by someone else is read in place
+// as long as its version doesn't change.
+class IncrementalV8ValueConverter {
+ public:
+  using Callback = base::Callback<void(v8::Local<v8::Value>)>;
+  // Returns the value and sets |version| to a number that changes whenever
+  // the value does, or returns nullptr if the value is gone.
+  using GetValueCallback = base::Callback<const base::Value*(int* version)>;
+
+  // Runs |callback| in |context| with the converted value.
+  static void Convert(std::unique_ptr<base::Value> value,
+                      v8::Local<v8::Context> context,
+                      const Callback& callback);
+
+  // Like Convert, but without copying the value. |get_value| is run before
+  // every slice. If the version changed, the conversion starts over from a
+  // copy of the new value, and if the value is gone |callback| is not run.
+  static void Convert(const GetValueCallback& get_value,
+                      v8::Local<v8::Context> context,
+                      const Callback& callback);
+
+ private:
+  // A list or dictionary being converted.
+  struct Container {
+    Container();
+    Container(Container&& other);
+    ~Container();
+
+    // Set if the converter owns |value|.
+    std::unique_ptr<base::Value> owned;
+    const base::Value* value;
+    v8::Global<v8::Object> target;
+    // The keys of a dictionary, taken before its values are moved out.
+    std::vector<std::string> keys;
+    size_t next;
+  };
+
+  IncrementalV8ValueConverter(v8::Local<v8::Context> context,
+                              const Callback& callback);
+  ~IncrementalV8ValueConverter();
+
+  static void ConvertSlice(
+      std::unique_ptr<IncrementalV8ValueConverter> converter);
+
+  // Returns false if the value is gone. Restarts the conversion if it
+  // changed.
+  bool CheckVersion(v8::Local<v8::Context> context);
+
+  // Starts converting |value|, or the owned copy of it in |owned|.
+  void Restart(v8::Local<v8::Context> context,
+               const base::Value* value,
+               std::unique_ptr<base::Value> owned);
+
+  // Returns the V8 value of |value|. Lists and dictionaries start out empty
+  // and are filled by later steps.
+  v8::Local<v8::Value> Start(v8::Local<v8::Context> context,
+                             const base::Value* value,
+                             std::unique_ptr<base::Value> owned);
+
+  // Converts the next child of the innermost container. Returns false when
+  // the whole value has been converted.
+  bool Step(v8::Local<v8::Context> context);
+
+  v8::Isolate* isolate_;
+  v8::Global<v8::Context> context_;
+  Callback callback_;
+  GetValueCallback get_value_;
+  int version_;
+
+  V8ValueConverter converter_;
+  v8::Global<v8::Value> result_;
+  std::vector<Container> stack_;
+
+  DISALLOW_COPY_AND_ASSIGN(IncrementalV8ValueConverter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_NATIVE_MATE_CONVERTERS_INCREMENTAL_V8_VALUE_CONVERTER_H_
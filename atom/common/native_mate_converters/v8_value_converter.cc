@@ -4,10 +4,11 @@
 
 #include "atom/common/native_mate_converters/v8_value_converter.h"
 
-#include <map>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
@@ -22,6 +23,19 @@ namespace {
 
 const int kMaxRecursionDepth = 100;
 
+// Writes the UTF-8 straight into the result instead of copying it out of a
+// v8::String::Utf8Value.
+std::string V8StringToUTF8(v8::Local<v8::String> str) {
+  int length = str->Utf8Length();
+  std::string result(length, '\0');
+  if (length > 0) {
+    str->WriteUtf8(&result[0], length, nullptr,
+                   v8::String::NO_NULL_TERMINATION |
+                       v8::String::REPLACE_INVALID_UTF8);
+  }
+  return result;
+}
+
 }  // namespace
 
 // The state of a call to FromV8Value.
@@ -43,30 +57,24 @@ class V8ValueConverter::FromV8ValueState {
 
   FromV8ValueState() : max_recursion_depth_(kMaxRecursionDepth) {}
 
-  // If |handle| is not in |unique_map_|, then add it to |unique_map_| and
-  // return true.
+  // If |handle| is not an object being converted, adds it to them and returns
+  // true. Otherwise returns false.
   //
-  // Otherwise do nothing and return false. Here "A is unique" means that no
-  // other handle B in the map points to the same object as A. Note that A can
-  // be unique even if there already is another handle with the same identity
-  // hash (key) in the map, because two objects can have the same hash.
+  // Only the objects on the current path are kept, so there are at most
+  // kMaxRecursionDepth of them. Comparing handles, which compares the
+  // underlying objects, is cheaper than hashing for that few and, unlike
+  // GetIdentityHash, doesn't have to store a hash in every object converted.
   bool AddToUniquenessCheck(v8::Local<v8::Object> handle) {
-    int hash;
-    auto iter = GetIteratorInMap(handle, &hash);
-    if (iter != unique_map_.end())
+    if (std::find(path_.begin(), path_.end(), handle) != path_.end())
       return false;
-
-    unique_map_.insert(std::make_pair(hash, handle));
+    path_.push_back(handle);
     return true;
   }
 
-  bool RemoveFromUniquenessCheck(v8::Local<v8::Object> handle) {
-    int unused_hash;
-    auto iter = GetIteratorInMap(handle, &unused_hash);
-    if (iter == unique_map_.end())
-      return false;
-    unique_map_.erase(iter);
-    return true;
+  // Objects are removed in the reverse order they were added in.
+  void RemoveFromUniquenessCheck(v8::Local<v8::Object> handle) {
+    DCHECK(!path_.empty() && path_.back() == handle);
+    path_.pop_back();
   }
 
   bool HasReachedMaxRecursionDepth() {
@@ -74,25 +82,7 @@ class V8ValueConverter::FromV8ValueState {
   }
 
  private:
-  using HashToHandleMap = std::multimap<int, v8::Local<v8::Object>>;
-  using Iterator = HashToHandleMap::const_iterator;
-
-  Iterator GetIteratorInMap(v8::Local<v8::Object> handle, int* hash) {
-    *hash = handle->GetIdentityHash();
-    // We only compare using == with handles to objects with the same identity
-    // hash. Different hash obviously means different objects, but two objects
-    // in a couple of thousands could have the same identity hash.
-    std::pair<Iterator, Iterator> range = unique_map_.equal_range(*hash);
-    for (auto it = range.first; it != range.second; ++it) {
-      // Operator == for handles actually compares the underlying objects.
-      if (it->second == handle)
-        return it;
-    }
-    // Not found.
-    return unique_map_.end();
-  }
-
-  HashToHandleMap unique_map_;
+  std::vector<v8::Local<v8::Object>> path_;
 
   int max_recursion_depth_;
 };
@@ -110,16 +100,13 @@ class V8ValueConverter::ScopedUniquenessGuard {
         value_(value),
         is_valid_(state_->AddToUniquenessCheck(value_)) {}
   ~ScopedUniquenessGuard() {
-    if (is_valid_) {
-      bool removed = state_->RemoveFromUniquenessCheck(value_);
-      DCHECK(removed);
-    }
+    if (is_valid_)
+      state_->RemoveFromUniquenessCheck(value_);
   }
 
   bool is_valid() const { return is_valid_; }
 
  private:
-  typedef std::multimap<int, v8::Local<v8::Object> > HashToHandleMap;
   V8ValueConverter::FromV8ValueState* state_;
   v8::Local<v8::Object> value_;
   bool is_valid_;
@@ -270,18 +257,16 @@ base::Value* V8ValueConverter::FromV8ValueImpl(
     return new base::Value();
 
   if (val->IsBoolean())
-    return new base::Value(val->ToBoolean()->Value());
+    return new base::Value(val.As<v8::Boolean>()->Value());
 
   if (val->IsInt32())
-    return new base::Value(val->ToInt32()->Value());
+    return new base::Value(val.As<v8::Int32>()->Value());
 
   if (val->IsNumber())
-    return new base::Value(val->ToNumber()->Value());
+    return new base::Value(val.As<v8::Number>()->Value());
 
-  if (val->IsString()) {
-    v8::String::Utf8Value utf8(val->ToString());
-    return new base::Value(std::string(*utf8, utf8.length()));
-  }
+  if (val->IsString())
+    return new base::Value(V8StringToUTF8(val.As<v8::String>()));
 
   if (val->IsUndefined())
     // JSON.stringify ignores undefined.
@@ -342,25 +327,34 @@ base::Value* V8ValueConverter::FromV8Array(
   std::unique_ptr<v8::Context::Scope> scope;
   // If val was created in a different context than our current one, change to
   // that context, but change back after val is converted.
-  if (!val->CreationContext().IsEmpty() &&
-      val->CreationContext() != isolate->GetCurrentContext())
-    scope.reset(new v8::Context::Scope(val->CreationContext()));
+  v8::Local<v8::Context> creation_context = val->CreationContext();
+  if (!creation_context.IsEmpty() &&
+      creation_context != isolate->GetCurrentContext())
+    scope.reset(new v8::Context::Scope(creation_context));
 
   auto* result = new base::ListValue();
+  uint32_t length = val->Length();
+  result->Reserve(length);
 
   // Only fields with integer keys are carried over to the ListValue.
-  for (uint32_t i = 0; i < val->Length(); ++i) {
-    v8::TryCatch try_catch;
+  v8::TryCatch try_catch(isolate);
+  for (uint32_t i = 0; i < length; ++i) {
     v8::Local<v8::Value> child_v8 = val->Get(i);
     if (try_catch.HasCaught()) {
       LOG(ERROR) << "Getter for index " << i << " threw an exception.";
+      try_catch.Reset();
       child_v8 = v8::Null(isolate);
     }
 
-    if (!val->HasRealIndexedProperty(i))
+    // Only undefined can be a hole, so packed arrays are read once per
+    // element.
+    if (child_v8->IsUndefined() && !val->HasRealIndexedProperty(i))
       continue;
 
     base::Value* child = FromV8ValueImpl(state, child_v8, isolate);
+    // Exceptions converting the child don't belong to the next getter.
+    if (try_catch.HasCaught())
+      try_catch.Reset();
     if (child)
       result->Append(std::unique_ptr<base::Value>(child));
     else
@@ -390,14 +384,17 @@ base::Value* V8ValueConverter::FromV8Object(
   std::unique_ptr<v8::Context::Scope> scope;
   // If val was created in a different context than our current one, change to
   // that context, but change back after val is converted.
-  if (!val->CreationContext().IsEmpty() &&
-      val->CreationContext() != isolate->GetCurrentContext())
-    scope.reset(new v8::Context::Scope(val->CreationContext()));
+  v8::Local<v8::Context> creation_context = val->CreationContext();
+  if (!creation_context.IsEmpty() &&
+      creation_context != isolate->GetCurrentContext())
+    scope.reset(new v8::Context::Scope(creation_context));
 
   std::unique_ptr<base::DictionaryValue> result(new base::DictionaryValue());
   v8::Local<v8::Array> property_names(val->GetOwnPropertyNames());
+  uint32_t length = property_names->Length();
 
-  for (uint32_t i = 0; i < property_names->Length(); ++i) {
+  v8::TryCatch try_catch(isolate);
+  for (uint32_t i = 0; i < length; ++i) {
     v8::Local<v8::Value> key(property_names->Get(i));
 
     // Extend this test to cover more types as necessary and if sensible.
@@ -408,19 +405,23 @@ base::Value* V8ValueConverter::FromV8Object(
       continue;
     }
 
-    v8::String::Utf8Value name_utf8(key->ToString());
+    // Plain objects only have string keys, index keys are numbers.
+    std::string name = V8StringToUTF8(
+        key->IsString() ? key.As<v8::String>() : key->ToString());
 
-    v8::TryCatch try_catch;
     v8::Local<v8::Value> child_v8 = val->Get(key);
 
     if (try_catch.HasCaught()) {
-      LOG(ERROR) << "Getter for property " << *name_utf8
+      LOG(ERROR) << "Getter for property " << name
                  << " threw an exception.";
+      try_catch.Reset();
       child_v8 = v8::Null(isolate);
     }
 
     std::unique_ptr<base::Value> child(
         FromV8ValueImpl(state, child_v8, isolate));
+    if (try_catch.HasCaught())
+      try_catch.Reset();
     if (!child.get())
       // JSON.stringify skips properties whose values don't serialize, for
       // example undefined and functions. Emulate that behavior.
@@ -449,8 +450,7 @@ base::Value* V8ValueConverter::FromV8Object(
     if (strip_null_from_objects_ && child->IsType(base::Value::Type::NONE))
       continue;
 
-    result->SetWithoutPathExpansion(std::string(*name_utf8, name_utf8.length()),
-                                    std::move(child));
+    result->SetWithoutPathExpansion(name, std::move(child));
   }
 
   return result.release();
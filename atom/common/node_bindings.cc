@@ -12,6 +12,7 @@
 #include "atom/common/api/locker.h"
 #include "atom/common/atom_command_line.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/perf_counters.h"
 #include "base/base_paths.h"
 #include "base/command_line.h"
 #include "base/environment.h"
@@ -128,6 +129,7 @@ NodeBindings::NodeBindings()
     : message_loop_(nullptr),
       uv_loop_(uv_default_loop()),
       embed_closed_(false),
+      embed_thread_started_(false),
       uv_env_(nullptr),
       weak_factory_(this) {
 }
@@ -136,7 +138,7 @@ NodeBindings::~NodeBindings() {
   // Quit the embed thread.
   embed_closed_ = true;
   // node never started
-  if (!uv_env_)
+  if (!embed_thread_started_)
     return;
   uv_sem_post(&embed_sem_);
   WakeupEmbedThread();
@@ -227,9 +229,13 @@ void NodeBindings::PrepareMessageLoop() {
   // nothing to do.
   uv_async_init(uv_loop_, &dummy_uv_handle_, nullptr);
 
+  if (!UsesEmbedThread())
+    return;
+
   // Start worker that will interrupt main loop when having uv events.
   uv_sem_init(&embed_sem_, 0);
   uv_thread_create(&embed_thread_, EmbedThreadRunner, this);
+  embed_thread_started_ = true;
 }
 
 void NodeBindings::RunMessageLoop() {
@@ -264,15 +270,26 @@ void NodeBindings::UvRunOnce() {
     base::RunLoop::QuitCurrentWhenIdleDeprecated();  // Quit from uv.
 
   // Tell the worker thread to continue polling.
-  uv_sem_post(&embed_sem_);
+  if (embed_thread_started_)
+    uv_sem_post(&embed_sem_);
+}
+
+void NodeBindings::OnUvEvents(base::TimeTicks ready_time) {
+  PerfCounters::AddTime(PerfMetric::UV_WAKEUP_LATENCY,
+                        base::TimeTicks::Now() - ready_time);
+  UvRunOnce();
+}
+
+bool NodeBindings::UsesEmbedThread() const {
+  return true;
 }
 
 void NodeBindings::WakeupMainThread() {
   DCHECK(message_loop_);
   message_loop_->task_runner()->PostTask(
       FROM_HERE,
-      base::Bind(&NodeBindings::UvRunOnce,
-      weak_factory_.GetWeakPtr()));
+      base::Bind(&NodeBindings::OnUvEvents,
+                 weak_factory_.GetWeakPtr(), base::TimeTicks::Now()));
 }
 
 void NodeBindings::WakeupEmbedThread() {
@@ -7,6 +7,7 @@
 
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "v8/include/v8.h"
 #include "vendor/node/deps/uv/include/uv.h"
 
@@ -48,12 +49,20 @@ class NodeBindings {
  protected:
   NodeBindings();
 
+  // Whether uv events are polled in a separate thread, derived classes that
+  // watch uv's backend fd on the main thread return false.
+  virtual bool UsesEmbedThread() const;
+
   // Called to poll events in new thread.
   virtual void PollEvents() = 0;
 
   // Run the libuv loop for once.
   void UvRunOnce();
 
+  // Run the libuv loop for once after its backend fd became readable at
+  // |ready_time|.
+  void OnUvEvents(base::TimeTicks ready_time);
+
   // Make the main thread run libuv loop.
   void WakeupMainThread();
 
@@ -73,6 +82,9 @@ class NodeBindings {
   // Whether the libuv loop has ended.
   bool embed_closed_;
 
+  // Whether the embed thread has been started.
+  bool embed_thread_started_;
+
   // Dummy handle to make uv's loop not quit.
   uv_async_t dummy_uv_handle_;
 
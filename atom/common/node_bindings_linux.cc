@@ -6,11 +6,42 @@
 
 #include <sys/epoll.h>
 
+#if defined(USE_GLIB)
+#include <glib.h>
+#endif
+
+#include "atom/common/options_switches.h"
+#include "base/command_line.h"
+
 namespace atom {
 
+#if defined(USE_GLIB)
+namespace {
+
+// Same priority as the source base::MessagePumpGlib runs tasks from, so uv
+// events and Chromium tasks take turns as they did when uv ran in a task.
+const int kPriorityUv = 1;
+
+}  // namespace
+
+struct NodeBindingsLinux::UvSource {
+  GSource source;
+  GPollFD poll_fd;
+  NodeBindingsLinux* bindings;
+};
+#endif
+
 NodeBindingsLinux::NodeBindingsLinux()
     : NodeBindings(),
+      use_embed_thread_(true),
       epoll_(epoll_create(1)) {
+#if defined(USE_GLIB)
+  uv_source_ = nullptr;
+  uv_run_pending_ = false;
+  use_embed_thread_ = base::CommandLine::ForCurrentProcess()->HasSwitch(
+      switches::kNodeEmbedThread);
+#endif
+
   int backend_fd = uv_backend_fd(uv_loop_);
   struct epoll_event ev = { 0 };
   ev.events = EPOLLIN;
@@ -19,6 +50,12 @@ NodeBindingsLinux::NodeBindingsLinux()
 }
 
 NodeBindingsLinux::~NodeBindingsLinux() {
+#if defined(USE_GLIB)
+  if (uv_source_) {
+    g_source_destroy(uv_source_);
+    g_source_unref(uv_source_);
+  }
+#endif
 }
 
 void NodeBindingsLinux::RunMessageLoop() {
@@ -26,13 +63,50 @@ void NodeBindingsLinux::RunMessageLoop() {
   uv_loop_->data = this;
   uv_loop_->on_watcher_queue_updated = OnWatcherQueueChanged;
 
+#if defined(USE_GLIB)
+  if (!use_embed_thread_) {
+    static GSourceFuncs source_funcs = {
+      OnSourcePrepare,
+      OnSourceCheck,
+      OnSourceDispatch,
+      nullptr,
+    };
+    uv_source_ = g_source_new(&source_funcs, sizeof(UvSource));
+    UvSource* source = reinterpret_cast<UvSource*>(uv_source_);
+    source->bindings = this;
+    source->poll_fd.fd = uv_backend_fd(uv_loop_);
+    source->poll_fd.events = G_IO_IN;
+    source->poll_fd.revents = 0;
+    g_source_add_poll(uv_source_, &source->poll_fd);
+    g_source_set_priority(uv_source_, kPriorityUv);
+    g_source_set_can_recurse(uv_source_, FALSE);
+    // MessagePumpGlib runs the default context on the main thread.
+    g_source_attach(uv_source_, g_main_context_default());
+  }
+#endif
+
   NodeBindings::RunMessageLoop();
 }
 
+bool NodeBindingsLinux::UsesEmbedThread() const {
+  return use_embed_thread_;
+}
+
 // static
 void NodeBindingsLinux::OnWatcherQueueChanged(uv_loop_t* loop) {
   NodeBindingsLinux* self = static_cast<NodeBindingsLinux*>(loop->data);
 
+  // The uv loop has to run to add new watchers to its backend fd, otherwise
+  // their events cannot be notified.
+#if defined(USE_GLIB)
+  if (!self->use_embed_thread_) {
+    // This is called on the main thread, the glib loop sees the flag before
+    // it polls again.
+    self->uv_run_pending_ = true;
+    return;
+  }
+#endif
+
   // We need to break the io polling in the epoll thread when loop's watcher
   // queue changes, otherwise new events cannot be notified.
   self->WakeupEmbedThread();
@@ -49,6 +123,45 @@ void NodeBindingsLinux::PollEvents() {
   } while (r == -1 && errno == EINTR);
 }
 
+#if defined(USE_GLIB)
+// static
+int NodeBindingsLinux::OnSourcePrepare(GSource* source, int* timeout) {
+  NodeBindingsLinux* self = reinterpret_cast<UvSource*>(source)->bindings;
+  *timeout = self->uv_run_pending_ ? 0 : uv_backend_timeout(self->uv_loop_);
+  self->next_timer_ = *timeout > 0
+      ? base::TimeTicks::Now() + base::TimeDelta::FromMilliseconds(*timeout)
+      : base::TimeTicks();
+  if (*timeout == 0) {
+    self->ready_time_ = base::TimeTicks::Now();
+    return TRUE;
+  }
+  return FALSE;
+}
+
+// static
+int NodeBindingsLinux::OnSourceCheck(GSource* source) {
+  UvSource* uv_source = reinterpret_cast<UvSource*>(source);
+  NodeBindingsLinux* self = uv_source->bindings;
+  base::TimeTicks now = base::TimeTicks::Now();
+  if ((uv_source->poll_fd.revents & G_IO_IN) ||
+      (!self->next_timer_.is_null() && now >= self->next_timer_)) {
+    self->ready_time_ = now;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+// static
+int NodeBindingsLinux::OnSourceDispatch(GSource* source,
+                                        int (*callback)(void*),
+                                        void* user_data) {
+  NodeBindingsLinux* self = reinterpret_cast<UvSource*>(source)->bindings;
+  self->uv_run_pending_ = false;
+  self->OnUvEvents(self->ready_time_);
+  return TRUE;
+}
+#endif
+
 // static
 NodeBindings* NodeBindings::Create() {
   return new NodeBindingsLinux();
@@ -7,9 +7,17 @@
 
 #include "atom/common/node_bindings.h"
 #include "base/compiler_specific.h"
+#include "base/time/time.h"
+
+#if defined(USE_GLIB)
+typedef struct _GSource GSource;
+#endif
 
 namespace atom {
 
+// With glib, unless --node-embed-thread is passed, uv's backend fd is polled
+// by the main thread's glib loop together with Chromium's own sources, so uv
+// events are handled without waking another thread and posting a task.
 class NodeBindingsLinux : public NodeBindings {
  public:
   NodeBindingsLinux();
@@ -17,15 +25,40 @@ class NodeBindingsLinux : public NodeBindings {
 
   void RunMessageLoop() override;
 
+ protected:
+  bool UsesEmbedThread() const override;
+
  private:
   // Called when uv's watcher queue changes.
   static void OnWatcherQueueChanged(uv_loop_t* loop);
 
   void PollEvents() override;
 
+  bool use_embed_thread_;
+
   // Epoll to poll for uv's backend fd.
   int epoll_;
 
+#if defined(USE_GLIB)
+  struct UvSource;
+
+  // GSourceFuncs of |uv_source_|.
+  static int OnSourcePrepare(GSource* source, int* timeout);
+  static int OnSourceCheck(GSource* source);
+  static int OnSourceDispatch(GSource* source,
+                              int (*callback)(void*),
+                              void* user_data);
+
+  // Watches uv's backend fd and timers in the main thread's glib loop.
+  GSource* uv_source_;
+  // Set when the uv loop has to run before its next poll.
+  bool uv_run_pending_;
+  // When the next uv timer is due, null if there is none.
+  base::TimeTicks next_timer_;
+  // When |uv_source_| found uv ready to run.
+  base::TimeTicks ready_time_;
+#endif
+
   DISALLOW_COPY_AND_ASSIGN(NodeBindingsLinux);
 };
 
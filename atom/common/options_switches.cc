@@ -128,6 +128,21 @@ const char kCipherSuiteBlacklist[] = "cipher-suite-blacklist";
 // The browser process app model ID
 const char kAppUserModelId[] = "app-user-model-id";
 
+// Write a trace of the browser startup to the given file at first paint.
+const char kStartupTimeline[] = "startup-timeline";
+
+// Don't read the profile's files ahead while the JS environment boots.
+const char kDisableProfileReadAhead[] = "disable-profile-read-ahead";
+
+// Poll libuv from a separate thread on Linux, as on the other platforms.
+const char kNodeEmbedThread[] = "node-embed-thread";
+
+// Number of tab guests to create ahead of time per partition.
+const char kGuestPoolSize[] = "guest-pool-size";
+
+// Number of range requests a large download is split into.
+const char kParallelDownloadSegments[] = "parallel-download-segments";
+
 // The command line switch versions of the options.
 const char kBackgroundColor[] = "background-color";
 const char kZoomFactor[]      = "zoom-factor";
@@ -73,6 +73,11 @@ extern const char kRegisterServiceWorkerSchemes[];
 extern const char kSSLVersionFallbackMin[];
 extern const char kCipherSuiteBlacklist[];
 extern const char kAppUserModelId[];
+extern const char kStartupTimeline[];
+extern const char kDisableProfileReadAhead[];
+extern const char kNodeEmbedThread[];
+extern const char kGuestPoolSize[];
+extern const char kParallelDownloadSegments[];
 
 extern const char kBackgroundColor[];
 extern const char kZoomFactor[];
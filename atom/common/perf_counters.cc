@@ -0,0 +1,256 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/common/perf_counters.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "base/atomicops.h"
+#include "base/bits.h"
+#include "base/compiler_specific.h"
+#include "base/json/json_writer.h"
+#include "base/lazy_instance.h"
+#include "base/threading/thread_local.h"
+#include "base/trace_event/trace_event.h"
+#include "base/values.h"
+
+namespace atom {
+
+namespace {
+
+enum MetricKind {
+  KIND_COUNTER,
+  KIND_GAUGE,
+  KIND_HISTOGRAM,
+};
+
+struct MetricInfo {
+  const char* name;
+  MetricKind kind;
+};
+
+const MetricInfo kMetrics[] = {
+  {"ipc.message", KIND_HISTOGRAM},
+  {"ipc.messageSync", KIND_HISTOGRAM},
+  {"ipc.messageShared", KIND_HISTOGRAM},
+  {"ipc.broadcast", KIND_HISTOGRAM},
+  {"ipc.channelRegistered", KIND_COUNTER},
+  {"webRequest.event", KIND_COUNTER},
+  {"webRequest.blockingEvent", KIND_HISTOGRAM},
+  {"asar.lookup", KIND_HISTOGRAM},
+  {"asar.copyFileOut", KIND_HISTOGRAM},
+  {"prefs.load", KIND_HISTOGRAM},
+  {"prefs.update", KIND_COUNTER},
+  {"prefs.commit", KIND_HISTOGRAM},
+  {"prefs.diff", KIND_HISTOGRAM},
+  {"worker.queueDepth", KIND_GAUGE},
+  {"worker.queueTime", KIND_HISTOGRAM},
+  {"guestPool.hit", KIND_COUNTER},
+  {"guestPool.miss", KIND_COUNTER},
+  {"guestPool.size", KIND_GAUGE},
+  {"tab.create", KIND_HISTOGRAM},
+  {"permissions.cacheHit", KIND_COUNTER},
+  {"permissions.cacheMiss", KIND_COUNTER},
+  {"partition.create", KIND_HISTOGRAM},
+  {"partition.count", KIND_GAUGE},
+  {"certVerifier.verify", KIND_HISTOGRAM},
+  {"certVerifier.cacheHit", KIND_COUNTER},
+  {"certVerifier.cacheMiss", KIND_COUNTER},
+  {"valueConverter.slice", KIND_HISTOGRAM},
+  {"uv.wakeupLatency", KIND_HISTOGRAM},
+  {"startup.profileReady", KIND_HISTOGRAM},
+};
+
+const size_t kMetricCount = static_cast<size_t>(PerfMetric::COUNT);
+static_assert(arraysize(kMetrics) == kMetricCount,
+              "kMetrics must have an entry for every PerfMetric");
+
+// Bucket 0 holds samples under 1us, bucket i samples in [2^(i-1), 2^i)us.
+// The last one also holds everything from about 4s on.
+const int kBucketCount = 24;
+const int kShardCount = 16;
+
+struct Metric {
+  // Number of samples, or the value of a gauge.
+  base::subtle::AtomicWord count;
+  base::subtle::AtomicWord sum_us;
+  base::subtle::AtomicWord buckets[kBucketCount];
+};
+
+struct ALIGNAS(64) Shard {
+  Metric metrics[kMetricCount];
+};
+
+// Zero initialized, so no static initializer is needed.
+Shard g_shards[kShardCount];
+base::subtle::Atomic32 g_next_shard = 0;
+
+base::LazyInstance<base::ThreadLocalPointer<Shard>>::Leaky g_thread_shard =
+    LAZY_INSTANCE_INITIALIZER;
+
+Metric* GetMetric(PerfMetric metric) {
+  base::ThreadLocalPointer<Shard>& thread_shard = g_thread_shard.Get();
+  Shard* shard = thread_shard.Get();
+  if (!shard) {
+    uint32_t index = static_cast<uint32_t>(
+        base::subtle::NoBarrier_AtomicIncrement(&g_next_shard, 1));
+    shard = &g_shards[index % kShardCount];
+    thread_shard.Set(shard);
+  }
+  return &shard->metrics[static_cast<size_t>(metric)];
+}
+
+int GetBucket(int64_t us) {
+  if (us < 1)
+    return 0;
+  uint32_t value = static_cast<uint32_t>(
+      std::min<int64_t>(us, std::numeric_limits<uint32_t>::max()));
+  return std::min(base::bits::Log2Floor(value) + 1, kBucketCount - 1);
+}
+
+double GetBucketStart(int bucket) {
+  return bucket == 0 ? 0 : static_cast<double>(1u << (bucket - 1));
+}
+
+struct MetricTotals {
+  int64_t count;
+  int64_t sum_us;
+  int64_t buckets[kBucketCount];
+};
+
+void GetTotals(size_t index, MetricTotals* totals) {
+  memset(totals, 0, sizeof(*totals));
+  for (const Shard& shard : g_shards) {
+    const Metric& metric = shard.metrics[index];
+    totals->count += base::subtle::NoBarrier_Load(&metric.count);
+    totals->sum_us += base::subtle::NoBarrier_Load(&metric.sum_us);
+    for (int i = 0; i < kBucketCount; ++i)
+      totals->buckets[i] += base::subtle::NoBarrier_Load(&metric.buckets[i]);
+  }
+}
+
+// Interpolates the |fraction| percentile of |totals| in milliseconds.
+double GetPercentileMs(const MetricTotals& totals, double fraction) {
+  int64_t samples = 0;
+  for (int64_t bucket_count : totals.buckets)
+    samples += bucket_count;
+  if (samples == 0)
+    return 0;
+
+  double target = fraction * samples;
+  int64_t seen = 0;
+  for (int i = 0; i < kBucketCount; ++i) {
+    if (totals.buckets[i] == 0 || seen + totals.buckets[i] < target) {
+      seen += totals.buckets[i];
+      continue;
+    }
+    double start = GetBucketStart(i);
+    double end = i == 0 ? 1 : start * 2;
+    double us = start + (end - start) * (target - seen) / totals.buckets[i];
+    return us / base::Time::kMicrosecondsPerMillisecond;
+  }
+  return GetBucketStart(kBucketCount - 1) /
+      base::Time::kMicrosecondsPerMillisecond;
+}
+
+class SnapshotTraceValue
+    : public base::trace_event::ConvertableToTraceFormat {
+ public:
+  explicit SnapshotTraceValue(std::unique_ptr<base::DictionaryValue> snapshot)
+      : snapshot_(std::move(snapshot)) {}
+  ~SnapshotTraceValue() override {}
+
+  // base::trace_event::ConvertableToTraceFormat:
+  void AppendAsTraceFormat(std::string* out) const override {
+    std::string json;
+    base::JSONWriter::Write(*snapshot_, &json);
+    out->append(json);
+  }
+
+ private:
+  std::unique_ptr<base::DictionaryValue> snapshot_;
+
+  DISALLOW_COPY_AND_ASSIGN(SnapshotTraceValue);
+};
+
+}  // namespace
+
+// static
+void PerfCounters::Increment(PerfMetric metric) {
+  base::subtle::NoBarrier_AtomicIncrement(&GetMetric(metric)->count, 1);
+}
+
+// static
+void PerfCounters::AddTime(PerfMetric metric, base::TimeDelta time) {
+  int64_t us = std::max<int64_t>(time.InMicroseconds(), 0);
+  Metric* data = GetMetric(metric);
+  base::subtle::NoBarrier_AtomicIncrement(&data->count, 1);
+  base::subtle::NoBarrier_AtomicIncrement(
+      &data->sum_us, static_cast<base::subtle::AtomicWord>(us));
+  base::subtle::NoBarrier_AtomicIncrement(&data->buckets[GetBucket(us)], 1);
+}
+
+// static
+void PerfCounters::AddToGauge(PerfMetric metric, int delta) {
+  base::subtle::NoBarrier_AtomicIncrement(&GetMetric(metric)->count, delta);
+}
+
+// static
+std::unique_ptr<base::DictionaryValue> PerfCounters::GetSnapshot() {
+  std::unique_ptr<base::DictionaryValue> snapshot(new base::DictionaryValue);
+  for (size_t i = 0; i < kMetricCount; ++i) {
+    MetricTotals totals;
+    GetTotals(i, &totals);
+
+    std::unique_ptr<base::DictionaryValue> stats(new base::DictionaryValue);
+    switch (kMetrics[i].kind) {
+      case KIND_COUNTER:
+        stats->SetDouble("count", totals.count);
+        break;
+      case KIND_GAUGE:
+        stats->SetDouble("value", totals.count);
+        break;
+      case KIND_HISTOGRAM:
+        stats->SetDouble("count", totals.count);
+        stats->SetDouble("meanMs", totals.count == 0 ? 0 :
+            static_cast<double>(totals.sum_us) / totals.count /
+                base::Time::kMicrosecondsPerMillisecond);
+        stats->SetDouble("p50Ms", GetPercentileMs(totals, 0.5));
+        stats->SetDouble("p90Ms", GetPercentileMs(totals, 0.9));
+        stats->SetDouble("p99Ms", GetPercentileMs(totals, 0.99));
+        break;
+    }
+    snapshot->SetWithoutPathExpansion(kMetrics[i].name, std::move(stats));
+  }
+  return snapshot;
+}
+
+// static
+void PerfCounters::TraceSnapshot() {
+  bool enabled = false;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED("browser", &enabled);
+  if (!enabled)
+    return;
+
+  TRACE_EVENT_INSTANT1(
+      "browser", "PerfCounters", TRACE_EVENT_SCOPE_PROCESS, "metrics",
+      std::unique_ptr<base::trace_event::ConvertableToTraceFormat>(
+          new SnapshotTraceValue(GetSnapshot())));
+}
+
+ScopedPerfTimer::ScopedPerfTimer(PerfMetric metric)
+    : metric_(metric),
+      start_(base::TimeTicks::Now()) {}
+
+ScopedPerfTimer::~ScopedPerfTimer() {
+  PerfCounters::AddTime(metric_, base::TimeTicks::Now() - start_);
+}
+
+}  // namespace atom
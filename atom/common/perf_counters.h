@@ -0,0 +1,118 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_PERF_COUNTERS_H_
+#define ATOM_COMMON_PERF_COUNTERS_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace atom {
+
+// Keep in sync with the metric table in perf_counters.cc.
+enum class PerfMetric {
+  // Time spent handling renderer ipc messages.
+  IPC_MESSAGE,
+  IPC_MESSAGE_SYNC,
+  IPC_MESSAGE_SHARED,
+  // Time taken to send one message to many frames.
+  IPC_BROADCAST,
+  // Channels renderers assigned an id to, see IPCChannelRegistry.
+  IPC_CHANNEL_REGISTERED,
+  // webRequest events sent to listeners that can't change the request.
+  WEB_REQUEST_EVENT,
+  // Round trip of events waiting for a blocking webRequest listener.
+  WEB_REQUEST_BLOCKING_EVENT,
+  // asar::Archive header lookups.
+  ASAR_LOOKUP,
+  // Files extracted from an asar archive.
+  ASAR_COPY_FILE_OUT,
+  // Synchronous reads of a profile's prefs file.
+  PREFS_LOAD,
+  // Changes to the profile prefs.
+  PREFS_UPDATE,
+  // Time from serializing the profile prefs to having them on disk.
+  PREFS_COMMIT,
+  // Time taken to diff a changed dictionary pref for its observers.
+  PREFS_DIFF,
+  // Messages posted to V8 worker threads that haven't run yet.
+  WORKER_QUEUE_DEPTH,
+  // Time messages wait in a V8 worker thread queue.
+  WORKER_QUEUE_TIME,
+  // Tabs created with a pooled guest, or without one.
+  GUEST_POOL_HIT,
+  GUEST_POOL_MISS,
+  // Guests waiting in the pools of --guest-pool-size.
+  GUEST_POOL_SIZE,
+  // Time taken to create a tab's guest.
+  TAB_CREATE,
+  // Permission requests answered from, or missing in, the decision cache.
+  PERMISSION_CACHE_HIT,
+  PERMISSION_CACHE_MISS,
+  // Time taken to create a browser context for a partition, and the number
+  // of them alive.
+  PARTITION_CREATE,
+  PARTITION_COUNT,
+  // Time taken to verify a certificate with a verify proc installed, and
+  // verifications answered from, or missing in, its verdict cache.
+  CERT_VERIFY,
+  CERT_VERDICT_CACHE_HIT,
+  CERT_VERDICT_CACHE_MISS,
+  // Time taken by a slice of an IncrementalV8ValueConverter.
+  VALUE_CONVERT_SLICE,
+  // Time from uv events being ready until the main thread runs the uv loop.
+  UV_WAKEUP_LATENCY,
+  // Time from the start of the JS bootstrap until the default profile has
+  // loaded.
+  STARTUP_PROFILE_READY,
+
+  COUNT,
+};
+
+// Process wide counters, gauges and latency histograms for muon's hot
+// paths, cheap enough to stay enabled in production builds.
+//
+// Updates are relaxed atomic adds to one of a few shards picked once per
+// thread, so they never lock and threads rarely share a cache line. Reads add
+// up every shard and may miss updates still in flight. Latencies are kept in
+// power of two microsecond buckets, percentiles are interpolated in them.
+class PerfCounters {
+ public:
+  static void Increment(PerfMetric metric);
+  static void AddTime(PerfMetric metric, base::TimeDelta time);
+  static void AddToGauge(PerfMetric metric, int delta);
+
+  // Returns {name: stats} for every metric. Histograms have count, meanMs,
+  // p50Ms, p90Ms and p99Ms, counters have count and gauges value.
+  static std::unique_ptr<base::DictionaryValue> GetSnapshot();
+
+  // Adds the snapshot to the trace being recorded.
+  static void TraceSnapshot();
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(PerfCounters);
+};
+
+// Records the time until it goes out of scope in a histogram metric.
+class ScopedPerfTimer {
+ public:
+  explicit ScopedPerfTimer(PerfMetric metric);
+  ~ScopedPerfTimer();
+
+ private:
+  PerfMetric metric_;
+  base::TimeTicks start_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedPerfTimer);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_PERF_COUNTERS_H_
@@ -0,0 +1,54 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/ipc_channel_registry.h"
+
+#include "atom/common/api/api_messages.h"
+#include "atom/common/atom_constants.h"
+
+namespace atom {
+
+// static
+IPCChannelRegistry* IPCChannelRegistry::FromFrame(
+    content::RenderFrame* render_frame) {
+  IPCChannelRegistry* registry = Get(render_frame);
+  if (!registry)
+    registry = new IPCChannelRegistry(render_frame);
+  return registry;
+}
+
+IPCChannelRegistry::IPCChannelRegistry(content::RenderFrame* render_frame)
+    : content::RenderFrameObserver(render_frame),
+      content::RenderFrameObserverTracker<IPCChannelRegistry>(render_frame) {
+}
+
+IPCChannelRegistry::~IPCChannelRegistry() {}
+
+bool IPCChannelRegistry::GetChannelId(const std::string& event,
+                                      const std::string& channel,
+                                      uint32_t* channel_id) {
+  auto key = std::make_pair(event, channel);
+  auto it = channel_ids_.find(key);
+  if (it != channel_ids_.end()) {
+    *channel_id = it->second;
+    return true;
+  }
+
+  if (channel_ids_.size() >= kMaxIPCChannels)
+    return false;
+
+  *channel_id = static_cast<uint32_t>(channel_ids_.size());
+  if (!Send(new AtomViewHostMsg_RegisterChannel(
+          routing_id(), *channel_id, event, channel)))
+    return false;
+
+  channel_ids_.insert(std::make_pair(std::move(key), *channel_id));
+  return true;
+}
+
+void IPCChannelRegistry::OnDestruct() {
+  delete this;
+}
+
+}  // namespace atom
@@ -0,0 +1,51 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_IPC_CHANNEL_REGISTRY_H_
+#define ATOM_RENDERER_IPC_CHANNEL_REGISTRY_H_
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "base/macros.h"
+#include "content/public/renderer/render_frame_observer.h"
+#include "content/public/renderer/render_frame_observer_tracker.h"
+
+namespace atom {
+
+// Assigns small integer ids to the ipc channels a frame sends messages on.
+//
+// The first message on a channel registers its id with the browser, which
+// keeps a table of them per frame, later messages only carry the id. Since
+// registrations are routed to the same frame as the messages using them, they
+// can't be reordered or dropped separately.
+class IPCChannelRegistry
+    : public content::RenderFrameObserver,
+      public content::RenderFrameObserverTracker<IPCChannelRegistry> {
+ public:
+  static IPCChannelRegistry* FromFrame(content::RenderFrame* render_frame);
+
+  // Sets |channel_id| to the id of |channel| for |event| messages,
+  // registering it first if needed. Returns false when the frame has
+  // registered kMaxIPCChannels channels already.
+  bool GetChannelId(const std::string& event,
+                    const std::string& channel,
+                    uint32_t* channel_id);
+
+ private:
+  explicit IPCChannelRegistry(content::RenderFrame* render_frame);
+  ~IPCChannelRegistry() override;
+
+  // content::RenderFrameObserver:
+  void OnDestruct() override;
+
+  std::map<std::pair<std::string, std::string>, uint32_t> channel_ids_;
+
+  DISALLOW_COPY_AND_ASSIGN(IPCChannelRegistry);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_IPC_CHANNEL_REGISTRY_H_
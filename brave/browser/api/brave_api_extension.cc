@@ -12,13 +12,16 @@
 #include "atom/browser/extensions/atom_extension_system.h"
 #include "atom/browser/extensions/tab_helper.h"
 #include "atom/common/api/event_emitter_caller.h"
+#include "brave/browser/api/url_override_rules.h"
 #include "brave/common/converters/callback_converter.h"
 #include "brave/common/converters/gurl_converter.h"
 #include "brave/common/converters/file_path_converter.h"
 #include "brave/common/converters/value_converter.h"
 #include "atom/common/node_includes.h"
+#include "base/containers/mru_cache.h"
 #include "base/files/file_path.h"
 #include "base/strings/string_util.h"
+#include "base/values.h"
 #include "components/prefs/pref_service.h"
 #include "components/user_prefs/user_prefs.h"
 #include "content/public/browser/browser_thread.h"
@@ -107,10 +110,109 @@ scoped_refptr<extensions::Extension> LoadExtension(const base::FilePath& path,
   return extension;
 }
 
-std::map<std::string,
-  base::Callback<GURL(const GURL&)>> url_override_callbacks_;
-std::map<std::string,
-  base::Callback<GURL(const GURL&)>> reverse_url_override_callbacks_;
+// Maximum number of rewrite results remembered per extension
+const size_t kURLOverrideCacheSize = 256;
+
+// Rewrites registered for a single extension. Native rules are tried before
+// the JS callback and every result, including "no override", is memoized so
+// repeated navigations to the same URL never enter V8.
+struct URLOverrideHandler {
+  URLOverrideHandler() : cache(kURLOverrideCacheSize) {}
+
+  brave::URLOverrideRules rules;
+  base::Callback<GURL(const GURL&)> callback;
+  base::MRUCache<GURL, GURL> cache;
+};
+
+using URLOverrideHandlers =
+    std::map<std::string, std::unique_ptr<URLOverrideHandler>>;
+
+URLOverrideHandlers url_override_handlers_;
+URLOverrideHandlers reverse_url_override_handlers_;
+
+URLOverrideHandler* GetOrCreateHandler(URLOverrideHandlers* handlers,
+                                       const std::string& extension_id) {
+  auto& handler = (*handlers)[extension_id];
+  if (!handler)
+    handler.reset(new URLOverrideHandler);
+  return handler.get();
+}
+
+void SetURLOverrideCallback(URLOverrideHandlers* handlers,
+                            gin::Arguments* args) {
+  std::string extension_id;
+  if (!args->GetNext(&extension_id)) {
+    args->ThrowTypeError("`extension_id` must be a string");
+    return;
+  }
+
+  base::Callback<GURL(const GURL&)> callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowTypeError("`callback` must be a function");
+    return;
+  }
+
+  auto handler = GetOrCreateHandler(handlers, extension_id);
+  handler->callback = callback;
+  handler->cache.Clear();
+}
+
+void SetURLOverrideRules(URLOverrideHandlers* handlers,
+                         gin::Arguments* args) {
+  std::string extension_id;
+  if (!args->GetNext(&extension_id)) {
+    args->ThrowTypeError("`extension_id` must be a string");
+    return;
+  }
+
+  base::ListValue rules;
+  if (!args->GetNext(&rules)) {
+    args->ThrowTypeError("`rules` must be an array");
+    return;
+  }
+
+  auto handler = GetOrCreateHandler(handlers, extension_id);
+  std::string error;
+  if (!handler->rules.Parse(rules, &error)) {
+    args->ThrowTypeError(error);
+    return;
+  }
+  handler->cache.Clear();
+}
+
+bool RunURLOverride(URLOverrideHandlers* handlers,
+                    GURL* url,
+                    content::BrowserContext* browser_context) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  const extensions::Extension* extension =
+      extensions::ExtensionRegistry::Get(browser_context)->enabled_extensions()
+          .GetExtensionOrAppByURL(*url);
+  if (!extension)
+    return false;
+
+  auto it = handlers->find(extension->id());
+  if (it == handlers->end())
+    return false;
+  URLOverrideHandler* handler = it->second.get();
+
+  GURL new_url;
+  auto cached = handler->cache.Get(*url);
+  if (cached != handler->cache.end()) {
+    new_url = cached->second;
+  } else {
+    if (!handler->rules.Rewrite(*url, &new_url) && !handler->callback.is_null())
+      new_url = handler->callback.Run(*url);
+    handler->cache.Put(*url, new_url);
+  }
+
+  if (new_url != GURL()) {
+    *url = new_url;
+    return true;
+  }
+
+  return false;
+}
+
 }  // namespace
 
 namespace brave {
@@ -138,7 +240,9 @@ gin::ObjectTemplateBuilder Extension::GetObjectTemplateBuilder(
       .SetMethod("enable", &Extension::Enable)
       .SetMethod("disable", &Extension::Disable)
       .SetMethod("setURLHandler", &Extension::SetURLHandler)
-      .SetMethod("setReverseURLHandler", &Extension::SetReverseURLHandler);
+      .SetMethod("setReverseURLHandler", &Extension::SetReverseURLHandler)
+      .SetMethod("setURLRules", &Extension::SetURLRules)
+      .SetMethod("setReverseURLRules", &Extension::SetReverseURLRules);
 }
 
 Extension::Extension(v8::Isolate* isolate,
@@ -276,6 +380,14 @@ void Extension::OnExtensionUnloaded(
     content::BrowserContext* browser_context,
     const extensions::Extension* extension,
     extensions::UnloadedExtensionReason reason) {
+  // A reloaded extension may resolve its URLs differently
+  for (auto* handlers :
+       { &url_override_handlers_, &reverse_url_override_handlers_ }) {
+    auto it = handlers->find(extension->id());
+    if (it != handlers->end())
+      it->second->cache.Clear();
+  }
+
   node::Environment* env = node::Environment::GetCurrent(isolate());
   if (!env)
     return;
@@ -370,78 +482,31 @@ content::WebContents* Extension::MaybeCreateBackgroundContents(
 }
 
 void Extension::SetURLHandler(gin::Arguments* args) {
-  std::string extension_id;
-  if (!args->GetNext(&extension_id)) {
-    args->ThrowTypeError("`extension_id` must be a string");
-    return;
-  }
-
-  base::Callback<GURL(const GURL&)> callback;
-  if (!args->GetNext(&callback)) {
-    args->ThrowTypeError("`callback` must be a function");
-    return;
-  }
-
-  url_override_callbacks_[extension_id] = callback;
+  SetURLOverrideCallback(&url_override_handlers_, args);
 }
 
 void Extension::SetReverseURLHandler(gin::Arguments* args) {
-  std::string extension_id;
-  if (!args->GetNext(&extension_id)) {
-    args->ThrowTypeError("`extension_id` must be a string");
-    return;
-  }
+  SetURLOverrideCallback(&reverse_url_override_handlers_, args);
+}
 
-  base::Callback<GURL(const GURL&)> callback;
-  if (!args->GetNext(&callback)) {
-    args->ThrowTypeError("`callback` must be a function");
-    return;
-  }
+void Extension::SetURLRules(gin::Arguments* args) {
+  SetURLOverrideRules(&url_override_handlers_, args);
+}
 
-  reverse_url_override_callbacks_[extension_id] = callback;
+void Extension::SetReverseURLRules(gin::Arguments* args) {
+  SetURLOverrideRules(&reverse_url_override_handlers_, args);
 }
 
 // static
 bool Extension::HandleURLOverride(GURL* url,
         content::BrowserContext* browser_context) {
-  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
-  const extensions::Extension* extension =
-      extensions::ExtensionRegistry::Get(browser_context)->enabled_extensions()
-          .GetExtensionOrAppByURL(*url);
-  if (!extension)
-    return false;
-
-  if (!base::ContainsKey(url_override_callbacks_, extension->id()))
-    return false;
-
-  GURL new_url = url_override_callbacks_[extension->id()].Run(*url);
-  if (new_url != GURL()) {
-    *url = new_url;
-    return true;
-  }
-
-  return false;
+  return RunURLOverride(&url_override_handlers_, url, browser_context);
 }
 
+// static
 bool Extension::HandleURLOverrideReverse(GURL* url,
           content::BrowserContext* browser_context) {
-  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
-  const extensions::Extension* extension =
-      extensions::ExtensionRegistry::Get(browser_context)->enabled_extensions()
-          .GetExtensionOrAppByURL(*url);
-  if (!extension)
-    return false;
-
-  if (!base::ContainsKey(reverse_url_override_callbacks_, extension->id()))
-    return false;
-
-  GURL new_url = reverse_url_override_callbacks_[extension->id()].Run(*url);
-  if (new_url != GURL()) {
-    *url = new_url;
-    return true;
-  }
-
-  return false;
+  return RunURLOverride(&reverse_url_override_handlers_, url, browser_context);
 }
 
 }  // namespace api
@@ -74,6 +74,8 @@ class Extension : public gin::Wrappable<Extension>,
 
   void SetURLHandler(gin::Arguments* args);
   void SetReverseURLHandler(gin::Arguments* args);
+  void SetURLRules(gin::Arguments* args);
+  void SetReverseURLRules(gin::Arguments* args);
   void Disable(const std::string& extension_id);
   void Enable(const std::string& extension_id);
   v8::Isolate* isolate() { return isolate_; }
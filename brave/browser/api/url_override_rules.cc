@@ -0,0 +1,108 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/api/url_override_rules.h"
+
+#include <utility>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+#include "third_party/re2/src/re2/re2.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+const char kPrefixKey[] = "prefix";
+const char kRegexKey[] = "regex";
+const char kTargetKey[] = "target";
+
+}  // namespace
+
+URLOverrideRules::Rule::Rule() {}
+
+URLOverrideRules::Rule::~Rule() {}
+
+URLOverrideRules::URLOverrideRules() {}
+
+URLOverrideRules::~URLOverrideRules() {}
+
+bool URLOverrideRules::Parse(const base::ListValue& rules,
+                             std::string* error) {
+  std::vector<std::unique_ptr<Rule>> parsed;
+  for (size_t i = 0; i < rules.GetSize(); ++i) {
+    std::string index = base::SizeTToString(i);
+    const base::DictionaryValue* dict = nullptr;
+    if (!rules.GetDictionary(i, &dict)) {
+      *error = "rule " + index + " must be an object";
+      return false;
+    }
+
+    std::unique_ptr<Rule> rule(new Rule);
+    if (!dict->GetString(kTargetKey, &rule->target)) {
+      *error = "rule " + index + " must have a `target` string";
+      return false;
+    }
+
+    std::string pattern;
+    if (dict->GetString(kPrefixKey, &rule->prefix)) {
+      if (rule->prefix.empty()) {
+        *error = "rule " + index + " has an empty `prefix`";
+        return false;
+      }
+    } else if (dict->GetString(kRegexKey, &pattern)) {
+      RE2::Options options;
+      options.set_log_errors(false);
+      rule->regex.reset(new re2::RE2(pattern, options));
+      if (!rule->regex->ok()) {
+        *error = "rule " + index + " has an invalid `regex`: " +
+            rule->regex->error();
+        return false;
+      }
+      std::string rewrite_error;
+      if (!rule->regex->CheckRewriteString(rule->target, &rewrite_error)) {
+        *error = "rule " + index + " has an invalid `target`: " +
+            rewrite_error;
+        return false;
+      }
+    } else {
+      *error = "rule " + index + " must have a `prefix` or `regex` string";
+      return false;
+    }
+
+    parsed.push_back(std::move(rule));
+  }
+
+  rules_ = std::move(parsed);
+  return true;
+}
+
+bool URLOverrideRules::Rewrite(const GURL& url, GURL* new_url) const {
+  const std::string& spec = url.spec();
+  for (const auto& rule : rules_) {
+    std::string result;
+    if (rule->regex) {
+      result = spec;
+      if (!RE2::Replace(&result, *rule->regex, rule->target))
+        continue;
+    } else {
+      if (!base::StartsWith(spec, rule->prefix, base::CompareCase::SENSITIVE))
+        continue;
+      result = rule->target + spec.substr(rule->prefix.size());
+    }
+
+    GURL rewritten(result);
+    if (!rewritten.is_valid())
+      continue;
+
+    *new_url = rewritten;
+    return true;
+  }
+
+  return false;
+}
+
+}  // namespace brave
@@ -0,0 +1,62 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_API_URL_OVERRIDE_RULES_H_
+#define BRAVE_BROWSER_API_URL_OVERRIDE_RULES_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+
+class GURL;
+
+namespace base {
+class ListValue;
+}
+
+namespace re2 {
+class RE2;
+}
+
+namespace brave {
+
+// Declarative URL rewrites registered by an extension. Each rule matches
+// either a spec prefix, which is replaced by the target, or a regular
+// expression whose first match is replaced by the target (with \1 style
+// backreferences). Rules are tried in order and the first match wins.
+class URLOverrideRules {
+ public:
+  URLOverrideRules();
+  ~URLOverrideRules();
+
+  // Replaces the current rules with |rules|, a list of
+  // { prefix | regex, target } dictionaries. On failure the existing rules
+  // are kept and |error| describes the first invalid rule.
+  bool Parse(const base::ListValue& rules, std::string* error);
+
+  // Returns true and sets |new_url| if a rule rewrote |url| to a valid URL.
+  bool Rewrite(const GURL& url, GURL* new_url) const;
+
+  bool empty() const { return rules_.empty(); }
+
+ private:
+  struct Rule {
+    Rule();
+    ~Rule();
+
+    std::string prefix;
+    std::unique_ptr<re2::RE2> regex;
+    std::string target;
+  };
+
+  std::vector<std::unique_ptr<Rule>> rules_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLOverrideRules);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_API_URL_OVERRIDE_RULES_H_
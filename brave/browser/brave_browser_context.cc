@@ -7,11 +7,13 @@
 
 #include "brave/browser/brave_browser_context.h"
 
+#include "atom/common/perf_counters.h"
 #include "base/path_service.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/trace_event/trace_event.h"
 #include "brave/browser/brave_permission_manager.h"
+#include "brave/browser/profile_read_ahead.h"
 #include "chrome/browser/background_fetch/background_fetch_delegate_factory.h"
 #include "chrome/browser/background_fetch/background_fetch_delegate_impl.h"
 #include "chrome/browser/browser_process.h"
@@ -97,6 +99,26 @@ void NotifyOTRProfileDestroyedOnIOThread(void* original_profile,
   extensions::ExtensionWebRequestEventRouter::GetInstance()
       ->OnOTRBrowserContextDestroyed(original_profile, otr_profile);
 }
+
+// The router keeps one cross context entry per context, so registering an
+// ephemeral partition also points the parent at it. Point the parent back at
+// its own incognito context, or drop its entry when it has none, so that only
+// the ephemeral -> parent entry is added or removed.
+void NotifyEphemeralProfileOnIOThread(bool created,
+                                      void* original_profile,
+                                      void* ephemeral_profile,
+                                      void* otr_profile) {
+  auto router = extensions::ExtensionWebRequestEventRouter::GetInstance();
+  if (created)
+    router->OnOTRBrowserContextCreated(original_profile, ephemeral_profile);
+  else
+    router->OnOTRBrowserContextDestroyed(original_profile, ephemeral_profile);
+
+  if (otr_profile)
+    router->OnOTRBrowserContextCreated(original_profile, otr_profile);
+  else
+    router->OnOTRBrowserContextDestroyed(original_profile, original_profile);
+}
 #endif
 
 // WATCH(bridiver) - chrome/browser/profiles/profile_impl.cc
@@ -124,6 +146,43 @@ std::string ExitTypeToSessionTypePrefValue(Profile::ExitType type) {
   return std::string();
 }
 
+void OnPrefsCommitted(base::TimeTicks start, bool success) {
+  if (success) {
+    atom::PerfCounters::AddTime(atom::PerfMetric::PREFS_COMMIT,
+                                base::TimeTicks::Now() - start);
+  }
+}
+
+// Counts profile pref updates and times their commits to disk.
+class PerfCountingPrefFilter : public PrefFilter {
+ public:
+  PerfCountingPrefFilter() {}
+  ~PerfCountingPrefFilter() override {}
+
+  // PrefFilter:
+  void FilterOnLoad(
+      const PostFilterOnLoadCallback& post_filter_on_load_callback,
+      std::unique_ptr<base::DictionaryValue> pref_store_contents) override {
+    post_filter_on_load_callback.Run(std::move(pref_store_contents), false);
+  }
+
+  void FilterUpdate(const std::string& path) override {
+    atom::PerfCounters::Increment(atom::PerfMetric::PREFS_UPDATE);
+  }
+
+  OnWriteCallbackPair FilterSerializeData(
+      base::DictionaryValue* pref_store_contents) override {
+    return std::make_pair(
+        base::Closure(),
+        base::Bind(&OnPrefsCommitted, base::TimeTicks::Now()));
+  }
+
+  void OnStoreDeletionFromDisk() override {}
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(PerfCountingPrefFilter);
+};
+
 }  // namespace
 
 const char kPersistPrefix[] = "persist:";
@@ -147,6 +206,7 @@ BraveBrowserContext::BraveBrowserContext(
     : Profile(partition, in_memory, options),
       pref_registry_(new user_prefs::PrefRegistrySyncable),
       has_parent_(false),
+      is_ephemeral_(false),
       original_context_(nullptr),
       otr_context_(nullptr),
       partition_(partition),
@@ -162,7 +222,16 @@ BraveBrowserContext::BraveBrowserContext(
         atom::AtomBrowserContext::From(parent_partition, false));
   }
 
-  if (in_memory) {
+  atom::ScopedPerfTimer timer(atom::PerfMetric::PARTITION_CREATE);
+  atom::PerfCounters::AddToGauge(atom::PerfMetric::PARTITION_COUNT, 1);
+
+  if (in_memory && has_parent_)
+    options.GetBoolean("ephemeral", &is_ephemeral_);
+
+  // An ephemeral partition is an off the record view of its parent, without
+  // the persistent context, prefs file and web database of its own that other
+  // in-memory partitions are backed by.
+  if (in_memory && !is_ephemeral_) {
     original_context_ = static_cast<BraveBrowserContext*>(
         atom::AtomBrowserContext::From(partition, false));
     original_context_->otr_context_ = this;
@@ -172,7 +241,14 @@ BraveBrowserContext::BraveBrowserContext(
     TrackZoomLevelsFromParent();
   }
 #if BUILDFLAG(ENABLE_EXTENSIONS)
-  if (IsOffTheRecord()) {
+  if (IsEphemeral()) {
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&NotifyEphemeralProfileOnIOThread, true,
+          base::Unretained(original_context_),
+          base::Unretained(this),
+          base::Unretained(original_context_->otr_context_)));
+  } else if (IsOffTheRecord()) {
     BrowserThread::PostTask(
         BrowserThread::IO, FROM_HERE,
         base::Bind(&NotifyOTRProfileCreatedOnIOThread,
@@ -204,8 +280,12 @@ BraveBrowserContext::~BraveBrowserContext() {
     if (user_prefs)
       user_prefs->ClearMutableValues();
 #if BUILDFLAG(ENABLE_EXTENSIONS)
-    ExtensionPrefValueMapFactory::GetForBrowserContext(
-        original_context_)->ClearAllIncognitoSessionOnlyPreferences();
+    // The parent's incognito session prefs are shared with its other
+    // ephemeral partitions.
+    if (!IsEphemeral()) {
+      ExtensionPrefValueMapFactory::GetForBrowserContext(
+          original_context_)->ClearAllIncognitoSessionOnlyPreferences();
+    }
 #endif
   }
 
@@ -227,18 +307,29 @@ BraveBrowserContext::~BraveBrowserContext() {
   BrowserContextDependencyManager::GetInstance()->
       DestroyBrowserContextServices(this);
 
-  if (IsOffTheRecord()) {
 #if BUILDFLAG(ENABLE_EXTENSIONS)
+  if (IsEphemeral()) {
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&NotifyEphemeralProfileOnIOThread, false,
+            base::Unretained(original_context_), base::Unretained(this),
+            base::Unretained(original_context_->otr_context_)));
+  } else if (IsOffTheRecord()) {
     BrowserThread::PostTask(
         BrowserThread::IO, FROM_HERE,
         base::Bind(&NotifyOTRProfileDestroyedOnIOThread,
             base::Unretained(original_context_), base::Unretained(this)));
-#endif
   }
+#endif
+  if (IsOffTheRecord() && !IsEphemeral() &&
+      original_context_->otr_context_ == this)
+    original_context_->otr_context_ = nullptr;
 
   g_browser_process->io_thread()->ChangedToOnTheRecord();
 
   ShutdownStoragePartitions();
+
+  atom::PerfCounters::AddToGauge(atom::PerfMetric::PARTITION_COUNT, -1);
 }
 
 // static
@@ -472,14 +563,18 @@ void BraveBrowserContext::CreateProfilePrefs(
     base::FilePath filepath = GetPath().Append(
         FILE_PATH_LITERAL("UserPrefs"));
     scoped_refptr<JsonPrefStore> pref_store = new JsonPrefStore(
-        filepath, io_task_runner, std::unique_ptr<PrefFilter>());
+        filepath, io_task_runner,
+        std::unique_ptr<PrefFilter>(new PerfCountingPrefFilter));
 
     // prepare factory
     sync_preferences::PrefServiceSyncableFactory factory;
     factory.set_async(async);
     factory.set_extension_prefs(extension_prefs);
     factory.set_user_prefs(pref_store);
-    user_prefs_ = factory.CreateSyncable(pref_registry_.get());
+    {
+      atom::ScopedPerfTimer timer(atom::PerfMetric::PREFS_LOAD);
+      user_prefs_ = factory.CreateSyncable(pref_registry_.get());
+    }
     user_prefs::UserPrefs::Set(this, user_prefs_.get());
     if (async) {
       user_prefs_->AddPrefInitObserver(base::Bind(
@@ -520,6 +615,8 @@ void BraveBrowserContext::OnPrefsLoaded(bool success) {
           base::FilePath());
     }
 
+    ProfileReadAhead::DidLoadProfile();
+
     // Initialize autofill db
     base::FilePath webDataPath = GetPath().Append(kWebDataFilename);
 
@@ -67,6 +67,11 @@ class BraveBrowserContext : public Profile {
 
   bool HasParentContext();
 
+  // An in-memory partition created with the ephemeral option only has its own
+  // cookies, storage and cache. Prefs, content settings and extensions come
+  // from the parent partition, changes to them stay in this partition.
+  bool IsEphemeral() const { return is_ephemeral_; }
+
   // content::BrowserContext:
   content::PermissionManager* GetPermissionManager() override;
   content::BackgroundFetchDelegate* GetBackgroundFetchDelegate() override;
@@ -147,6 +152,7 @@ class BraveBrowserContext : public Profile {
   std::unique_ptr<BravePermissionManager> permission_manager_;
 
   bool has_parent_;
+  bool is_ephemeral_;
   BraveBrowserContext* original_context_;
   BraveBrowserContext* otr_context_;
   const std::string partition_;
@@ -16,6 +16,7 @@
 #include "base/strings/utf_string_conversions.h"
 #include "brave/browser/notifications/platform_notification_service_impl.h"
 #include "brave/browser/password_manager/brave_password_manager_client.h"
+#include "brave/browser/subresource_filter/subresource_filter_publisher.h"
 #include "brave/grit/brave_resources.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/cache_stats_recorder.h"
@@ -407,6 +408,9 @@ void BraveContentBrowserClient::RenderProcessWillLaunch(
   extensions_part_->RenderProcessWillLaunch(host);
 #endif
 
+  brave::SubresourceFilterPublisher::GetInstance()->RenderProcessWillLaunch(
+      host);
+
   RendererContentSettingRules rules;
   GetRendererContentSettingRules(
     HostContentSettingsMapFactory::GetForProfile(profile), &rules);
@@ -4,6 +4,12 @@
 
 #include "brave/browser/brave_permission_manager.h"
 
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+#include "atom/common/perf_counters.h"
+#include "base/bind.h"
 #include "content/public/browser/child_process_security_policy.h"
 #include "content/public/browser/permission_type.h"
 #include "content/public/browser/render_frame_host.h"
@@ -43,21 +49,124 @@ void PermissionStatusCallbackWrapper(const base::Callback<void(
 
 }  // namespace
 
+bool BravePermissionManager::DecisionKey::operator<(
+    const DecisionKey& other) const {
+  return std::tie(permission, requesting_origin, embedding_origin) <
+      std::tie(other.permission, other.requesting_origin,
+               other.embedding_origin);
+}
+
 BravePermissionManager::BravePermissionManager()
-    : request_id_(0) {
+    : request_id_(0),
+      subscription_id_(0) {
 }
 
 BravePermissionManager::~BravePermissionManager() {
 }
 
 void BravePermissionManager::SetPermissionRequestHandler(
-    const RequestHandler& handler) {
+    const RequestHandler& handler,
+    base::TimeDelta decision_ttl) {
   if (handler.is_null() && !pending_requests_.empty()) {
     for (const auto& request : pending_requests_)
       CancelPermissionRequest(request.first);
     pending_requests_.clear();
   }
   request_handler_ = handler;
+  decision_ttl_ = decision_ttl;
+
+  // The decisions were made by the old handler.
+  decisions_.clear();
+  ScheduleDecisionExpiry();
+  NotifyDecisionsChanged();
+}
+
+void BravePermissionManager::ClearPermissionDecisions(
+    const GURL& requesting_origin) {
+  GURL origin = requesting_origin.GetOrigin();
+  for (auto it = decisions_.begin(); it != decisions_.end();) {
+    if (origin.is_empty() || it->first.requesting_origin == origin)
+      it = decisions_.erase(it);
+    else
+      ++it;
+  }
+  ScheduleDecisionExpiry();
+  NotifyDecisionsChanged();
+}
+
+bool BravePermissionManager::GetCachedDecisions(
+    const std::vector<content::PermissionType>& permissions,
+    const GURL& requesting_origin,
+    const GURL& embedding_origin,
+    std::vector<blink::mojom::PermissionStatus>* statuses) const {
+  if (decisions_.empty())
+    return false;
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (auto permission : permissions) {
+    auto it = decisions_.find(
+        {permission, requesting_origin, embedding_origin});
+    if (it == decisions_.end() || it->second.expiry <= now)
+      return false;
+    statuses->push_back(it->second.status);
+  }
+  return true;
+}
+
+blink::mojom::PermissionStatus BravePermissionManager::GetDecision(
+    const DecisionKey& key) const {
+  auto it = decisions_.find(key);
+  if (it == decisions_.end() || it->second.expiry <= base::TimeTicks::Now())
+    return blink::mojom::PermissionStatus::GRANTED;
+  return it->second.status;
+}
+
+void BravePermissionManager::NotifyDecisionsChanged() {
+  // Callbacks may unsubscribe, so collect the changes first.
+  std::vector<std::pair<base::Callback<void(blink::mojom::PermissionStatus)>,
+                        blink::mojom::PermissionStatus>> changes;
+  for (auto& subscription : subscriptions_) {
+    auto status = GetDecision(subscription.second.key);
+    if (status == subscription.second.status)
+      continue;
+    subscription.second.status = status;
+    changes.push_back(std::make_pair(subscription.second.callback, status));
+  }
+  for (const auto& change : changes)
+    change.first.Run(change.second);
+}
+
+void BravePermissionManager::PruneExpiredDecisions() {
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (auto it = decisions_.begin(); it != decisions_.end();) {
+    if (it->second.expiry <= now)
+      it = decisions_.erase(it);
+    else
+      ++it;
+  }
+}
+
+void BravePermissionManager::ScheduleDecisionExpiry() {
+  if (decisions_.empty()) {
+    expiry_timer_.Stop();
+    return;
+  }
+
+  base::TimeTicks expiry = decisions_.begin()->second.expiry;
+  for (const auto& decision : decisions_)
+    expiry = std::min(expiry, decision.second.expiry);
+  expiry_timer_.Start(
+      FROM_HERE,
+      std::max(expiry - base::TimeTicks::Now(), base::TimeDelta()),
+      base::Bind(&BravePermissionManager::OnDecisionsExpired,
+                 base::Unretained(this)));
+}
+
+void BravePermissionManager::OnDecisionsExpired() {
+  // Subscribers see the default status again once a decision expires.
+  PruneExpiredDecisions();
+  ScheduleDecisionExpiry();
+  NotifyDecisionsChanged();
 }
 
 int BravePermissionManager::RequestPermission(
@@ -105,14 +214,27 @@ int BravePermissionManager::RequestPermissions(
   }
 
   if (!request_handler_.is_null()) {
+    GURL embedding_origin = url.GetOrigin();
+    if (!decision_ttl_.is_zero()) {
+      std::vector<blink::mojom::PermissionStatus> cached_statuses;
+      if (GetCachedDecisions(permissions, requesting_origin.GetOrigin(),
+                             embedding_origin, &cached_statuses)) {
+        atom::PerfCounters::Increment(atom::PerfMetric::PERMISSION_CACHE_HIT);
+        response_callback.Run(cached_statuses);
+        return kNoPendingOperation;
+      }
+      atom::PerfCounters::Increment(atom::PerfMetric::PERMISSION_CACHE_MISS);
+    }
+
     ++request_id_;
     auto callback = base::Bind(&BravePermissionManager::OnPermissionResponse,
                                base::Unretained(this),
                                request_id_,
                                requesting_origin,
                                response_callback);
-    pending_requests_[request_id_] =
-        { render_process_id, render_frame_id, callback, permissions.size() };
+    pending_requests_[request_id_] = { render_process_id, render_frame_id,
+                                       callback, permissions,
+                                       embedding_origin, false };
     request_handler_.Run(requesting_origin, url, permissions, callback);
     return request_id_;
   }
@@ -128,11 +250,26 @@ void BravePermissionManager::OnPermissionResponse(
     const std::vector<blink::mojom::PermissionStatus>& status) {
   auto request = pending_requests_.find(request_id);
   if (request != pending_requests_.end()) {
-    if (!WebContentsDestroyed(
-        request->second.render_process_id, request->second.render_frame_id)) {
+    const RequestInfo& info = request->second;
+    bool cache = !decision_ttl_.is_zero() && !info.canceled &&
+        status.size() == info.permissions.size();
+    if (cache) {
+      PruneExpiredDecisions();
+      base::TimeTicks expiry = base::TimeTicks::Now() + decision_ttl_;
+      for (size_t i = 0; i < status.size(); i++) {
+        decisions_[{info.permissions[i], origin.GetOrigin(),
+                    info.embedding_origin}] = {status[i], expiry};
+      }
+      ScheduleDecisionExpiry();
+    }
+
+    if (!WebContentsDestroyed(info.render_process_id, info.render_frame_id)) {
       callback.Run(status);
     }
     pending_requests_.erase(request);
+
+    if (cache)
+      NotifyDecisionsChanged();
   }
 }
 
@@ -142,7 +279,8 @@ void BravePermissionManager::CancelPermissionRequest(int request_id) {
     if (!WebContentsDestroyed(
         request->second.render_process_id, request->second.render_frame_id)) {
       std::vector<blink::mojom::PermissionStatus> permissionStatuses;
-      for (size_t i = 0; i < request->second.size; i++) {
+      request->second.canceled = true;
+      for (size_t i = 0; i < request->second.permissions.size(); i++) {
         permissionStatuses.push_back(blink::mojom::PermissionStatus::DENIED);
       }
       request->second.callback.Run(permissionStatuses);
@@ -158,13 +296,19 @@ void BravePermissionManager::ResetPermission(
     content::PermissionType permission,
     const GURL& requesting_origin,
     const GURL& embedding_origin) {
+  if (decisions_.erase({permission, requesting_origin.GetOrigin(),
+                        embedding_origin.GetOrigin()})) {
+    ScheduleDecisionExpiry();
+    NotifyDecisionsChanged();
+  }
 }
 
 blink::mojom::PermissionStatus BravePermissionManager::GetPermissionStatus(
     content::PermissionType permission,
     const GURL& requesting_origin,
     const GURL& embedding_origin) {
-  return blink::mojom::PermissionStatus::GRANTED;
+  return GetDecision({permission, requesting_origin.GetOrigin(),
+                      embedding_origin.GetOrigin()});
 }
 
 int BravePermissionManager::SubscribePermissionStatusChange(
@@ -172,11 +316,15 @@ int BravePermissionManager::SubscribePermissionStatusChange(
     const GURL& requesting_origin,
     const GURL& embedding_origin,
     const base::Callback<void(blink::mojom::PermissionStatus)>& callback) {
-  return -1;
+  DecisionKey key = {permission, requesting_origin.GetOrigin(),
+                     embedding_origin.GetOrigin()};
+  subscriptions_[++subscription_id_] = {key, callback, GetDecision(key)};
+  return subscription_id_;
 }
 
 void BravePermissionManager::UnsubscribePermissionStatusChange(
     int subscription_id) {
+  subscriptions_.erase(subscription_id);
 }
 
 }  // namespace brave
@@ -9,7 +9,10 @@
 #include <vector>
 
 #include "base/callback.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "content/public/browser/permission_manager.h"
+#include "url/gurl.h"
 
 namespace content {
 class WebContents;
@@ -30,8 +33,14 @@ class BravePermissionManager : public content::PermissionManager {
                       const std::vector<content::PermissionType>& permissions,
                       const ResponseCallback&)>;
 
-  // Handler to dispatch permission requests in JS.
-  void SetPermissionRequestHandler(const RequestHandler& handler);
+  // Handler to dispatch permission requests in JS. Its decisions are reused
+  // for |decision_ttl| without asking it again, a zero ttl disables that.
+  void SetPermissionRequestHandler(const RequestHandler& handler,
+                                   base::TimeDelta decision_ttl);
+
+  // Forgets the decisions of the request handler for |requesting_origin|, or
+  // all of them if it is empty.
+  void ClearPermissionDecisions(const GURL& requesting_origin);
 
   // content::PermissionManager:
   int RequestPermission(
@@ -77,15 +86,64 @@ class BravePermissionManager : public content::PermissionManager {
     int render_process_id;
     int render_frame_id;
     ResponseCallback callback;
-    size_t size;
+    std::vector<content::PermissionType> permissions;
+    GURL embedding_origin;
+    // Denials of canceled requests aren't decisions of the handler.
+    bool canceled;
   };
 
+  // Decisions are per session since each browser context has its own
+  // permission manager.
+  struct DecisionKey {
+    content::PermissionType permission;
+    GURL requesting_origin;
+    GURL embedding_origin;
+
+    bool operator<(const DecisionKey& other) const;
+  };
+
+  struct Decision {
+    blink::mojom::PermissionStatus status;
+    base::TimeTicks expiry;
+  };
+
+  struct Subscription {
+    DecisionKey key;
+    base::Callback<void(blink::mojom::PermissionStatus)> callback;
+    blink::mojom::PermissionStatus status;
+  };
+
+  // Returns false unless every permission has an unexpired decision.
+  bool GetCachedDecisions(
+      const std::vector<content::PermissionType>& permissions,
+      const GURL& requesting_origin,
+      const GURL& embedding_origin,
+      std::vector<blink::mojom::PermissionStatus>* statuses) const;
+
+  // Permissions without an unexpired decision are granted.
+  blink::mojom::PermissionStatus GetDecision(const DecisionKey& key) const;
+
+  // Runs the subscriptions whose status changed.
+  void NotifyDecisionsChanged();
+
+  void PruneExpiredDecisions();
+  // Starts |expiry_timer_| for the decision that expires first.
+  void ScheduleDecisionExpiry();
+  void OnDecisionsExpired();
+
   RequestHandler request_handler_;
 
   std::map<int, RequestInfo> pending_requests_;
 
   int request_id_;
 
+  base::TimeDelta decision_ttl_;
+  std::map<DecisionKey, Decision> decisions_;
+  base::OneShotTimer expiry_timer_;
+
+  std::map<int, Subscription> subscriptions_;
+  int subscription_id_;
+
   DISALLOW_COPY_AND_ASSIGN(BravePermissionManager);
 };
 
@@ -260,6 +260,9 @@ void TabViewGuest::CreateWebContents(
       partition_options.SetString("parent_partition", "");
     }
   }
+  bool ephemeral = false;
+  if (params.GetBoolean("ephemeral", &ephemeral))
+    partition_options.SetBoolean("ephemeral", ephemeral);
   atom::AtomBrowserContext* browser_context =
       brave::BraveBrowserContext::FromPartition(partition, partition_options);
 
@@ -273,6 +276,11 @@ void TabViewGuest::CreateWebContents(
   callback.Run(web_contents);
 }
 
+void TabViewGuest::Adopt(const base::DictionaryValue& create_params) {
+  DCHECK(!attached());
+  ApplyAttributes(create_params);
+}
+
 void TabViewGuest::ApplyAttributes(const base::DictionaryValue& params) {
   bool is_pending_new_window = false;
   if (GetOpener()) {
@@ -34,6 +34,14 @@ class TabViewGuest : public guest_view::GuestView<TabViewGuest> {
 
   void Load();
 
+  // Applies the params of a new tab to a guest created ahead of time by
+  // TabViewGuestPool.
+  void Adopt(const base::DictionaryValue& create_params);
+
+  atom::api::WebContents* api_web_contents() const {
+    return api_web_contents_;
+  }
+
  private:
   explicit TabViewGuest(content::WebContents* owner_web_contents);
 
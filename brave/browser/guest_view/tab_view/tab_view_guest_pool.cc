@@ -0,0 +1,209 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/guest_view/tab_view/tab_view_guest_pool.h"
+
+#include <algorithm>
+
+#include "atom/common/options_switches.h"
+#include "atom/common/perf_counters.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/memory/singleton.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
+#include "brave/browser/guest_view/tab_view/tab_view_guest.h"
+#include "components/guest_view/browser/guest_view_manager.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/web_contents.h"
+
+using content::BrowserThread;
+using guest_view::GuestViewBase;
+using guest_view::GuestViewManager;
+
+namespace brave {
+
+namespace {
+
+// Gives the tab that emptied the pool time to load before its replacement
+// starts another renderer.
+const int kRefillDelaySeconds = 3;
+
+// The params of a tab that only picks a partition and a url.
+bool IsPlainTab(const base::DictionaryValue& create_params) {
+  for (base::DictionaryValue::Iterator it(create_params); !it.IsAtEnd();
+       it.Advance()) {
+    if (it.key() != "partition" && it.key() != "parent_partition" &&
+        it.key() != "ephemeral" && it.key() != "src")
+      return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+TabViewGuestPool::Pool::Pool()
+    : owner_process_id(0),
+      owner_frame_id(MSG_ROUTING_NONE),
+      refill_pending(false) {}
+
+TabViewGuestPool::Pool::~Pool() {}
+
+// static
+TabViewGuestPool* TabViewGuestPool::GetInstance() {
+  return base::Singleton<TabViewGuestPool>::get();
+}
+
+TabViewGuestPool::TabViewGuestPool()
+    : pool_size_(0),
+      weak_factory_(this) {
+  int pool_size = 0;
+  if (base::StringToInt(
+          base::CommandLine::ForCurrentProcess()->GetSwitchValueASCII(
+              atom::switches::kGuestPoolSize),
+          &pool_size) && pool_size > 0) {
+    pool_size_ = static_cast<size_t>(pool_size);
+    memory_pressure_listener_.reset(new base::MemoryPressureListener(
+        base::Bind(&TabViewGuestPool::OnMemoryPressure,
+                   base::Unretained(this))));
+  }
+}
+
+TabViewGuestPool::~TabViewGuestPool() {}
+
+content::WebContents* TabViewGuestPool::Take(
+    content::WebContents* owner,
+    content::BrowserContext* browser_context,
+    const base::DictionaryValue& create_params) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!pool_size_ || !IsPlainTab(create_params))
+    return nullptr;
+
+  std::string partition;
+  create_params.GetString("partition", &partition);
+  std::unique_ptr<Pool>& pool = pools_[partition];
+  if (!pool)
+    pool.reset(new Pool);
+
+  pool->create_params.Clear();
+  pool->create_params.SetString("partition", partition);
+  std::string parent_partition;
+  if (create_params.GetString("parent_partition", &parent_partition))
+    pool->create_params.SetString("parent_partition", parent_partition);
+  bool ephemeral = false;
+  if (create_params.GetBoolean("ephemeral", &ephemeral))
+    pool->create_params.SetBoolean("ephemeral", ephemeral);
+  pool->owner_process_id = owner->GetMainFrame()->GetProcess()->GetID();
+  pool->owner_frame_id = owner->GetMainFrame()->GetRoutingID();
+
+  TabViewGuest* guest = nullptr;
+  while (!guest && !pool->guests.empty()) {
+    GuestViewBase* pooled = pool->guests.front().get();
+    pool->guests.pop_front();
+    atom::PerfCounters::AddToGauge(atom::PerfMetric::GUEST_POOL_SIZE, -1);
+    if (pooled && pooled->web_contents() &&
+        pooled->web_contents()->GetBrowserContext() == browser_context)
+      guest = static_cast<TabViewGuest*>(pooled);
+  }
+
+  if (!pool->refill_pending) {
+    pool->refill_pending = true;
+    base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&TabViewGuestPool::Refill, weak_factory_.GetWeakPtr(),
+                   partition),
+        base::TimeDelta::FromSeconds(kRefillDelaySeconds));
+  }
+
+  if (!guest) {
+    atom::PerfCounters::Increment(atom::PerfMetric::GUEST_POOL_MISS);
+    return nullptr;
+  }
+
+  atom::PerfCounters::Increment(atom::PerfMetric::GUEST_POOL_HIT);
+  guest->Adopt(create_params);
+  return guest->web_contents();
+}
+
+void TabViewGuestPool::Refill(const std::string& partition) {
+  TRACE_EVENT0("browser", "TabViewGuestPool::Refill");
+  auto it = pools_.find(partition);
+  if (it == pools_.end())
+    return;
+  Pool* pool = it->second.get();
+  pool->refill_pending = false;
+
+  auto rfh = content::RenderFrameHost::FromID(pool->owner_process_id,
+                                              pool->owner_frame_id);
+  content::WebContents* owner =
+      rfh ? content::WebContents::FromRenderFrameHost(rfh) : nullptr;
+  if (!owner || owner->IsBeingDestroyed())
+    return;
+
+  auto guest_view_manager = static_cast<GuestViewManager*>(
+      owner->GetBrowserContext()->GetGuestManager());
+  if (!guest_view_manager)
+    return;
+
+  auto destroyed =
+      std::remove_if(pool->guests.begin(), pool->guests.end(),
+                     [](const base::WeakPtr<GuestViewBase>& guest) {
+                       return !guest;
+                     });
+  atom::PerfCounters::AddToGauge(
+      atom::PerfMetric::GUEST_POOL_SIZE,
+      -static_cast<int>(pool->guests.end() - destroyed));
+  pool->guests.erase(destroyed, pool->guests.end());
+
+  for (size_t i = pool->guests.size(); i < pool_size_; ++i) {
+    guest_view_manager->CreateGuest(
+        TabViewGuest::Type, owner, pool->create_params,
+        base::Bind(&TabViewGuestPool::OnGuestCreated,
+                   weak_factory_.GetWeakPtr(), partition));
+  }
+}
+
+void TabViewGuestPool::OnGuestCreated(
+    const std::string& partition,
+    content::WebContents* guest_web_contents) {
+  if (!guest_web_contents)
+    return;
+
+  TabViewGuest* guest = TabViewGuest::FromWebContents(guest_web_contents);
+  if (!guest)
+    return;
+
+  // Start the renderer now instead of on the first navigation.
+  guest_web_contents->GetMainFrame()->GetProcess()->Init();
+
+  std::unique_ptr<Pool>& pool = pools_[partition];
+  if (!pool)
+    pool.reset(new Pool);
+  pool->guests.push_back(guest->weak_ptr());
+  atom::PerfCounters::AddToGauge(atom::PerfMetric::GUEST_POOL_SIZE, 1);
+}
+
+void TabViewGuestPool::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  if (memory_pressure_level ==
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE)
+    return;
+
+  for (auto& pool : pools_) {
+    for (const auto& guest : pool.second->guests) {
+      if (guest)
+        guest->Destroy(true);
+    }
+    atom::PerfCounters::AddToGauge(
+        atom::PerfMetric::GUEST_POOL_SIZE,
+        -static_cast<int>(pool.second->guests.size()));
+    pool.second->guests.clear();
+  }
+}
+
+}  // namespace brave
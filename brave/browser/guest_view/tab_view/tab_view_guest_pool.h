@@ -0,0 +1,91 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_GUEST_VIEW_TAB_VIEW_TAB_VIEW_GUEST_POOL_H_
+#define BRAVE_BROWSER_GUEST_VIEW_TAB_VIEW_TAB_VIEW_GUEST_POOL_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/weak_ptr.h"
+#include "base/values.h"
+
+namespace base {
+template <typename T>
+struct DefaultSingletonTraits;
+}
+
+namespace content {
+class BrowserContext;
+class WebContents;
+}
+
+namespace guest_view {
+class GuestViewBase;
+}
+
+namespace brave {
+
+// Keeps up to --guest-pool-size unattached tab guests per partition, with
+// their renderer process already started, so opening a tab doesn't wait for a
+// new renderer.
+//
+// Pools are filled for the partitions tabs are opened in, a while after a tab
+// was opened so the refill doesn't compete with it, and emptied under memory
+// pressure. Pooled guests belong to the owner of the tab that triggered the
+// refill and are destroyed with it like any other unattached guest.
+class TabViewGuestPool {
+ public:
+  static TabViewGuestPool* GetInstance();
+
+  // Returns a pooled guest for a tab created with |create_params| in
+  // |browser_context|, with the params applied to it. Returns nullptr if
+  // there is none, or the params need a new guest, and schedules a refill.
+  content::WebContents* Take(content::WebContents* owner,
+                             content::BrowserContext* browser_context,
+                             const base::DictionaryValue& create_params);
+
+ private:
+  friend struct base::DefaultSingletonTraits<TabViewGuestPool>;
+
+  struct Pool {
+    Pool();
+    ~Pool();
+
+    std::deque<base::WeakPtr<guest_view::GuestViewBase>> guests;
+    // The partition params guests are created with.
+    base::DictionaryValue create_params;
+    // The main frame of the last owner, guests are created for it.
+    int owner_process_id;
+    int owner_frame_id;
+    bool refill_pending;
+  };
+
+  TabViewGuestPool();
+  ~TabViewGuestPool();
+
+  void Refill(const std::string& partition);
+  void OnGuestCreated(const std::string& partition,
+                      content::WebContents* guest_web_contents);
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
+  size_t pool_size_;
+
+  std::map<std::string, std::unique_ptr<Pool>> pools_;
+
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  base::WeakPtrFactory<TabViewGuestPool> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(TabViewGuestPool);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_GUEST_VIEW_TAB_VIEW_TAB_VIEW_GUEST_POOL_H_
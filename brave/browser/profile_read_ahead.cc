@@ -0,0 +1,92 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/profile_read_ahead.h"
+
+#include <memory>
+
+#include "atom/common/options_switches.h"
+#include "atom/common/perf_counters.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/time/time.h"
+#include "base/trace_event/trace_event.h"
+#include "components/webdata/common/webdata_constants.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace brave {
+
+namespace {
+
+// Files read by BraveBrowserContext::CreateProfilePrefs and OnPrefsLoaded.
+const base::FilePath::CharType* const kProfileFiles[] = {
+  FILE_PATH_LITERAL("UserPrefs"),
+  kWebDataFilename,
+};
+
+const int kChunkSize = 1 << 20;
+// Larger files are only partly read ahead.
+const int64_t kMaxReadAheadSize = 64 << 20;
+
+base::TimeTicks g_start_time;
+
+void ReadAheadFile(const base::FilePath& path, char* buffer) {
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ |
+                            base::File::FLAG_SEQUENTIAL_SCAN);
+  if (!file.IsValid())
+    return;
+
+  int64_t offset = 0;
+  while (offset < kMaxReadAheadSize) {
+    int read = file.Read(offset, buffer, kChunkSize);
+    if (read <= 0)
+      break;
+    offset += read;
+  }
+}
+
+void ReadAheadProfile(const base::FilePath& profile_path) {
+  TRACE_EVENT0("startup", "ProfileReadAhead::ReadAheadProfile");
+  std::unique_ptr<char[]> buffer(new char[kChunkSize]);
+  for (const base::FilePath::CharType* file : kProfileFiles)
+    ReadAheadFile(profile_path.Append(file), buffer.get());
+}
+
+}  // namespace
+
+// static
+void ProfileReadAhead::Start(const base::FilePath& profile_path) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  g_start_time = base::TimeTicks::Now();
+
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          atom::switches::kDisableProfileReadAhead))
+    return;
+
+  base::PostTaskWithTraits(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::USER_BLOCKING,
+       base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN},
+      base::Bind(&ReadAheadProfile, profile_path));
+}
+
+// static
+void ProfileReadAhead::DidLoadProfile() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (g_start_time.is_null())
+    return;
+
+  base::TimeDelta time = base::TimeTicks::Now() - g_start_time;
+  g_start_time = base::TimeTicks();
+  UMA_HISTOGRAM_TIMES("Startup.ProfileReady", time);
+  atom::PerfCounters::AddTime(atom::PerfMetric::STARTUP_PROFILE_READY, time);
+}
+
+}  // namespace brave
@@ -0,0 +1,40 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_PROFILE_READ_AHEAD_H_
+#define BRAVE_BROWSER_PROFILE_READ_AHEAD_H_
+
+#include "base/macros.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace brave {
+
+// Reads the default profile's prefs and web data files on a background
+// sequence while the JS environment boots, so the synchronous prefs load and
+// the database opens that follow find them in the OS cache.
+//
+// The default profile itself can't be created that early since the app's
+// main script may still change the user data directory, reading ahead the
+// wrong directory only costs some background I/O.
+class ProfileReadAhead {
+ public:
+  // Starts reading the files of the profile in |profile_path| unless
+  // --disable-profile-read-ahead is set. Either way, the time until
+  // the first DidLoadProfile is recorded as startup.profileReady.
+  static void Start(const base::FilePath& profile_path);
+
+  // Called when a persistent profile has loaded its prefs, only the first
+  // call is recorded.
+  static void DidLoadProfile();
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(ProfileReadAhead);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_PROFILE_READ_AHEAD_H_
@@ -0,0 +1,356 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/resource_coordinator/guest_tab_discard_policy.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "atom/browser/api/atom_api_web_contents.h"
+#include "atom/browser/extensions/tab_helper.h"
+#include "base/process/process_metrics.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/values.h"
+#include "brave/browser/guest_view/tab_view/tab_view_guest.h"
+#include "build/build_config.h"
+#include "chrome/browser/browser_process.h"
+#include "chrome/browser/resource_coordinator/tab_manager.h"
+#include "chrome/browser/ui/tab_contents/tab_contents_iterator.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/web_contents.h"
+
+#if defined(OS_MACOSX)
+#include "content/public/browser/browser_child_process_host.h"
+#endif
+
+using content::BrowserThread;
+using content::WebContents;
+
+namespace resource_coordinator {
+
+namespace {
+
+const char kEnabledKey[] = "enabled";
+const char kMemoryBudgetKey[] = "memoryBudget";
+const char kMinInactiveTimeKey[] = "minInactiveTime";
+const char kSampleIntervalKey[] = "sampleInterval";
+const char kMaxDiscardsOnCriticalKey[] = "maxDiscardsOnCritical";
+
+const char kReasonBudget[] = "memory-budget";
+const char kReasonModeratePressure[] = "memory-pressure-moderate";
+const char kReasonCriticalPressure[] = "memory-pressure-critical";
+
+// How many minutes of inactivity one MB of renderer private memory is worth
+// when ranking tabs. A 100MB tab idle for 10 minutes ranks with a 10MB tab
+// idle for an hour.
+const double kMinutesPerMegabyte = 0.5;
+
+double ScoreTab(base::TimeDelta inactive_time, size_t private_kb) {
+  return inactive_time.InSecondsF() / 60 +
+      (private_kb / 1024.0) * kMinutesPerMegabyte;
+}
+
+}  // namespace
+
+GuestTabDiscardPolicy::Options::Options()
+    : enabled(false),
+      memory_budget_kb(0),
+      min_inactive_time(base::TimeDelta::FromMinutes(10)),
+      sample_interval(base::TimeDelta::FromSeconds(30)),
+      max_discards_on_critical(5) {}
+
+GuestTabDiscardPolicy::Candidate::Candidate()
+    : tab_id(-1),
+      handle(base::kNullProcessHandle),
+      discardable(false),
+      private_kb(0),
+      score(0) {}
+
+GuestTabDiscardPolicy::GuestTabDiscardPolicy()
+    : measuring_(false),
+      pending_max_discards_(0),
+      weak_ptr_factory_(this) {}
+
+GuestTabDiscardPolicy::~GuestTabDiscardPolicy() {}
+
+void GuestTabDiscardPolicy::SetOptions(const base::DictionaryValue& options) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  options.GetBoolean(kEnabledKey, &options_.enabled);
+
+  int value = 0;
+  if (options.GetInteger(kMemoryBudgetKey, &value))
+    options_.memory_budget_kb = std::max(value, 0);
+  if (options.GetInteger(kMinInactiveTimeKey, &value))
+    options_.min_inactive_time = base::TimeDelta::FromMilliseconds(value);
+  if (options.GetInteger(kSampleIntervalKey, &value) && value > 0)
+    options_.sample_interval = base::TimeDelta::FromMilliseconds(value);
+  if (options.GetInteger(kMaxDiscardsOnCriticalKey, &value))
+    options_.max_discards_on_critical = std::max(value, 1);
+
+  UpdateListeners();
+}
+
+std::unique_ptr<base::DictionaryValue>
+GuestTabDiscardPolicy::GetOptions() const {
+  std::unique_ptr<base::DictionaryValue> options(new base::DictionaryValue);
+  options->SetBoolean(kEnabledKey, options_.enabled);
+  options->SetInteger(kMemoryBudgetKey,
+      static_cast<int>(options_.memory_budget_kb));
+  options->SetInteger(kMinInactiveTimeKey,
+      options_.min_inactive_time.InMilliseconds());
+  options->SetInteger(kSampleIntervalKey,
+      options_.sample_interval.InMilliseconds());
+  options->SetInteger(kMaxDiscardsOnCriticalKey,
+      options_.max_discards_on_critical);
+  return options;
+}
+
+void GuestTabDiscardPolicy::UpdateListeners() {
+  if (!options_.enabled) {
+    memory_pressure_listener_.reset();
+    sample_timer_.Stop();
+    return;
+  }
+
+  if (!memory_pressure_listener_) {
+    memory_pressure_listener_.reset(new base::MemoryPressureListener(
+        base::Bind(&GuestTabDiscardPolicy::OnMemoryPressure,
+                   base::Unretained(this))));
+  }
+
+  if (options_.memory_budget_kb > 0) {
+    sample_timer_.Start(FROM_HERE, options_.sample_interval,
+        base::Bind(&GuestTabDiscardPolicy::OnSampleTimer,
+                   base::Unretained(this)));
+  } else {
+    sample_timer_.Stop();
+  }
+}
+
+void GuestTabDiscardPolicy::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  int max_discards = 0;
+  std::string reason;
+  switch (level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      reason = kReasonModeratePressure;
+      max_discards = 1;
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      reason = kReasonCriticalPressure;
+      max_discards = options_.max_discards_on_critical;
+      break;
+    default:
+      return;
+  }
+
+  // Handled once the measurement in flight is done, keeping the most severe
+  // signal
+  if (measuring_) {
+    if (max_discards > pending_max_discards_) {
+      pending_reason_ = reason;
+      pending_max_discards_ = max_discards;
+    }
+    return;
+  }
+
+  Measure(reason, max_discards, base::TaskPriority::USER_VISIBLE);
+}
+
+void GuestTabDiscardPolicy::OnSampleTimer() {
+  if (measuring_)
+    return;
+
+  Measure(kReasonBudget, 0, base::TaskPriority::BACKGROUND);
+}
+
+void GuestTabDiscardPolicy::Measure(const std::string& reason,
+                                    int max_discards,
+                                    base::TaskPriority priority) {
+  measuring_ = true;
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), priority},
+      base::Bind(&GuestTabDiscardPolicy::MeasureMemory, GetCandidates()),
+      base::Bind(&GuestTabDiscardPolicy::OnMemoryMeasured,
+                 weak_ptr_factory_.GetWeakPtr(), reason, max_discards));
+}
+
+GuestTabDiscardPolicy::Candidates
+GuestTabDiscardPolicy::GetCandidates() const {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  TabManager* tab_manager = g_browser_process->GetTabManager();
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  Candidates candidates;
+  for (TabContentsIterator it; !it.done(); it.Next()) {
+    WebContents* contents = *it;
+    auto tab_helper = extensions::TabHelper::FromWebContents(contents);
+    if (!tab_helper)
+      continue;
+
+    content::RenderProcessHost* host = contents->GetMainFrame()->GetProcess();
+    if (!host || host->GetHandle() == base::kNullProcessHandle)
+      continue;
+
+    Candidate candidate;
+    candidate.tab_id = tab_helper->session_id();
+    candidate.handle = host->GetHandle();
+    candidate.inactive_time = now - contents->GetLastActiveTime();
+    candidate.discardable =
+        !tab_helper->is_placeholder() &&
+        !tab_helper->is_active() &&
+        !tab_helper->is_pinned() &&
+        !tab_helper->IsDiscarded() &&
+        !contents->WasRecentlyAudible() &&
+        tab_manager->IsTabAutoDiscardable(contents) &&
+        candidate.inactive_time >= options_.min_inactive_time;
+    candidates.push_back(candidate);
+  }
+  return candidates;
+}
+
+// static
+size_t GuestTabDiscardPolicy::GetPrivateMemoryKB(base::ProcessHandle handle) {
+#if defined(OS_MACOSX)
+  std::unique_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          handle, content::BrowserChildProcessHost::GetPortProvider()));
+  size_t private_bytes = 0;
+  if (!metrics->GetMemoryBytes(&private_bytes, nullptr))
+    return 0;
+  return private_bytes / 1024;
+#else
+  std::unique_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(handle));
+  base::WorkingSetKBytes ws_usage;
+  if (!metrics->GetWorkingSetKBytes(&ws_usage))
+    return 0;
+  return ws_usage.priv;
+#endif
+}
+
+// static
+GuestTabDiscardPolicy::Candidates GuestTabDiscardPolicy::MeasureMemory(
+    Candidates candidates) {
+  // Tabs can share a renderer so measure each process once and split its
+  // private memory evenly between the tabs it hosts.
+  std::map<base::ProcessHandle, std::pair<size_t, int>> processes;
+  for (const auto& candidate : candidates)
+    processes[candidate.handle].second++;
+
+  for (auto& process : processes)
+    process.second.first = GetPrivateMemoryKB(process.first);
+
+  for (auto& candidate : candidates) {
+    const auto& process = processes[candidate.handle];
+    candidate.private_kb = process.first / process.second;
+    candidate.score = ScoreTab(candidate.inactive_time, candidate.private_kb);
+  }
+  return candidates;
+}
+
+void GuestTabDiscardPolicy::OnMemoryMeasured(const std::string& reason,
+                                             int max_discards,
+                                             Candidates candidates) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  measuring_ = false;
+
+  if (!options_.enabled) {
+    pending_reason_.clear();
+    pending_max_discards_ = 0;
+    return;
+  }
+
+  ApplyMeasurement(reason, max_discards, std::move(candidates));
+
+  // Pressure reported while measuring is applied to a fresh measurement,
+  // the tabs discarded above are gone from it
+  if (!pending_reason_.empty()) {
+    std::string pending_reason;
+    pending_reason.swap(pending_reason_);
+    int pending_max_discards = pending_max_discards_;
+    pending_max_discards_ = 0;
+    Measure(pending_reason, pending_max_discards,
+            base::TaskPriority::USER_VISIBLE);
+  }
+}
+
+void GuestTabDiscardPolicy::ApplyMeasurement(const std::string& reason,
+                                             int max_discards,
+                                             Candidates candidates) {
+  size_t total_private_kb = 0;
+  for (const auto& candidate : candidates)
+    total_private_kb += candidate.private_kb;
+
+  size_t excess_kb = 0;
+  if (options_.memory_budget_kb > 0 &&
+      total_private_kb > options_.memory_budget_kb)
+    excess_kb = total_private_kb - options_.memory_budget_kb;
+
+  // The budget sample only acts when the budget is actually exceeded
+  if (reason == kReasonBudget && excess_kb == 0)
+    return;
+
+  candidates.erase(
+      std::remove_if(candidates.begin(), candidates.end(),
+          [](const Candidate& candidate) { return !candidate.discardable; }),
+      candidates.end());
+  std::sort(candidates.begin(), candidates.end(),
+      [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+
+  int discards = 0;
+  size_t freed_kb = 0;
+  for (const auto& candidate : candidates) {
+    if (reason == kReasonBudget) {
+      if (freed_kb >= excess_kb)
+        break;
+    } else if (discards >= max_discards) {
+      break;
+    }
+
+    if (DiscardCandidate(candidate, reason, total_private_kb)) {
+      discards++;
+      freed_kb += candidate.private_kb;
+    }
+  }
+}
+
+bool GuestTabDiscardPolicy::DiscardCandidate(const Candidate& candidate,
+                                             const std::string& reason,
+                                             size_t total_private_kb) {
+  // The tab may have been closed, activated or detached from its guest while
+  // memory was measured
+  WebContents* contents =
+      extensions::TabHelper::GetTabById(candidate.tab_id);
+  if (!contents)
+    return false;
+
+  auto tab_helper = extensions::TabHelper::FromWebContents(contents);
+  if (!tab_helper || !tab_helper->guest() || tab_helper->is_active() ||
+      tab_helper->IsDiscarded())
+    return false;
+
+  base::DictionaryValue details;
+  details.SetString("reason", reason);
+  details.SetDouble("score", candidate.score);
+  details.SetDouble("inactiveTime", candidate.inactive_time.InMillisecondsF());
+  details.SetInteger("privateMemory", static_cast<int>(candidate.private_kb));
+  details.SetInteger("totalPrivateMemory",
+      static_cast<int>(total_private_kb));
+  details.SetInteger("memoryBudget",
+      static_cast<int>(options_.memory_budget_kb));
+
+  auto api_web_contents = tab_helper->guest()->api_web_contents();
+  if (!api_web_contents)
+    return tab_helper->Discard();
+
+  return api_web_contents->AutoDiscard(details);
+}
+
+}  // namespace resource_coordinator
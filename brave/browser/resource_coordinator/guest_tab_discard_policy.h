@@ -0,0 +1,109 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_DISCARD_POLICY_H_
+#define BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_DISCARD_POLICY_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/weak_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/task_scheduler/task_traits.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace resource_coordinator {
+
+// Ranks tab-view guests by how cheap they are to lose and discards the
+// cheapest ones when the system reports memory pressure or when the renderers
+// hosting tabs grow past a configurable budget.
+class GuestTabDiscardPolicy {
+ public:
+  struct Options {
+    Options();
+
+    bool enabled;
+    // Combined private memory of tab renderers, in KB. 0 disables the budget.
+    size_t memory_budget_kb;
+    // Tabs that were active more recently than this are never discarded.
+    base::TimeDelta min_inactive_time;
+    // How often renderer memory is sampled when a budget is set.
+    base::TimeDelta sample_interval;
+    // Upper bound on discards for a single critical pressure signal.
+    int max_discards_on_critical;
+  };
+
+  GuestTabDiscardPolicy();
+  ~GuestTabDiscardPolicy();
+
+  void SetOptions(const base::DictionaryValue& options);
+  std::unique_ptr<base::DictionaryValue> GetOptions() const;
+
+  // Private memory of |handle| in KB. Must be called on a sequence that
+  // allows blocking.
+  static size_t GetPrivateMemoryKB(base::ProcessHandle handle);
+
+ private:
+  struct Candidate {
+    Candidate();
+
+    int tab_id;
+    base::ProcessHandle handle;
+    base::TimeDelta inactive_time;
+    bool discardable;
+    size_t private_kb;
+    double score;
+  };
+
+  using Candidates = std::vector<Candidate>;
+
+  void UpdateListeners();
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+  void OnSampleTimer();
+  void Measure(const std::string& reason,
+               int max_discards,
+               base::TaskPriority priority);
+
+  // Collects every tab with a live renderer. Memory and scores are filled in
+  // by |MeasureMemory| on a blocking sequence.
+  Candidates GetCandidates() const;
+  static Candidates MeasureMemory(Candidates candidates);
+  void OnMemoryMeasured(const std::string& reason,
+                        int max_discards,
+                        Candidates candidates);
+  void ApplyMeasurement(const std::string& reason,
+                        int max_discards,
+                        Candidates candidates);
+
+  bool DiscardCandidate(const Candidate& candidate,
+                        const std::string& reason,
+                        size_t total_private_kb);
+
+  Options options_;
+
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  base::RepeatingTimer sample_timer_;
+  bool measuring_;
+  // The most severe pressure signal received while measuring, if any.
+  std::string pending_reason_;
+  int pending_max_discards_;
+
+  base::WeakPtrFactory<GuestTabDiscardPolicy> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(GuestTabDiscardPolicy);
+};
+
+}  // namespace resource_coordinator
+
+#endif  // BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_DISCARD_POLICY_H_
@@ -35,7 +35,12 @@ DEFINE_WEB_CONTENTS_USER_DATA_KEY(content::RestoreHelper);
 
 namespace resource_coordinator {
 
-GuestTabManager::GuestTabManager() : TabManager() {}
+GuestTabManager::GuestTabManager()
+    : TabManager(),
+      discard_policy_(new GuestTabDiscardPolicy),
+      restore_scheduler_(new GuestTabRestoreScheduler) {}
+
+GuestTabManager::~GuestTabManager() {}
 
 WebContents* GuestTabManager::CreateNullContents(
     TabStripModel* model, WebContents* old_contents) {
@@ -5,6 +5,10 @@
 #ifndef BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_MANAGER_H_
 #define BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_MANAGER_H_
 
+#include <memory>
+
+#include "brave/browser/resource_coordinator/guest_tab_discard_policy.h"
+#include "brave/browser/resource_coordinator/guest_tab_restore_scheduler.h"
 #include "chrome/browser/resource_coordinator/tab_manager.h"
 
 #include "content/public/browser/web_contents_observer.h"
@@ -31,6 +35,15 @@ namespace resource_coordinator {
 class GuestTabManager : public TabManager {
  public:
   GuestTabManager();
+  ~GuestTabManager() override;
+
+  GuestTabDiscardPolicy* discard_policy() const {
+    return discard_policy_.get();
+  }
+
+  GuestTabRestoreScheduler* restore_scheduler() const {
+    return restore_scheduler_.get();
+  }
 
  private:
   void ActiveTabChanged(content::WebContents* old_contents,
@@ -46,6 +59,9 @@ class GuestTabManager : public TabManager {
       TabStripModel* model, content::WebContents* old_contents) override;
   void DestroyOldContents(content::WebContents* old_contents) override;
 
+  std::unique_ptr<GuestTabDiscardPolicy> discard_policy_;
+  std::unique_ptr<GuestTabRestoreScheduler> restore_scheduler_;
+
   DISALLOW_COPY_AND_ASSIGN(GuestTabManager);
 };
 
@@ -0,0 +1,355 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/resource_coordinator/guest_tab_restore_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "atom/browser/api/atom_api_app.h"
+#include "atom/browser/extensions/tab_helper.h"
+#include "atom/browser/native_window.h"
+#include "atom/common/native_mate_converters/value_converter.h"
+#include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/timer/timer.h"
+#include "base/trace_event/trace_event.h"
+#include "base/values.h"
+#include "brave/browser/resource_coordinator/guest_tab_discard_policy.h"
+#include "chrome/browser/browser_process.h"
+#include "chrome/browser/ui/browser.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "muon/browser/muon_browser_process_impl.h"
+
+using content::BrowserThread;
+using content::WebContents;
+
+namespace resource_coordinator {
+
+namespace {
+
+const char kMaxConcurrentLoadsKey[] = "maxConcurrentLoads";
+const char kLoadTimeoutKey[] = "loadTimeout";
+
+const size_t kDefaultMaxConcurrentLoads = 3;
+const int kDefaultLoadTimeoutSeconds = 20;
+
+enum LoadPriority {
+  ACTIVE_TAB = 0,
+  VISIBLE_WINDOW,
+  BACKGROUND,
+};
+
+LoadPriority GetLoadPriority(WebContents* contents) {
+  auto tab_helper = extensions::TabHelper::FromWebContents(contents);
+  if (!tab_helper)
+    return BACKGROUND;
+
+  if (tab_helper->is_active())
+    return ACTIVE_TAB;
+
+  Browser* browser = tab_helper->browser();
+  if (browser && browser->window()) {
+    auto window = static_cast<atom::NativeWindow*>(browser->window());
+    if (window->IsVisible() && !window->IsMinimized())
+      return VISIBLE_WINDOW;
+  }
+
+  return BACKGROUND;
+}
+
+}  // namespace
+
+class GuestTabRestoreScheduler::TabObserver
+    : public content::WebContentsObserver {
+ public:
+  TabObserver(GuestTabRestoreScheduler* scheduler,
+              WebContents* contents,
+              base::Time last_active)
+      : content::WebContentsObserver(contents),
+        scheduler_(scheduler),
+        last_active_(last_active),
+        loading_(false) {}
+  ~TabObserver() override {}
+
+  void StartLoading(base::TimeDelta timeout) {
+    loading_ = true;
+    timeout_timer_.Start(FROM_HERE, timeout,
+        base::Bind(&TabObserver::OnTimeout, base::Unretained(this)));
+  }
+
+  void Stop() {
+    timeout_timer_.Stop();
+    Observe(nullptr);
+  }
+
+  base::Time last_active() const { return last_active_; }
+  bool loading() const { return loading_; }
+
+ private:
+  void OnTimeout() {
+    scheduler_->OnTabLoaded(web_contents(), true);
+  }
+
+  // content::WebContentsObserver:
+  void DidStartLoading() override {
+    scheduler_->OnTabStartedLoading(web_contents());
+  }
+
+  void DidStopLoading() override {
+    if (loading_)
+      scheduler_->OnTabLoaded(web_contents(), false);
+  }
+
+  void DidFirstVisuallyNonEmptyPaint() override {
+    scheduler_->OnTabFirstPaint(web_contents());
+  }
+
+  void WebContentsDestroyed() override {
+    scheduler_->OnTabDestroyed(web_contents());
+  }
+
+  GuestTabRestoreScheduler* scheduler_;  // not owned
+  base::Time last_active_;
+  bool loading_;
+  base::OneShotTimer timeout_timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(TabObserver);
+};
+
+GuestTabRestoreScheduler::GuestTabRestoreScheduler()
+    : max_concurrent_loads_(kDefaultMaxConcurrentLoads),
+      load_timeout_(
+          base::TimeDelta::FromSeconds(kDefaultLoadTimeoutSeconds)),
+      loading_count_(0),
+      load_scheduled_(false),
+      restoring_(false),
+      restored_count_(0),
+      timed_out_count_(0),
+      max_loading_count_(0),
+      weak_ptr_factory_(this) {}
+
+GuestTabRestoreScheduler::~GuestTabRestoreScheduler() {}
+
+void GuestTabRestoreScheduler::SetOptions(
+    const base::DictionaryValue& options) {
+  int value = 0;
+  if (options.GetInteger(kMaxConcurrentLoadsKey, &value))
+    max_concurrent_loads_ = std::max(value, 1);
+  if (options.GetInteger(kLoadTimeoutKey, &value) && value > 0)
+    load_timeout_ = base::TimeDelta::FromMilliseconds(value);
+
+  ScheduleLoad();
+}
+
+std::unique_ptr<base::DictionaryValue>
+GuestTabRestoreScheduler::GetOptions() const {
+  std::unique_ptr<base::DictionaryValue> options(new base::DictionaryValue);
+  options->SetInteger(kMaxConcurrentLoadsKey,
+      static_cast<int>(max_concurrent_loads_));
+  options->SetInteger(kLoadTimeoutKey, load_timeout_.InMilliseconds());
+  return options;
+}
+
+void GuestTabRestoreScheduler::AddTab(WebContents* contents,
+                                      base::Time last_active) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  if (tabs_.find(contents) != tabs_.end())
+    return;
+
+  if (!restoring_) {
+    TRACE_EVENT_ASYNC_BEGIN0("browser", "GuestTabRestoreScheduler::Restore",
+                             this);
+    restoring_ = true;
+    restore_start_ = base::TimeTicks::Now();
+    if (base::ThreadTicks::IsSupported())
+      restore_thread_start_ = base::ThreadTicks::Now();
+    active_tab_first_paint_ = base::TimeDelta();
+    restored_count_ = 0;
+    timed_out_count_ = 0;
+    max_loading_count_ = 0;
+    renderer_handles_.clear();
+  }
+
+  tabs_[contents] = base::MakeUnique<TabObserver>(this, contents, last_active);
+  restored_count_++;
+  ScheduleLoad();
+}
+
+void GuestTabRestoreScheduler::OnTabStartedLoading(WebContents* contents) {
+  // The tab was loaded outside of the scheduler, usually because it was
+  // activated or shown, so it counts against the concurrency limit now.
+  auto it = tabs_.find(contents);
+  if (it == tabs_.end() || it->second->loading())
+    return;
+
+  it->second->StartLoading(load_timeout_);
+  loading_count_++;
+  max_loading_count_ = std::max(max_loading_count_, loading_count_);
+}
+
+void GuestTabRestoreScheduler::OnTabLoaded(WebContents* contents,
+                                           bool timed_out) {
+  if (tabs_.find(contents) == tabs_.end())
+    return;
+
+  if (timed_out)
+    timed_out_count_++;
+
+  base::ProcessHandle handle =
+      contents->GetMainFrame()->GetProcess()->GetHandle();
+  if (handle != base::kNullProcessHandle &&
+      std::find(renderer_handles_.begin(), renderer_handles_.end(), handle) ==
+          renderer_handles_.end())
+    renderer_handles_.push_back(handle);
+
+  RemoveTab(contents);
+}
+
+void GuestTabRestoreScheduler::OnTabDestroyed(WebContents* contents) {
+  RemoveTab(contents);
+}
+
+void GuestTabRestoreScheduler::OnTabFirstPaint(WebContents* contents) {
+  if (!restoring_ || !active_tab_first_paint_.is_zero())
+    return;
+
+  if (GetLoadPriority(contents) == ACTIVE_TAB)
+    active_tab_first_paint_ = base::TimeTicks::Now() - restore_start_;
+}
+
+void GuestTabRestoreScheduler::RemoveTab(WebContents* contents) {
+  auto it = tabs_.find(contents);
+  if (it == tabs_.end())
+    return;
+
+  if (it->second->loading())
+    loading_count_--;
+
+  it->second->Stop();
+  // Removal can happen from inside one of the observer's own callbacks
+  base::ThreadTaskRunnerHandle::Get()->DeleteSoon(
+      FROM_HERE, it->second.release());
+  tabs_.erase(it);
+
+  ScheduleLoad();
+  MaybeFinishRestore();
+}
+
+void GuestTabRestoreScheduler::ScheduleLoad() {
+  // Batch loads so that all of the tabs added in one restore are queued
+  // before any are picked
+  if (load_scheduled_)
+    return;
+
+  load_scheduled_ = true;
+  base::ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+      base::Bind(&GuestTabRestoreScheduler::LoadNextTabs,
+                 weak_ptr_factory_.GetWeakPtr()));
+}
+
+void GuestTabRestoreScheduler::LoadNextTabs() {
+  load_scheduled_ = false;
+
+  while (loading_count_ < max_concurrent_loads_) {
+    WebContents* contents = GetNextTabToLoad();
+    if (!contents)
+      break;
+
+    auto tab_helper = extensions::TabHelper::FromWebContents(contents);
+    OnTabStartedLoading(contents);
+    if (!tab_helper || !tab_helper->LoadDiscarded()) {
+      // Already loaded by someone else
+      RemoveTab(contents);
+    }
+  }
+}
+
+WebContents* GuestTabRestoreScheduler::GetNextTabToLoad() const {
+  WebContents* next = nullptr;
+  LoadPriority next_priority = BACKGROUND;
+  base::Time next_last_active;
+  for (const auto& tab : tabs_) {
+    if (tab.second->loading())
+      continue;
+
+    LoadPriority priority = GetLoadPriority(tab.first);
+    base::Time last_active = tab.second->last_active();
+    if (!next ||
+        priority < next_priority ||
+        (priority == next_priority && last_active > next_last_active)) {
+      next = tab.first;
+      next_priority = priority;
+      next_last_active = last_active;
+    }
+  }
+  return next;
+}
+
+void GuestTabRestoreScheduler::MaybeFinishRestore() {
+  if (!restoring_ || !tabs_.empty())
+    return;
+
+  restoring_ = false;
+  TRACE_EVENT_ASYNC_END0("browser", "GuestTabRestoreScheduler::Restore",
+                         this);
+
+  base::TimeDelta duration = base::TimeTicks::Now() - restore_start_;
+  UMA_HISTOGRAM_MEDIUM_TIMES("SessionRestore.GuestTabs.Duration", duration);
+  if (!active_tab_first_paint_.is_zero()) {
+    UMA_HISTOGRAM_MEDIUM_TIMES("SessionRestore.GuestTabs.ActiveTabFirstPaint",
+                               active_tab_first_paint_);
+  }
+
+  std::unique_ptr<base::DictionaryValue> metrics(new base::DictionaryValue);
+  metrics->SetInteger("tabCount", restored_count_);
+  metrics->SetInteger("timedOutCount", timed_out_count_);
+  metrics->SetInteger("maxConcurrentLoads",
+      static_cast<int>(max_loading_count_));
+  metrics->SetDouble("duration", duration.InMillisecondsF());
+  metrics->SetDouble("activeTabFirstPaint",
+      active_tab_first_paint_.InMillisecondsF());
+  if (base::ThreadTicks::IsSupported()) {
+    metrics->SetDouble("mainThreadCpuTime",
+        (base::ThreadTicks::Now() - restore_thread_start_).InMillisecondsF());
+  }
+
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::BACKGROUND},
+      base::Bind(&GuestTabRestoreScheduler::MeasureMemory, renderer_handles_),
+      base::Bind(&GuestTabRestoreScheduler::OnRestoreFinished,
+                 weak_ptr_factory_.GetWeakPtr(), base::Passed(&metrics)));
+  renderer_handles_.clear();
+}
+
+// static
+size_t GuestTabRestoreScheduler::MeasureMemory(
+    std::vector<base::ProcessHandle> handles) {
+  size_t private_kb = 0;
+  for (auto handle : handles)
+    private_kb += GuestTabDiscardPolicy::GetPrivateMemoryKB(handle);
+  return private_kb;
+}
+
+void GuestTabRestoreScheduler::OnRestoreFinished(
+    std::unique_ptr<base::DictionaryValue> metrics,
+    size_t private_kb) {
+  UMA_HISTOGRAM_MEMORY_KB("SessionRestore.GuestTabs.RendererPrivateMemory",
+                          private_kb);
+  metrics->SetInteger("rendererPrivateMemory", static_cast<int>(private_kb));
+
+  atom::api::App* app =
+      static_cast<MuonBrowserProcessImpl*>(g_browser_process)->app();
+  if (app)
+    app->Emit("session-restore-complete", *metrics);
+}
+
+}  // namespace resource_coordinator
@@ -0,0 +1,87 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_RESTORE_SCHEDULER_H_
+#define BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_RESTORE_SCHEDULER_H_
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/time/time.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace content {
+class WebContents;
+}
+
+namespace resource_coordinator {
+
+// Loads restored placeholder tabs a few at a time instead of spinning up a
+// renderer for every tab in the session at once. Queued tabs are loaded in
+// priority order: the active tab, tabs in visible windows and then the most
+// recently used tabs.
+class GuestTabRestoreScheduler {
+ public:
+  GuestTabRestoreScheduler();
+  ~GuestTabRestoreScheduler();
+
+  void SetOptions(const base::DictionaryValue& options);
+  std::unique_ptr<base::DictionaryValue> GetOptions() const;
+
+  // Queues a tab that was created discarded with its restored navigation
+  // entries. |last_active| is when the tab was last used in the previous
+  // session.
+  void AddTab(content::WebContents* contents, base::Time last_active);
+
+ private:
+  class TabObserver;
+  friend class TabObserver;
+
+  void OnTabStartedLoading(content::WebContents* contents);
+  void OnTabLoaded(content::WebContents* contents, bool timed_out);
+  void OnTabDestroyed(content::WebContents* contents);
+  void OnTabFirstPaint(content::WebContents* contents);
+
+  void RemoveTab(content::WebContents* contents);
+  void ScheduleLoad();
+  void LoadNextTabs();
+  content::WebContents* GetNextTabToLoad() const;
+
+  void MaybeFinishRestore();
+  static size_t MeasureMemory(std::vector<base::ProcessHandle> handles);
+  void OnRestoreFinished(std::unique_ptr<base::DictionaryValue> metrics,
+                         size_t private_kb);
+
+  size_t max_concurrent_loads_;
+  base::TimeDelta load_timeout_;
+
+  std::map<content::WebContents*, std::unique_ptr<TabObserver>> tabs_;
+  size_t loading_count_;
+  bool load_scheduled_;
+
+  // Metrics for the restore currently in progress.
+  bool restoring_;
+  base::TimeTicks restore_start_;
+  base::ThreadTicks restore_thread_start_;
+  base::TimeDelta active_tab_first_paint_;
+  int restored_count_;
+  int timed_out_count_;
+  size_t max_loading_count_;
+  std::vector<base::ProcessHandle> renderer_handles_;
+
+  base::WeakPtrFactory<GuestTabRestoreScheduler> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(GuestTabRestoreScheduler);
+};
+
+}  // namespace resource_coordinator
+
+#endif  // BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_RESTORE_SCHEDULER_H_
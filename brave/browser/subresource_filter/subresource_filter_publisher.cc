@@ -0,0 +1,178 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/subresource_filter/subresource_filter_publisher.h"
+
+#include <string.h>
+
+#include <utility>
+#include <vector>
+
+#include "atom/common/api/api_messages.h"
+#include "base/memory/singleton.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/values.h"
+#include "brave/common/subresource_filter/filter_snapshot_builder.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+
+using content::BrowserThread;
+
+namespace brave {
+
+namespace {
+
+const char kBlockedHostsKey[] = "blockedHosts";
+const char kPatternsKey[] = "patterns";
+const char kDisabledSitesKey[] = "disabledSites";
+
+// Reads the optional list of strings at |key| into |out|.
+bool GetStringList(const base::DictionaryValue& rules,
+                   const char* key,
+                   std::vector<std::string>* out,
+                   std::string* error) {
+  const base::Value* value = nullptr;
+  if (!rules.Get(key, &value))
+    return true;
+
+  const base::ListValue* list = nullptr;
+  if (!value->GetAsList(&list)) {
+    *error = std::string(key) + " must be an array of strings";
+    return false;
+  }
+
+  for (const auto& item : *list) {
+    std::string entry;
+    if (!item.GetAsString(&entry)) {
+      *error = std::string(key) + " must be an array of strings";
+      return false;
+    }
+    out->push_back(entry);
+  }
+  return true;
+}
+
+}  // namespace
+
+// static
+SubresourceFilterPublisher* SubresourceFilterPublisher::GetInstance() {
+  return base::Singleton<SubresourceFilterPublisher>::get();
+}
+
+SubresourceFilterPublisher::SubresourceFilterPublisher()
+    : version_(0),
+      published_version_(0),
+      weak_ptr_factory_(this) {}
+
+SubresourceFilterPublisher::~SubresourceFilterPublisher() {}
+
+int SubresourceFilterPublisher::SetRules(const base::DictionaryValue& rules,
+                                         std::string* error) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  std::vector<std::string> blocked_hosts;
+  std::vector<std::string> patterns;
+  std::vector<std::string> disabled_sites;
+  if (!GetStringList(rules, kBlockedHostsKey, &blocked_hosts, error) ||
+      !GetStringList(rules, kPatternsKey, &patterns, error) ||
+      !GetStringList(rules, kDisabledSitesKey, &disabled_sites, error))
+    return -1;
+
+  std::unique_ptr<FilterSnapshotBuilder> builder(new FilterSnapshotBuilder);
+  for (const auto& host : blocked_hosts)
+    builder->AddBlockedHost(host);
+  for (const auto& pattern : patterns)
+    builder->AddPattern(pattern);
+  for (const auto& site : disabled_sites)
+    builder->AddDisabledSite(site);
+
+  int version = ++version_;
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::Bind(&SubresourceFilterPublisher::BuildSnapshot,
+                 base::Passed(&builder)),
+      base::Bind(&SubresourceFilterPublisher::OnSnapshotBuilt,
+                 weak_ptr_factory_.GetWeakPtr(), version));
+  return version;
+}
+
+void SubresourceFilterPublisher::ClearRules() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  // Also drops any snapshot that is still being built
+  published_version_ = ++version_;
+  shared_memory_.reset();
+  PublishToAllHosts();
+}
+
+void SubresourceFilterPublisher::RenderProcessWillLaunch(
+    content::RenderProcessHost* host) {
+  if (shared_memory_)
+    PublishToHost(host);
+}
+
+// static
+std::unique_ptr<base::SharedMemory> SubresourceFilterPublisher::BuildSnapshot(
+    std::unique_ptr<FilterSnapshotBuilder> builder) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  std::vector<uint8_t> data = builder->Build();
+
+  base::SharedMemoryCreateOptions options;
+  options.size = data.size();
+  options.share_read_only = true;
+  std::unique_ptr<base::SharedMemory> shared_memory(new base::SharedMemory);
+  if (!shared_memory->Create(options) || !shared_memory->Map(data.size()))
+    return nullptr;
+
+  memcpy(shared_memory->memory(), data.data(), data.size());
+  // The browser never reads the snapshot back
+  shared_memory->Unmap();
+
+  UMA_HISTOGRAM_TIMES("SubresourceFilter.SnapshotBuildTime",
+                      base::TimeTicks::Now() - start);
+  UMA_HISTOGRAM_COUNTS_100000("SubresourceFilter.SnapshotSizeKB",
+                              data.size() / 1024);
+  return shared_memory;
+}
+
+void SubresourceFilterPublisher::OnSnapshotBuilt(
+    int version,
+    std::unique_ptr<base::SharedMemory> shared_memory) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  // A newer update was requested while this one was being built
+  if (version != version_ || !shared_memory)
+    return;
+
+  published_version_ = version;
+  shared_memory_ = std::move(shared_memory);
+  PublishToAllHosts();
+}
+
+void SubresourceFilterPublisher::PublishToAllHosts() {
+  for (content::RenderProcessHost::iterator it(
+           content::RenderProcessHost::AllHostsIterator());
+       !it.IsAtEnd(); it.Advance()) {
+    PublishToHost(it.GetCurrentValue());
+  }
+}
+
+void SubresourceFilterPublisher::PublishToHost(
+    content::RenderProcessHost* host) {
+  if (!shared_memory_) {
+    host->Send(new AtomMsg_UpdateSubresourceFilter(
+        base::SharedMemoryHandle(), 0, published_version_));
+    return;
+  }
+
+  base::SharedMemoryHandle handle = shared_memory_->GetReadOnlyHandle();
+  if (!handle.IsValid())
+    return;
+
+  host->Send(new AtomMsg_UpdateSubresourceFilter(
+      handle, shared_memory_->requested_size(), published_version_));
+}
+
+}  // namespace brave
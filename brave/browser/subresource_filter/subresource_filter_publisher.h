@@ -0,0 +1,76 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_SUBRESOURCE_FILTER_SUBRESOURCE_FILTER_PUBLISHER_H_
+#define BRAVE_BROWSER_SUBRESOURCE_FILTER_SUBRESOURCE_FILTER_PUBLISHER_H_
+
+#include <memory>
+#include <string>
+
+#include "base/macros.h"
+#include "base/memory/shared_memory.h"
+#include "base/memory/weak_ptr.h"
+
+namespace base {
+class DictionaryValue;
+template <typename T> struct DefaultSingletonTraits;
+}
+
+namespace content {
+class RenderProcessHost;
+}
+
+namespace brave {
+
+class FilterSnapshotBuilder;
+
+// Compiles subresource filter rules into a snapshot and shares it read-only
+// with every renderer, so blocked subresources are cancelled in the renderer
+// without a round trip to the browser. Each update is built off the UI
+// thread into a new region tagged with an increasing version, renderers swap
+// to it and drop older versions.
+class SubresourceFilterPublisher {
+ public:
+  static SubresourceFilterPublisher* GetInstance();
+
+  // Replaces the rules with |rules| and returns the version the snapshot
+  // will be published with. Returns -1 and sets |error| if |rules| is
+  // malformed.
+  int SetRules(const base::DictionaryValue& rules, std::string* error);
+  // Removes all rules from every renderer.
+  void ClearRules();
+
+  int version() const { return version_; }
+
+  // Sends the current snapshot to a renderer that is being launched.
+  void RenderProcessWillLaunch(content::RenderProcessHost* host);
+
+ private:
+  friend struct base::DefaultSingletonTraits<SubresourceFilterPublisher>;
+
+  SubresourceFilterPublisher();
+  ~SubresourceFilterPublisher();
+
+  static std::unique_ptr<base::SharedMemory> BuildSnapshot(
+      std::unique_ptr<FilterSnapshotBuilder> builder);
+  void OnSnapshotBuilt(int version,
+                       std::unique_ptr<base::SharedMemory> shared_memory);
+
+  void PublishToAllHosts();
+  void PublishToHost(content::RenderProcessHost* host);
+
+  // The latest version handed out by SetRules or ClearRules.
+  int version_;
+  // The version of |shared_memory_|, or of the last clear.
+  int published_version_;
+  std::unique_ptr<base::SharedMemory> shared_memory_;
+
+  base::WeakPtrFactory<SubresourceFilterPublisher> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(SubresourceFilterPublisher);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_SUBRESOURCE_FILTER_SUBRESOURCE_FILTER_PUBLISHER_H_
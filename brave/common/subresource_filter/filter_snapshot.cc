@@ -0,0 +1,196 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/subresource_filter/filter_snapshot.h"
+
+#include <algorithm>
+
+#include "base/strings/string_util.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace filter_snapshot {
+
+uint64_t HashHost(base::StringPiece host) {
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : host) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash ? hash : 1;
+}
+
+}  // namespace filter_snapshot
+
+namespace {
+
+using filter_snapshot::Edge;
+using filter_snapshot::Header;
+using filter_snapshot::Node;
+
+bool IsPowerOfTwo(uint32_t value) {
+  return value && !(value & (value - 1));
+}
+
+// Whether |count| records of |record_size| bytes at |offset| fit in |size|
+// and are suitably aligned.
+bool IsValidRange(uint32_t offset, uint32_t count, size_t record_size,
+                  size_t alignment, size_t size) {
+  if (offset % alignment)
+    return false;
+  uint64_t end = static_cast<uint64_t>(offset) +
+      static_cast<uint64_t>(count) * record_size;
+  return end <= size;
+}
+
+}  // namespace
+
+FilterSnapshot::FilterSnapshot()
+    : data_(nullptr),
+      header_(nullptr) {}
+
+FilterSnapshot::~FilterSnapshot() {}
+
+bool FilterSnapshot::Init(const void* data, size_t size) {
+  data_ = nullptr;
+  header_ = nullptr;
+
+  if (!data || size < sizeof(Header) ||
+      reinterpret_cast<uintptr_t>(data) % alignof(uint64_t))
+    return false;
+
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  const Header* header = reinterpret_cast<const Header*>(bytes);
+  if (header->magic != filter_snapshot::kMagic ||
+      header->format_version != filter_snapshot::kFormatVersion ||
+      header->size != size)
+    return false;
+
+  if (!IsPowerOfTwo(header->blocked_hosts_capacity) ||
+      !IsValidRange(header->blocked_hosts_offset,
+                    header->blocked_hosts_capacity,
+                    sizeof(uint64_t), alignof(uint64_t), size) ||
+      !IsPowerOfTwo(header->disabled_sites_capacity) ||
+      !IsValidRange(header->disabled_sites_offset,
+                    header->disabled_sites_capacity,
+                    sizeof(uint64_t), alignof(uint64_t), size) ||
+      header->node_count == 0 ||
+      !IsValidRange(header->nodes_offset, header->node_count,
+                    sizeof(Node), alignof(Node), size) ||
+      !IsValidRange(header->edges_offset, header->edge_count,
+                    sizeof(Edge), alignof(Edge), size))
+    return false;
+
+  // Nodes are stored breadth first so every fail link points to an earlier
+  // node, which guarantees matching terminates.
+  const Node* nodes =
+      reinterpret_cast<const Node*>(bytes + header->nodes_offset);
+  const Edge* edges =
+      reinterpret_cast<const Edge*>(bytes + header->edges_offset);
+  for (uint32_t i = 0; i < header->node_count; ++i) {
+    const Node& node = nodes[i];
+    if ((i > 0 && node.fail >= i) || (i == 0 && node.fail != 0))
+      return false;
+    if (static_cast<uint64_t>(node.first_edge) + node.edge_count >
+        header->edge_count)
+      return false;
+    for (uint32_t e = node.first_edge; e < node.first_edge + node.edge_count;
+         ++e) {
+      if (edges[e].target >= header->node_count || edges[e].target == 0 ||
+          edges[e].byte > 0xff)
+        return false;
+      if (e > node.first_edge && edges[e - 1].byte >= edges[e].byte)
+        return false;
+    }
+  }
+
+  data_ = bytes;
+  header_ = header;
+  return true;
+}
+
+bool FilterSnapshot::ShouldBlock(const GURL& url,
+                                 const GURL& first_party_url) const {
+  if (empty() || !url.is_valid() ||
+      !(url.SchemeIsHTTPOrHTTPS() || url.SchemeIsWSOrWSS()))
+    return false;
+
+  if (net::registry_controlled_domains::SameDomainOrHost(
+          url, first_party_url,
+          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES))
+    return false;
+
+  if (ContainsHost(header_->disabled_sites_offset,
+                   header_->disabled_sites_capacity,
+                   first_party_url.host_piece()))
+    return false;
+
+  return ContainsHost(header_->blocked_hosts_offset,
+                      header_->blocked_hosts_capacity,
+                      url.host_piece()) ||
+      MatchesPattern(url.spec());
+}
+
+bool FilterSnapshot::ContainsHost(uint32_t offset,
+                                  uint32_t capacity,
+                                  base::StringPiece host) const {
+  const uint64_t* slots = reinterpret_cast<const uint64_t*>(data_ + offset);
+  const uint32_t mask = capacity - 1;
+
+  // Check the host and each of its parent domains
+  while (!host.empty()) {
+    uint64_t hash = filter_snapshot::HashHost(host);
+    for (uint32_t probe = 0; probe < capacity; ++probe) {
+      uint64_t slot = slots[(hash + probe) & mask];
+      if (slot == hash)
+        return true;
+      if (slot == 0)
+        break;
+    }
+
+    size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+  return false;
+}
+
+bool FilterSnapshot::MatchesPattern(base::StringPiece spec) const {
+  if (header_->edge_count == 0)
+    return false;
+
+  const Node* nodes =
+      reinterpret_cast<const Node*>(data_ + header_->nodes_offset);
+  const Edge* edges =
+      reinterpret_cast<const Edge*>(data_ + header_->edges_offset);
+
+  uint32_t state = 0;
+  for (char c : spec) {
+    uint32_t byte = static_cast<uint8_t>(base::ToLowerASCII(c));
+    while (true) {
+      const Node& node = nodes[state];
+      const Edge* begin = edges + node.first_edge;
+      const Edge* end = begin + node.edge_count;
+      const Edge* edge = std::lower_bound(begin, end, byte,
+          [](const Edge& edge, uint32_t byte) { return edge.byte < byte; });
+      if (edge != end && edge->byte == byte) {
+        state = edge->target;
+        break;
+      }
+      if (state == 0)
+        break;
+      state = node.fail;
+    }
+
+    if (nodes[state].match)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace brave
@@ -0,0 +1,93 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_SUBRESOURCE_FILTER_FILTER_SNAPSHOT_H_
+#define BRAVE_COMMON_SUBRESOURCE_FILTER_FILTER_SNAPSHOT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+class GURL;
+
+namespace brave {
+
+// Serialized layout of a filter snapshot. The snapshot is built once in the
+// browser and mapped read-only into every renderer, so it only contains
+// offsets and fixed size records.
+namespace filter_snapshot {
+
+const uint32_t kMagic = 0x53465342;  // "BSFS"
+const uint32_t kFormatVersion = 1;
+
+struct Header {
+  uint32_t magic;
+  uint32_t format_version;
+  uint32_t size;
+  // Open addressed tables of host hashes. Capacities are powers of two and
+  // an empty slot holds 0.
+  uint32_t blocked_hosts_offset;
+  uint32_t blocked_hosts_capacity;
+  uint32_t disabled_sites_offset;
+  uint32_t disabled_sites_capacity;
+  // Aho-Corasick automaton over the lower case URL spec. Node 0 is the root.
+  uint32_t nodes_offset;
+  uint32_t node_count;
+  uint32_t edges_offset;
+  uint32_t edge_count;
+};
+
+struct Node {
+  // Edges of a node are contiguous and sorted by byte.
+  uint32_t first_edge;
+  uint32_t edge_count;
+  uint32_t fail;
+  // Non-zero if a pattern ends at this node or at any node on its fail chain.
+  uint32_t match;
+};
+
+struct Edge {
+  uint32_t byte;
+  uint32_t target;
+};
+
+// Hash used for the host tables, never 0.
+uint64_t HashHost(base::StringPiece host);
+
+}  // namespace filter_snapshot
+
+// Read-only view over a serialized filter snapshot. Does not own the memory.
+class FilterSnapshot {
+ public:
+  FilterSnapshot();
+  ~FilterSnapshot();
+
+  // Validates the snapshot in |data| so lookups never read out of bounds.
+  // Returns false and leaves the view empty if it is malformed.
+  bool Init(const void* data, size_t size);
+
+  bool empty() const { return !header_; }
+
+  // Whether a request for |url| made from a page on |first_party_url| should
+  // be blocked. Only third-party requests are filtered and nothing is
+  // filtered on disabled sites.
+  bool ShouldBlock(const GURL& url, const GURL& first_party_url) const;
+
+ private:
+  bool ContainsHost(uint32_t offset,
+                    uint32_t capacity,
+                    base::StringPiece host) const;
+  bool MatchesPattern(base::StringPiece spec) const;
+
+  const uint8_t* data_;
+  const filter_snapshot::Header* header_;
+
+  DISALLOW_COPY_AND_ASSIGN(FilterSnapshot);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_SUBRESOURCE_FILTER_FILTER_SNAPSHOT_H_
@@ -0,0 +1,198 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/subresource_filter/filter_snapshot_builder.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <queue>
+
+#include "base/bits.h"
+#include "base/strings/string_util.h"
+#include "brave/common/subresource_filter/filter_snapshot.h"
+
+namespace brave {
+
+namespace {
+
+using filter_snapshot::Edge;
+using filter_snapshot::Header;
+using filter_snapshot::Node;
+
+std::string NormalizeHost(const std::string& host) {
+  base::StringPiece piece(host);
+  if (piece.starts_with("*."))
+    piece.remove_prefix(2);
+  else if (piece.starts_with("."))
+    piece.remove_prefix(1);
+  return base::ToLowerASCII(piece);
+}
+
+uint32_t TableCapacity(size_t count) {
+  // Keep the load factor at or below 1/2 so probing stays short and every
+  // table has at least one empty slot.
+  return 1u << base::bits::Log2Ceiling(
+      static_cast<uint32_t>(std::max<size_t>(count * 2, 1)));
+}
+
+void WriteTable(const std::set<uint64_t>& hashes,
+                uint32_t capacity,
+                uint64_t* slots) {
+  const uint32_t mask = capacity - 1;
+  for (uint64_t hash : hashes) {
+    uint32_t index = hash & mask;
+    while (slots[index])
+      index = (index + 1) & mask;
+    slots[index] = hash;
+  }
+}
+
+struct TrieNode {
+  TrieNode() : fail(0), match(false) {}
+
+  std::map<uint8_t, uint32_t> children;
+  uint32_t fail;
+  bool match;
+};
+
+// Builds an Aho-Corasick automaton and returns its nodes in breadth first
+// order, so node 0 is the root and fail links always point backwards.
+std::vector<TrieNode> BuildAutomaton(const std::set<std::string>& patterns) {
+  std::vector<TrieNode> trie(1);
+  for (const auto& pattern : patterns) {
+    uint32_t state = 0;
+    for (char c : pattern) {
+      uint8_t byte = static_cast<uint8_t>(c);
+      auto it = trie[state].children.find(byte);
+      if (it == trie[state].children.end()) {
+        trie[state].children[byte] = trie.size();
+        state = trie.size();
+        trie.emplace_back();
+      } else {
+        state = it->second;
+      }
+    }
+    trie[state].match = true;
+  }
+
+  // Renumber breadth first while computing fail links
+  std::vector<uint32_t> order;
+  std::vector<uint32_t> new_index(trie.size());
+  std::queue<uint32_t> queue;
+  queue.push(0);
+  while (!queue.empty()) {
+    uint32_t state = queue.front();
+    queue.pop();
+    new_index[state] = order.size();
+    order.push_back(state);
+
+    for (const auto& child : trie[state].children) {
+      uint32_t fail = 0;
+      if (state != 0) {
+        uint32_t candidate = trie[state].fail;
+        while (true) {
+          auto it = trie[candidate].children.find(child.first);
+          if (it != trie[candidate].children.end()) {
+            fail = it->second;
+            break;
+          }
+          if (candidate == 0)
+            break;
+          candidate = trie[candidate].fail;
+        }
+      }
+      trie[child.second].fail = fail;
+      trie[child.second].match |= trie[fail].match;
+      queue.push(child.second);
+    }
+  }
+
+  std::vector<TrieNode> result(trie.size());
+  for (uint32_t i = 0; i < order.size(); ++i) {
+    const TrieNode& node = trie[order[i]];
+    result[i].fail = new_index[node.fail];
+    result[i].match = node.match;
+    for (const auto& child : node.children)
+      result[i].children[child.first] = new_index[child.second];
+  }
+  return result;
+}
+
+}  // namespace
+
+FilterSnapshotBuilder::FilterSnapshotBuilder() {}
+
+FilterSnapshotBuilder::~FilterSnapshotBuilder() {}
+
+void FilterSnapshotBuilder::AddBlockedHost(const std::string& host) {
+  std::string normalized = NormalizeHost(host);
+  if (!normalized.empty())
+    blocked_hosts_.insert(filter_snapshot::HashHost(normalized));
+}
+
+void FilterSnapshotBuilder::AddDisabledSite(const std::string& host) {
+  std::string normalized = NormalizeHost(host);
+  if (!normalized.empty())
+    disabled_sites_.insert(filter_snapshot::HashHost(normalized));
+}
+
+void FilterSnapshotBuilder::AddPattern(const std::string& pattern) {
+  // An empty pattern would match every URL
+  if (!pattern.empty())
+    patterns_.insert(base::ToLowerASCII(pattern));
+}
+
+std::vector<uint8_t> FilterSnapshotBuilder::Build() const {
+  std::vector<TrieNode> automaton = BuildAutomaton(patterns_);
+  size_t edge_count = 0;
+  for (const auto& node : automaton)
+    edge_count += node.children.size();
+
+  Header header;
+  memset(&header, 0, sizeof(header));
+  header.magic = filter_snapshot::kMagic;
+  header.format_version = filter_snapshot::kFormatVersion;
+
+  size_t size = base::bits::Align(sizeof(Header), alignof(uint64_t));
+  header.blocked_hosts_offset = size;
+  header.blocked_hosts_capacity = TableCapacity(blocked_hosts_.size());
+  size += header.blocked_hosts_capacity * sizeof(uint64_t);
+  header.disabled_sites_offset = size;
+  header.disabled_sites_capacity = TableCapacity(disabled_sites_.size());
+  size += header.disabled_sites_capacity * sizeof(uint64_t);
+  header.nodes_offset = size;
+  header.node_count = automaton.size();
+  size += automaton.size() * sizeof(Node);
+  header.edges_offset = size;
+  header.edge_count = edge_count;
+  size += edge_count * sizeof(Edge);
+  header.size = size;
+
+  std::vector<uint8_t> data(size, 0);
+  memcpy(data.data(), &header, sizeof(header));
+  WriteTable(blocked_hosts_, header.blocked_hosts_capacity,
+      reinterpret_cast<uint64_t*>(data.data() + header.blocked_hosts_offset));
+  WriteTable(disabled_sites_, header.disabled_sites_capacity,
+      reinterpret_cast<uint64_t*>(data.data() + header.disabled_sites_offset));
+
+  Node* nodes = reinterpret_cast<Node*>(data.data() + header.nodes_offset);
+  Edge* edges = reinterpret_cast<Edge*>(data.data() + header.edges_offset);
+  uint32_t next_edge = 0;
+  for (size_t i = 0; i < automaton.size(); ++i) {
+    nodes[i].first_edge = next_edge;
+    nodes[i].edge_count = automaton[i].children.size();
+    nodes[i].fail = automaton[i].fail;
+    nodes[i].match = automaton[i].match;
+    for (const auto& child : automaton[i].children) {
+      edges[next_edge].byte = child.first;
+      edges[next_edge].target = child.second;
+      next_edge++;
+    }
+  }
+  return data;
+}
+
+}  // namespace brave
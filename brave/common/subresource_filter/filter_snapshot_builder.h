@@ -0,0 +1,43 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_SUBRESOURCE_FILTER_FILTER_SNAPSHOT_BUILDER_H_
+#define BRAVE_COMMON_SUBRESOURCE_FILTER_FILTER_SNAPSHOT_BUILDER_H_
+
+#include <stdint.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace brave {
+
+// Compiles filter rules into the layout read by FilterSnapshot.
+class FilterSnapshotBuilder {
+ public:
+  FilterSnapshotBuilder();
+  ~FilterSnapshotBuilder();
+
+  // Blocks third-party requests to |host| and its subdomains.
+  void AddBlockedHost(const std::string& host);
+  // Disables filtering on pages from |host| and its subdomains.
+  void AddDisabledSite(const std::string& host);
+  // Blocks third-party requests whose URL contains |pattern|, ignoring case.
+  void AddPattern(const std::string& pattern);
+
+  std::vector<uint8_t> Build() const;
+
+ private:
+  std::set<uint64_t> blocked_hosts_;
+  std::set<uint64_t> disabled_sites_;
+  std::set<std::string> patterns_;
+
+  DISALLOW_COPY_AND_ASSIGN(FilterSnapshotBuilder);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_SUBRESOURCE_FILTER_FILTER_SNAPSHOT_BUILDER_H_
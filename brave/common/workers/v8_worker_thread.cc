@@ -112,7 +112,7 @@ void V8WorkerThread::CleanUp() {
 
 void V8WorkerThread::OnMemoryPressure(
     base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
-  env()->isolate()->LowMemoryNotification();
+  env()->OnMemoryPressure(memory_pressure_level);
 }
 
 void V8WorkerThread::LoadModule() {
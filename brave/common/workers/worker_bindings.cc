@@ -8,6 +8,7 @@
 #include "brave/common/workers/worker_bindings.h"
 
 #include "atom/browser/api/atom_api_app.h"
+#include "atom/common/perf_counters.h"
 #include "brave/common/workers/v8_worker_thread.h"
 #include "content/child/worker_thread_registry.h"
 #include "content/public/browser/browser_thread.h"
@@ -31,7 +32,31 @@ bool SetReadOnlyProperty(v8::Local<v8::Context> context,
       static_cast<v8::PropertyAttribute>(v8::ReadOnly)));
 }
 
-void OnMessageInternal(const std::pair<uint8_t*, size_t>& buf) {
+// Counts a message as queued for the worker until the task delivering it
+// runs, or is dropped with the worker thread.
+class QueuedMessage {
+ public:
+  QueuedMessage() : posted_(base::TimeTicks::Now()) {
+    atom::PerfCounters::AddToGauge(atom::PerfMetric::WORKER_QUEUE_DEPTH, 1);
+  }
+  ~QueuedMessage() {
+    atom::PerfCounters::AddToGauge(atom::PerfMetric::WORKER_QUEUE_DEPTH, -1);
+  }
+
+  base::TimeTicks posted() const { return posted_; }
+
+ private:
+  base::TimeTicks posted_;
+
+  DISALLOW_COPY_AND_ASSIGN(QueuedMessage);
+};
+
+void OnMessageInternal(QueuedMessage* queued_message,
+                       const std::pair<uint8_t*, size_t>& buf) {
+  atom::PerfCounters::AddTime(
+      atom::PerfMetric::WORKER_QUEUE_TIME,
+      base::TimeTicks::Now() - queued_message->posted());
+
   v8::Isolate* isolate = v8::Isolate::GetCurrent();
   v8::Local<v8::Context> context = isolate->GetCurrentContext();
 
@@ -240,6 +265,7 @@ bool WorkerBindings::OnMessage(v8::Isolate* isolate,
         content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(thread_id);
     task_runner->PostTask(FROM_HERE,
         base::Bind(&OnMessageInternal,
+        base::Owned(new QueuedMessage),
         std::move(buffer)));
     return true;
   }
@@ -6,6 +6,7 @@
 
 #include "atom/renderer/content_settings_manager.h"
 #include "brave/renderer/printing/brave_print_render_frame_helper_delegate.h"
+#include "brave/renderer/subresource_filter/subresource_filter_dispatcher.h"
 #include "chrome/common/render_messages.h"
 #include "chrome/common/secure_origin_whitelist.h"
 #include "chrome/renderer/chrome_render_frame_observer.h"
@@ -17,6 +18,7 @@
 #include "chrome/renderer/plugins/non_loadable_plugin_placeholder.h"
 #include "chrome/renderer/plugins/plugin_uma.h"
 #include "content/public/common/content_constants.h"
+#include "content/public/common/url_loader_throttle.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/render_view.h"
@@ -97,6 +99,9 @@ void BraveContentRendererClient::RenderThreadStarted() {
 
   thread->AddObserver(chrome_observer_.get());
 
+  subresource_filter_dispatcher_.reset(new SubresourceFilterDispatcher());
+  thread->AddObserver(subresource_filter_dispatcher_.get());
+
   prescient_networking_dispatcher_.reset(
       new network_hints::PrescientNetworkingDispatcher());
 
@@ -247,6 +252,13 @@ bool BraveContentRendererClient::WillSendRequest(
   }
 #endif
 
+  // Blocked requests are cancelled by the throttle before they are sent to
+  // the browser.
+  std::unique_ptr<content::URLLoaderThrottle> throttle =
+      subresource_filter_dispatcher_->MaybeCreateThrottle(frame, url);
+  if (throttle)
+    throttles->push_back(std::move(throttle));
+
   return false;
 }
 
@@ -35,6 +35,8 @@ class SpellCheck;
 
 namespace brave {
 
+class SubresourceFilterDispatcher;
+
 class BraveContentRendererClient : public ChromeContentRendererClient {
  public:
   BraveContentRendererClient();
@@ -73,6 +75,8 @@ class BraveContentRendererClient : public ChromeContentRendererClient {
   std::unique_ptr<network_hints::PrescientNetworkingDispatcher>
       prescient_networking_dispatcher_;
 
+  std::unique_ptr<SubresourceFilterDispatcher> subresource_filter_dispatcher_;
+
   DISALLOW_COPY_AND_ASSIGN(BraveContentRendererClient);
 };
 
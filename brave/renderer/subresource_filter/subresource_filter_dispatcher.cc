@@ -0,0 +1,127 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/renderer/subresource_filter/subresource_filter_dispatcher.h"
+
+#include <utility>
+
+#include "atom/common/api/api_messages.h"
+#include "content/public/common/resource_request.h"
+#include "content/public/common/url_loader_throttle.h"
+#include "ipc/ipc_message_macros.h"
+#include "net/base/net_errors.h"
+#include "net/url_request/redirect_info.h"
+#include "third_party/WebKit/public/platform/WebSecurityOrigin.h"
+#include "third_party/WebKit/public/web/WebFrame.h"
+#include "third_party/WebKit/public/web/WebLocalFrame.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace brave {
+
+namespace {
+
+class SubresourceFilterThrottle : public content::URLLoaderThrottle {
+ public:
+  SubresourceFilterThrottle(scoped_refptr<SubresourceFilterRuleset> ruleset,
+                            const GURL& first_party_url)
+      : ruleset_(std::move(ruleset)),
+        first_party_url_(first_party_url) {}
+  ~SubresourceFilterThrottle() override {}
+
+  // content::URLLoaderThrottle:
+  void WillStartRequest(const content::ResourceRequest& request,
+                        bool* defer) override {
+    MaybeCancel(request.url);
+  }
+
+  void WillRedirectRequest(const net::RedirectInfo& redirect_info,
+                           bool* defer) override {
+    MaybeCancel(redirect_info.new_url);
+  }
+
+ private:
+  void MaybeCancel(const GURL& url) {
+    if (ruleset_->snapshot().ShouldBlock(url, first_party_url_))
+      delegate_->CancelWithError(net::ERR_BLOCKED_BY_CLIENT);
+  }
+
+  scoped_refptr<SubresourceFilterRuleset> ruleset_;
+  GURL first_party_url_;
+
+  DISALLOW_COPY_AND_ASSIGN(SubresourceFilterThrottle);
+};
+
+}  // namespace
+
+// static
+scoped_refptr<SubresourceFilterRuleset> SubresourceFilterRuleset::Create(
+    const base::SharedMemoryHandle& handle, uint32_t size, int version) {
+  if (!handle.IsValid())
+    return nullptr;
+
+  std::unique_ptr<base::SharedMemory> memory(
+      new base::SharedMemory(handle, true /* read_only */));
+  if (!memory->Map(size))
+    return nullptr;
+
+  scoped_refptr<SubresourceFilterRuleset> ruleset(
+      new SubresourceFilterRuleset(std::move(memory), version));
+  if (!ruleset->snapshot_.Init(ruleset->memory_->memory(), size))
+    return nullptr;
+
+  return ruleset;
+}
+
+SubresourceFilterRuleset::SubresourceFilterRuleset(
+    std::unique_ptr<base::SharedMemory> memory, int version)
+    : memory_(std::move(memory)),
+      version_(version) {}
+
+SubresourceFilterRuleset::~SubresourceFilterRuleset() {}
+
+SubresourceFilterDispatcher::SubresourceFilterDispatcher() {}
+
+SubresourceFilterDispatcher::~SubresourceFilterDispatcher() {}
+
+std::unique_ptr<content::URLLoaderThrottle>
+SubresourceFilterDispatcher::MaybeCreateThrottle(blink::WebLocalFrame* frame,
+                                                 const GURL& url) {
+  if (!ruleset_ || !frame ||
+      !(url.SchemeIsHTTPOrHTTPS() || url.SchemeIsWSOrWSS()))
+    return nullptr;
+
+  // Requests are classified against the top level page, which may be in
+  // another process so only its origin is available.
+  GURL first_party_url =
+      url::Origin(frame->Top()->GetSecurityOrigin()).GetURL();
+
+  return std::unique_ptr<content::URLLoaderThrottle>(
+      new SubresourceFilterThrottle(ruleset_, first_party_url));
+}
+
+bool SubresourceFilterDispatcher::OnControlMessageReceived(
+    const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(SubresourceFilterDispatcher, message)
+    IPC_MESSAGE_HANDLER(AtomMsg_UpdateSubresourceFilter,
+                        OnUpdateSubresourceFilter)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void SubresourceFilterDispatcher::OnUpdateSubresourceFilter(
+    const base::SharedMemoryHandle& handle,
+    uint32_t size,
+    int version) {
+  if (ruleset_ && ruleset_->version() >= version)
+    return;
+
+  // An invalid handle clears the filter. Requests already in flight keep
+  // the snapshot they started with.
+  ruleset_ = SubresourceFilterRuleset::Create(handle, size, version);
+}
+
+}  // namespace brave
@@ -0,0 +1,84 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_RENDERER_SUBRESOURCE_FILTER_SUBRESOURCE_FILTER_DISPATCHER_H_
+#define BRAVE_RENDERER_SUBRESOURCE_FILTER_SUBRESOURCE_FILTER_DISPATCHER_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/shared_memory.h"
+#include "brave/common/subresource_filter/filter_snapshot.h"
+#include "content/public/renderer/render_thread_observer.h"
+
+class GURL;
+
+namespace blink {
+class WebLocalFrame;
+}
+
+namespace content {
+class URLLoaderThrottle;
+}
+
+namespace brave {
+
+// A filter snapshot mapped read-only from the region published by the
+// browser. Throttles keep a reference so a newer snapshot can be swapped in
+// while requests are still using the old one.
+class SubresourceFilterRuleset
+    : public base::RefCountedThreadSafe<SubresourceFilterRuleset> {
+ public:
+  static scoped_refptr<SubresourceFilterRuleset> Create(
+      const base::SharedMemoryHandle& handle, uint32_t size, int version);
+
+  const FilterSnapshot& snapshot() const { return snapshot_; }
+  int version() const { return version_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<SubresourceFilterRuleset>;
+
+  SubresourceFilterRuleset(std::unique_ptr<base::SharedMemory> memory,
+                           int version);
+  ~SubresourceFilterRuleset();
+
+  std::unique_ptr<base::SharedMemory> memory_;
+  FilterSnapshot snapshot_;
+  int version_;
+
+  DISALLOW_COPY_AND_ASSIGN(SubresourceFilterRuleset);
+};
+
+// Receives filter snapshots from the browser and cancels blocked
+// subresource requests before they leave the renderer.
+class SubresourceFilterDispatcher : public content::RenderThreadObserver {
+ public:
+  SubresourceFilterDispatcher();
+  ~SubresourceFilterDispatcher() override;
+
+  // Returns a throttle that cancels the request for |url| from |frame|, or
+  // any redirect of it, if the current snapshot blocks it. Returns null when
+  // there is nothing to filter.
+  std::unique_ptr<content::URLLoaderThrottle> MaybeCreateThrottle(
+      blink::WebLocalFrame* frame, const GURL& url);
+
+ private:
+  // content::RenderThreadObserver:
+  bool OnControlMessageReceived(const IPC::Message& message) override;
+
+  void OnUpdateSubresourceFilter(const base::SharedMemoryHandle& handle,
+                                 uint32_t size,
+                                 int version);
+
+  scoped_refptr<SubresourceFilterRuleset> ruleset_;
+
+  DISALLOW_COPY_AND_ASSIGN(SubresourceFilterDispatcher);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_RENDERER_SUBRESOURCE_FILTER_SUBRESOURCE_FILTER_DISPATCHER_H_
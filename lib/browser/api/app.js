@@ -23,6 +23,9 @@ Object.assign(app, {
   getApplicationMenu () {
     return Menu.getApplicationMenu()
   },
+  getRemoteSyncCallCounts () {
+    return require('../rpc-server').getSyncCallCounts()
+  },
   commandLine: {
     appendSwitch: bindings.appendSwitch,
     appendArgument: bindings.appendArgument
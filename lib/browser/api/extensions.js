@@ -2,7 +2,6 @@ const {app, BrowserWindow, ipcMain, webContents, session, protocol} = require('e
 const path = require('path')
 const browserActions = require('./browser-actions')
 const assert = require('assert')
-const deepEqual = require('../../common/deep-equal')
 
 // List of currently active background pages by extensionId
 var backgroundPages = {}
@@ -113,7 +112,9 @@ const createTabValue = function (tab) {
 
   tabs[tabId] = {}
   tabs[tabId].webContents = tab
-  tabs[tabId].tabValue = getTabValue(tabId)
+  // primes the native tab state that later updates are diffed against
+  const update = !tab.isDestroyed() && tab.updateTabValue()
+  tabs[tabId].tabValue = update ? update.tab : getTabValue(tabId)
   sendToBackgroundPages('all', getSessionForTab(tabId), 'chrome-tabs-created', tabs[tabId].tabValue)
   return tabId
 }
@@ -225,11 +226,13 @@ const createTab = function (createProperties, cb) {
   if (!error && createProperties.partition) {
     // createProperties.partition always takes precendence
     ses = session.fromPartition(createProperties.partition, {
-      parent_partition: createProperties.parent_partition
+      parent_partition: createProperties.parent_partition,
+      ephemeral: createProperties.ephemeral
     })
     // don't pass the partition info through
     delete createProperties.partition
     delete createProperties.parent_partition
+    delete createProperties.ephemeral
   }
 
   if (error) {
@@ -291,21 +294,19 @@ const chromeTabsUpdated = function (tabId) {
     return
   }
 
-  let oldTabInfo = tab.tabValue
-  if (!oldTabInfo) {
+  if (!tab.tabValue || tab.webContents.isDestroyed()) {
     return
   }
 
-  let tabValue = getTabValue(tabId)
-  tabs[tabId].tabValue = tabValue
-  let changeInfo = {}
-
-  for (var key in tabValue) {
-    if (!deepEqual(tabValue[key], oldTabInfo[key])) {
-      changeInfo[key] = tabValue[key]
-    }
+  // the tab state is diffed natively, null means nothing changed
+  const update = tab.webContents.updateTabValue()
+  if (!update) {
+    return
   }
 
+  const {changeInfo, tab: tabValue} = update
+  tabs[tabId].tabValue = tabValue
+
   if (Object.keys(changeInfo).length > 0) {
     if (changeInfo.active) {
       sendToBackgroundPages('all', getSessionForTab(tabId), 'chrome-tabs-activated', tabId, {tabId: tabId, windowId: tabValue.windowId})
@@ -337,8 +338,6 @@ Array.prototype.diff = function(a) {
 };
 
 const tabsQuery = function (queryInfo = {}, useCurrentWindowId = false) {
-  var tabIds = Object.keys(tabs)
-
   // convert current window identifier to the actual current window id
   if (queryInfo.windowId === -2 || queryInfo.currentWindow === true) {
     delete queryInfo.currentWindow
@@ -349,22 +348,23 @@ const tabsQuery = function (queryInfo = {}, useCurrentWindowId = false) {
   }
 
   var queryKeys = Object.keys(queryInfo)
-  // get the values for all tabs
-  var tabValues = tabIds.reduce((tabs, tabId) => {
-    tabs[tabId] = getTabValue(tabId) || {}
-    return tabs
-  }, {})
-
+  // the native index narrows the candidates down (by window first) so only
+  // the matching tabs need a full tab value
   var result = []
-  tabIds.forEach((tabId) => {
-    // never add the master Brave container window
-    if (tabValues[tabId].url.startsWith('chrome://brave')) {
+  webContents.queryTabs(queryInfo).forEach((tab) => {
+    const tabId = tab.getId()
+    if (!tabs[tabId]) {
+      return
+    }
+
+    const tabValue = getTabValue(tabId)
+    if (!tabValue) {
       return
     }
 
     // delete tab from the list if any key doesn't match
-    if (!queryKeys.map((queryKey) => (tabValues[tabId][queryKey] === queryInfo[queryKey])).includes(false)) {
-      result.push(tabValues[tabId])
+    if (!queryKeys.map((queryKey) => (tabValue[queryKey] === queryInfo[queryKey])).includes(false)) {
+      result.push(tabValue)
     }
   })
 
@@ -521,6 +521,10 @@ tabEvents.forEach((event_name) => {
   })
 })
 
+// Requests fail with net::ERR_TIMED_OUT when the extension doesn't answer
+const PROTOCOL_HANDLER_TIMEOUT = 30000
+const ERR_TIMED_OUT = -7
+
 ipcMain.on('register-protocol-string-handler', function (evt, scheme) {
   const sender = evt.sender
   if (evt.sender.isDestroyed()) {
@@ -539,11 +543,17 @@ ipcMain.on('register-protocol-string-handler', function (evt, scheme) {
     if (sender.isDestroyed()) {
       cb('')
     } else {
-      ipcMain.once('chrome-protocol-handled-' + requestId, (evt, data) => {
+      const channel = 'chrome-protocol-handled-' + requestId
+      const onHandled = (evt, data) => {
+        clearTimeout(timeout)
         cb(data)
-      })
+      }
+      const timeout = setTimeout(() => {
+        ipcMain.removeListener(channel, onHandled)
+        cb(ERR_TIMED_OUT)
+      }, PROTOCOL_HANDLER_TIMEOUT)
+      ipcMain.once(channel, onHandled)
       sender.send('chrome-protocol-handler-' + scheme, request, requestId)
-      // TODO(bridiver) - timeout??
     }
   })
 })
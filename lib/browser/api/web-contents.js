@@ -235,6 +235,10 @@ module.exports = {
     return binding.fromTabID(tabID)
   },
 
+  queryTabs (queryInfo = {}) {
+    return binding.queryTabs(queryInfo)
+  },
+
   getFocusedWebContents () {
     let focused = null
     for (let contents of binding.getAllWebContents()) {
@@ -249,5 +253,17 @@ module.exports = {
 
   getAllWebContents () {
     return binding.getAllWebContents()
+  },
+
+  sendToAll (targets, channel, ...args) {
+    if (targets == null) throw new Error('Missing required `targets` argument')
+    if (channel == null) throw new Error('Missing required `channel` argument')
+    if (!Array.isArray(targets)) {
+      const session = targets
+      targets = binding.getAllWebContents().filter((contents) => {
+        return contents.session === session
+      })
+    }
+    return binding._sendToAll(targets, channel, args)
   }
 }
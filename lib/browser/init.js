@@ -19,6 +19,22 @@ if (index > -1) {
   process.argv.push(removedItem)
 }
 
+// Trace the modules required until the app's main script has loaded when
+// startup is being traced.
+const tracing = process.atomBinding('content_tracing')
+const originalLoad = Module._load
+const tracedLoad = function (request) {
+  tracing._beginStartupEvent('Module._load', request)
+  try {
+    return originalLoad.apply(this, arguments)
+  } finally {
+    tracing._endStartupEvent('Module._load')
+  }
+}
+if (tracing._isStartupTracing()) {
+  Module._load = tracedLoad
+}
+
 // Clear search paths.
 require('../common/reset-search-paths')
 
@@ -168,3 +184,7 @@ if (process.platform === 'linux' && process.env.XDG_CURRENT_DESKTOP === 'Pantheo
 
 // Finally load app's main.js and transfer control to C++.
 Module._load(path.join(packagePath, mainStartupScript), Module, true)
+
+if (Module._load === tracedLoad) {
+  Module._load = originalLoad
+}
@@ -2,99 +2,78 @@
 
 const v8Util = process.atomBinding('v8_util')
 
+// The objects are kept by a native registry which hands out generation
+// tagged ids, so an id from a renderer never resolves to an object that was
+// registered after the original one was released.
 class ObjectsRegistry {
   constructor () {
-    this.nextId = 0
+    this.registry = v8Util.createRemoteObjectRegistry()
 
-    // Stores all objects by ref-counting.
-    // (id) => {object, count}
-    this.storage = {}
+    // The WebContents whose references are released when destroyed.
+    this.owners = new Set()
 
-    // Stores the IDs of objects referenced by WebContents.
-    // (webContentsId) => [id]
-    this.owners = {}
+    // The prototype shapes sent to each WebContents.
+    // webContentsId => Map(shapeId => shape)
+    this.sentShapes = new Map()
   }
 
   // Register a new object and return its assigned ID. If the object is already
   // registered then the already assigned ID would be returned.
   add (webContents, obj) {
-    // Get or assign an ID to the object.
-    let id = this.saveToStorage(obj)
-
-    // Add object to the set of referenced objects.
     let webContentsId = webContents.getId()
-    let owner = this.owners[webContentsId]
-    if (!owner) {
-      owner = this.owners[webContentsId] = new Set()
-      // Clear the storage when webContents is reloaded/navigated.
+    if (!this.owners.has(webContentsId)) {
+      this.owners.add(webContentsId)
+      // Clear the storage when webContents is destroyed.
       webContents.once('will-destroy', () => {
         this.clear(webContentsId)
       })
     }
-    if (!owner.has(id)) {
-      owner.add(id)
-      // Increase reference count if not referenced before.
-      this.storage[id].count++
-    }
-    return id
+    return this.registry.add(webContentsId, obj)
   }
 
-  // Get an object according to its ID.
+  // Get an object according to its ID. Returns undefined if the object has
+  // been released.
   get (id) {
-    return this.storage[id].object
+    return this.registry.get(id)
   }
 
   // Dereference an object according to its ID.
   remove (webContentsId, id) {
-    // don't let an owner remove itself
-    if (webContentsId === id)
-      return
-
-    // Dereference from the storage.
-    this.dereference(id)
-
-    // Also remove the reference in owner.
-    let owner = this.owners[webContentsId]
-    if (owner) {
-      owner.delete(id)
-    }
+    this.registry.remove(webContentsId, id)
   }
 
   // Clear all references to objects refrenced by the WebContents.
   clear (webContentsId) {
-    let owner = this.owners[webContentsId]
-    if (!owner) return
-
-    for (let id of owner) this.dereference(id)
-
-    delete this.owners[webContentsId]
-  }
-
-  // Private: Saves the object into storage and assigns an ID for it.
-  saveToStorage (object) {
-    let id = v8Util.getHiddenValue(object, 'atomId')
-    if (!id) {
-      id = ++this.nextId
-      this.storage[id] = {
-        count: 0,
-        object: object
+    this.owners.delete(webContentsId)
+    this.registry.clear(webContentsId)
+
+    // A shape is released once no WebContents can ask for it.
+    const shapes = this.sentShapes.get(webContentsId)
+    if (shapes) {
+      this.sentShapes.delete(webContentsId)
+      for (const shape of shapes.values()) {
+        if (--shape.senders === 0) shape.release()
       }
-      v8Util.setHiddenValue(object, 'atomId', id)
     }
-    return id
   }
 
-  // Private: Dereference the object from store.
-  dereference (id) {
-    let pointer = this.storage[id]
-    if (pointer == null) {
-      return
-    }
-    pointer.count -= 1
-    if (pointer.count === 0) {
-      v8Util.deleteHiddenValue(pointer.object, 'atomId')
-      return delete this.storage[id]
+  // Returns true the first time |shape| is sent to the WebContents.
+  markShapeSent (webContentsId, shape) {
+    let shapes = this.sentShapes.get(webContentsId)
+    if (!shapes) {
+      shapes = new Map()
+      this.sentShapes.set(webContentsId, shapes)
     }
+    if (shapes.has(shape.id)) return false
+    shapes.set(shape.id, shape)
+    shape.senders++
+    return true
+  }
+
+  // Returns the shape with |shapeId| if it was sent to the WebContents.
+  getSentShape (webContentsId, shapeId) {
+    const shapes = this.sentShapes.get(webContentsId)
+    return shapes ? shapes.get(shapeId) : undefined
   }
 }
 
@@ -42,14 +42,83 @@ let getObjectMembers = function (object) {
   })
 }
 
-// Return the description of object's prototype.
-let getObjectPrototype = function (object) {
+// The member descriptors of prototypes, which are shared by every object
+// created from the same class. Shapes are kept while a renderer may still ask
+// for them.
+// signature => {id, members, senders, release}
+const shapes = new Map()
+let nextShapeId = 0
+
+// The members last computed for each prototype, with the property names and
+// descriptors they were computed from.
+// proto => {names, descriptors, members, signature}
+const prototypeMembers = new WeakMap()
+
+// Whether the own properties of a prototype are still the ones its members
+// were computed from.
+let hasSameProperties = function (proto, cached) {
+  const names = Object.getOwnPropertyNames(proto)
+  if (names.length !== cached.names.length) return false
+  for (let i = 0; i < names.length; i++) {
+    if (names[i] !== cached.names[i]) return false
+    const descriptor = Object.getOwnPropertyDescriptor(proto, names[i])
+    const old = cached.descriptors[i]
+    if (descriptor.value !== old.value || descriptor.get !== old.get ||
+        descriptor.set !== old.set || descriptor.writable !== old.writable ||
+        descriptor.enumerable !== old.enumerable) {
+      return false
+    }
+  }
+  return true
+}
+
+// Return the shape of a prototype's own members. Shapes are keyed on the
+// members themselves, so adding, removing or changing a member of a
+// prototype gives it another shape. Its own prototype is described
+// separately. The members are only described again when the prototype's
+// properties changed.
+let getPrototypeShape = function (proto) {
+  let cached = prototypeMembers.get(proto)
+  if (!cached || !hasSameProperties(proto, cached)) {
+    const names = Object.getOwnPropertyNames(proto)
+    const members = getObjectMembers(proto)
+    cached = {
+      names,
+      descriptors: names.map((name) => Object.getOwnPropertyDescriptor(proto, name)),
+      members,
+      signature: JSON.stringify(members)
+    }
+    prototypeMembers.set(proto, cached)
+  }
+
+  const {members, signature} = cached
+  let shape = shapes.get(signature)
+  if (!shape) {
+    shape = {
+      id: ++nextShapeId,
+      members,
+      senders: 0,
+      release: () => shapes.delete(signature)
+    }
+    shapes.set(signature, shape)
+  }
+  return shape
+}
+
+// Return the description of object's prototype. The members of each shape
+// are only sent the first time a renderer sees it.
+let getObjectPrototype = function (sender, object) {
   let proto = Object.getPrototypeOf(object)
   if (proto === null || proto === Object.prototype) return null
-  return {
-    members: getObjectMembers(proto),
-    proto: getObjectPrototype(proto)
+  const shape = getPrototypeShape(proto)
+  const descriptor = {
+    shape: shape.id,
+    proto: getObjectPrototype(sender, proto)
+  }
+  if (objectsRegistry.markShapeSent(sender.getId(), shape)) {
+    descriptor.members = shape.members
   }
+  return descriptor
 }
 
 // Convert a real value into meta data.
@@ -90,7 +159,7 @@ let valueToMeta = function (sender, value, optimizeSimpleObject = false) {
     // it.
     meta.id = objectsRegistry.add(sender, value)
     meta.members = getObjectMembers(value)
-    meta.proto = getObjectPrototype(value)
+    meta.proto = getObjectPrototype(sender, value)
   } else if (meta.type === 'buffer') {
     meta.value = Buffer.from(value)
   } else if (meta.type === 'promise') {
@@ -202,21 +271,21 @@ const unwrapArgs = function (sender, args) {
   return args.map(metaToValue)
 }
 
-// Call a function and send reply asynchronously if it's a an asynchronous
-// style function and the caller didn't pass a callback.
-const callFunction = function (event, func, caller, args) {
+// Call a function and reply asynchronously if it's a an asynchronous style
+// function and the caller didn't pass a callback.
+const callFunction = function (sender, func, caller, args, reply) {
   let funcMarkedAsync, funcName, funcPassedCallback, ref, ret
   funcMarkedAsync = v8Util.getHiddenValue(func, 'asynchronous')
   funcPassedCallback = typeof args[args.length - 1] === 'function'
   try {
     if (funcMarkedAsync && !funcPassedCallback) {
       args.push(function (ret) {
-        event.returnValue = valueToMeta(event.sender, ret, true)
+        reply(valueToMeta(sender, ret, true))
       })
       func.apply(caller, args)
     } else {
       ret = func.apply(caller, args)
-      event.returnValue = valueToMeta(event.sender, ret, true)
+      reply(valueToMeta(sender, ret, true))
     }
   } catch (error) {
     // Catch functions thrown further down in function invocation and wrap
@@ -227,123 +296,151 @@ const callFunction = function (event, func, caller, args) {
   }
 }
 
-ipcMain.on('ELECTRON_BROWSER_REQUIRE', function (event, module) {
-  try {
-    event.returnValue = valueToMeta(event.sender, process.mainModule.require(module))
-  } catch (error) {
-    event.returnValue = exceptionToMeta(error)
-  }
-})
-
-ipcMain.on('ELECTRON_BROWSER_GET_BUILTIN', function (event, module) {
-  try {
-    event.returnValue = valueToMeta(event.sender, electron[module])
-  } catch (error) {
-    event.returnValue = exceptionToMeta(error)
-  }
-})
-
-ipcMain.on('ELECTRON_BROWSER_GLOBAL', function (event, name) {
-  try {
-    event.returnValue = valueToMeta(event.sender, global[name])
-  } catch (error) {
-    event.returnValue = exceptionToMeta(error)
-  }
-})
-
-ipcMain.on('ELECTRON_BROWSER_CURRENT_WINDOW', function (event) {
-  try {
-    event.returnValue = valueToMeta(event.sender, event.sender.getOwnerBrowserWindow())
-  } catch (error) {
-    event.returnValue = exceptionToMeta(error)
-  }
-})
-
-ipcMain.on('ELECTRON_BROWSER_CURRENT_WEB_CONTENTS', function (event) {
-  event.returnValue = valueToMeta(event.sender, event.sender)
-})
-
-ipcMain.on('ELECTRON_BROWSER_GET_WEB_CONTENTS', function (event, tabID, responseId) {
-  event.sender.send('ELECTRON_BROWSER_GET_WEB_CONTENTS_RESPONSE_' + responseId,
-      valueToMeta(event.sender, webContents.fromTabID(tabID)))
-})
-
-ipcMain.on('ELECTRON_BROWSER_CONSTRUCTOR', function (event, id, args) {
-  try {
-    args = unwrapArgs(event.sender, args)
+// The remote calls a renderer can make, either synchronously through the
+// ELECTRON_BROWSER_<type> channel or batched in ELECTRON_BROWSER_ASYNC_CALLS.
+// Each handler passes the meta data of its result to |reply|, which may
+// happen later for functions marked asynchronous.
+const remoteHandlers = {
+  REQUIRE (sender, reply, module) {
+    reply(valueToMeta(sender, process.mainModule.require(module)))
+  },
+
+  GET_BUILTIN (sender, reply, module) {
+    reply(valueToMeta(sender, electron[module]))
+  },
+
+  GLOBAL (sender, reply, name) {
+    reply(valueToMeta(sender, global[name]))
+  },
+
+  CURRENT_WINDOW (sender, reply) {
+    reply(valueToMeta(sender, sender.getOwnerBrowserWindow()))
+  },
+
+  CURRENT_WEB_CONTENTS (sender, reply) {
+    reply(valueToMeta(sender, sender))
+  },
+
+  CONSTRUCTOR (sender, reply, id, args) {
+    args = unwrapArgs(sender, args)
     let constructor = objectsRegistry.get(id)
 
     // Call new with array of arguments.
     // http://stackoverflow.com/questions/1606797/use-of-apply-with-new-operator-is-this-possible
     let obj = new (Function.prototype.bind.apply(constructor, [null].concat(args)))
-    event.returnValue = valueToMeta(event.sender, obj)
-  } catch (error) {
-    event.returnValue = exceptionToMeta(error)
-  }
-})
+    reply(valueToMeta(sender, obj))
+  },
 
-ipcMain.on('ELECTRON_BROWSER_FUNCTION_CALL', function (event, id, args) {
-  try {
-    args = unwrapArgs(event.sender, args)
+  FUNCTION_CALL (sender, reply, id, args) {
+    args = unwrapArgs(sender, args)
     let func = objectsRegistry.get(id)
-    callFunction(event, func, global, args)
-  } catch (error) {
-    event.returnValue = exceptionToMeta(error)
-  }
-})
+    callFunction(sender, func, global, args, reply)
+  },
 
-ipcMain.on('ELECTRON_BROWSER_MEMBER_CONSTRUCTOR', function (event, id, method, args) {
-  try {
-    args = unwrapArgs(event.sender, args)
+  MEMBER_CONSTRUCTOR (sender, reply, id, method, args) {
+    args = unwrapArgs(sender, args)
     let constructor = objectsRegistry.get(id)[method]
 
     // Call new with array of arguments.
     let obj = new (Function.prototype.bind.apply(constructor, [null].concat(args)))
-    event.returnValue = valueToMeta(event.sender, obj)
-  } catch (error) {
-    event.returnValue = exceptionToMeta(error)
-  }
-})
+    reply(valueToMeta(sender, obj))
+  },
 
-ipcMain.on('ELECTRON_BROWSER_MEMBER_CALL', function (event, id, method, args) {
-  try {
-    args = unwrapArgs(event.sender, args)
+  MEMBER_CALL (sender, reply, id, method, args) {
+    args = unwrapArgs(sender, args)
     let obj = objectsRegistry.get(id)
     if (!obj) {
-      console.error(`Calling method ${method} with ${args} on WebContents with unknown ID ${id}`)
-      return
+      throw new Error(`Calling method ${method} with ${args} on WebContents with unknown ID ${id}`)
+    }
+    callFunction(sender, obj[method], obj, args, reply)
+  },
+
+  MEMBER_SET (sender, reply, id, name, value) {
+    let obj = objectsRegistry.get(id)
+    obj[name] = value
+    reply(valueToMeta(sender, undefined))
+  },
+
+  MEMBER_GET (sender, reply, id, name) {
+    let obj = objectsRegistry.get(id)
+    reply(valueToMeta(sender, obj[name]))
+  }
+}
+
+const handleRemoteCall = function (sender, type, args, reply) {
+  try {
+    if (!hasProp.call(remoteHandlers, type)) {
+      throw new Error(`Unknown remote call: ${type}`)
     }
-    callFunction(event, obj[method], obj, args)
+    remoteHandlers[type](sender, reply, ...args)
   } catch (error) {
-    event.returnValue = exceptionToMeta(error)
+    reply(exceptionToMeta(error))
+  }
+}
+
+// Number of calls answered through the synchronous channels, by channel.
+// Every one of them blocks the renderer's main thread for the round trip.
+const syncCallCounts = {}
+
+const countSyncCall = function (channel) {
+  syncCallCounts[channel] = (syncCallCounts[channel] || 0) + 1
+}
+
+Object.keys(remoteHandlers).forEach(function (type) {
+  const channel = `ELECTRON_BROWSER_${type}`
+  ipcMain.on(channel, function (event, ...args) {
+    countSyncCall(channel)
+    handleRemoteCall(event.sender, type, args, function (meta) {
+      event.returnValue = meta
+    })
+  })
+})
+
+// |calls| are the [requestId, type, args] queued by a renderer in one
+// microtask turn. The results available right away are sent back in one
+// message, the ones of asynchronous functions follow on their own.
+ipcMain.on('ELECTRON_BROWSER_ASYNC_CALLS', function (event, calls) {
+  const sender = event.sender
+  const webContentsId = sender.getId()
+  const sendResults = function (results) {
+    if (!sender.isDestroyed() && webContentsId === sender.getId()) {
+      sender.send('ELECTRON_RENDERER_ASYNC_RESULTS', results)
+    }
+  }
+
+  let results = []
+  for (const [requestId, type, args] of calls) {
+    handleRemoteCall(sender, type, args || [], function (meta) {
+      if (results) {
+        results.push([requestId, meta])
+      } else {
+        sendResults([[requestId, meta]])
+      }
+    })
   }
+
+  const batch = results
+  results = null
+  if (batch.length > 0) sendResults(batch)
+})
+
+ipcMain.on('ELECTRON_BROWSER_GET_WEB_CONTENTS', function (event, tabID, responseId) {
+  event.sender.send('ELECTRON_BROWSER_GET_WEB_CONTENTS_RESPONSE_' + responseId,
+      valueToMeta(event.sender, webContents.fromTabID(tabID)))
 })
 
 ipcMain.on('ELECTRON_BROWSER_ASYNC_MEMBER_CALL', function (event, tabID, method, args) {
   args = unwrapArgs(event.sender, args)
   let obj = webContents.fromTabID(tabID)
   if (obj) {
-    callFunction(event, obj[method], obj, args)
-  }
-})
-
-ipcMain.on('ELECTRON_BROWSER_MEMBER_SET', function (event, id, name, value) {
-  try {
-    let obj = objectsRegistry.get(id)
-    obj[name] = value
-    event.returnValue = null
-  } catch (error) {
-    event.returnValue = exceptionToMeta(error)
+    callFunction(event.sender, obj[method], obj, args, function (meta) {})
   }
 })
 
-ipcMain.on('ELECTRON_BROWSER_MEMBER_GET', function (event, id, name) {
-  try {
-    let obj = objectsRegistry.get(id)
-    event.returnValue = valueToMeta(event.sender, obj[name])
-  } catch (error) {
-    event.returnValue = exceptionToMeta(error)
-  }
+ipcMain.on('ELECTRON_BROWSER_GET_SHAPE', function (event, shapeId) {
+  countSyncCall('ELECTRON_BROWSER_GET_SHAPE')
+  const shape = objectsRegistry.getSentShape(event.sender.getId(), shapeId)
+  event.returnValue = shape ? shape.members : []
 })
 
 ipcMain.on('ELECTRON_BROWSER_DEREFERENCE', function (event, id) {
@@ -358,3 +455,7 @@ ipcMain.on('ELECTRON_BROWSER_SEND_TO', function (event, sendToAll, webContentsId
     contents.send(channel, ...args)
   }
 })
+
+exports.getSyncCallCounts = function () {
+  return Object.assign({}, syncCallCounts)
+}
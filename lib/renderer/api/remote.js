@@ -93,6 +93,44 @@ const wrapArgs = function (args, visited) {
   return Array.prototype.slice.call(args).map(valueToMeta)
 }
 
+// Asynchronous calls waiting for their result, by request id. Each keeps the
+// values it was called with, so remote objects passed as arguments are not
+// released before the browser has used them.
+const pendingCalls = new Map()
+let nextRequestId = 0
+
+// The calls made in the current microtask turn, sent to the browser in one
+// message when the turn ends.
+let queuedCalls = null
+
+const flushQueuedCalls = function () {
+  if (!queuedCalls) return
+  const calls = queuedCalls
+  queuedCalls = null
+  ipcRenderer.send('ELECTRON_BROWSER_ASYNC_CALLS', calls)
+}
+
+// Make a remote call without blocking, the returned promise settles when
+// the browser replies through ELECTRON_RENDERER_ASYNC_RESULTS.
+const callAsync = function (type, args, values) {
+  return new Promise(function (resolve, reject) {
+    const requestId = ++nextRequestId
+    pendingCalls.set(requestId, {resolve, reject, values})
+    if (!queuedCalls) {
+      queuedCalls = []
+      Promise.resolve().then(flushQueuedCalls)
+    }
+    queuedCalls.push([requestId, type, args])
+  })
+}
+
+// Make a remote call that blocks until the browser replies. Queued
+// asynchronous calls are sent first so they are not overtaken.
+const callSync = function (type, ...args) {
+  flushQueuedCalls()
+  return ipcRenderer.sendSync(`ELECTRON_BROWSER_${type}`, ...args)
+}
+
 // Populate object's members from descriptors.
 // The |ref| will be kept referenced by |members|.
 // This matches |getObjectMemebers| in rpc-server.
@@ -105,11 +143,11 @@ const setObjectMembers = function (ref, object, metaId, members) {
       const remoteMemberFunction = function () {
         if (this && this.constructor === remoteMemberFunction) {
           // Constructor call.
-          let ret = ipcRenderer.sendSync('ELECTRON_BROWSER_MEMBER_CONSTRUCTOR', metaId, member.name, wrapArgs(arguments))
+          let ret = callSync('MEMBER_CONSTRUCTOR', metaId, member.name, wrapArgs(arguments))
           return metaToValue(ret)
         } else {
           // Call member function.
-          let ret = ipcRenderer.sendSync('ELECTRON_BROWSER_MEMBER_CALL', metaId, member.name, wrapArgs(arguments))
+          let ret = callSync('MEMBER_CALL', metaId, member.name, wrapArgs(arguments))
           return metaToValue(ret)
         }
       }
@@ -128,13 +166,13 @@ const setObjectMembers = function (ref, object, metaId, members) {
       descriptor.configurable = true
     } else if (member.type === 'get') {
       descriptor.get = function () {
-        return metaToValue(ipcRenderer.sendSync('ELECTRON_BROWSER_MEMBER_GET', metaId, member.name))
+        return metaToValue(callSync('MEMBER_GET', metaId, member.name))
       }
 
       // Only set setter when it is writable.
       if (member.writable) {
         descriptor.set = function (value) {
-          ipcRenderer.sendSync('ELECTRON_BROWSER_MEMBER_SET', metaId, member.name, value)
+          callSync('MEMBER_SET', metaId, member.name, value)
           return value
         }
       }
@@ -144,12 +182,32 @@ const setObjectMembers = function (ref, object, metaId, members) {
   }
 }
 
+// Member descriptors of remote prototypes by shape id. The browser only
+// sends the members of a shape the first time, later descriptors only carry
+// the id.
+const prototypeShapes = new Map()
+
+const getShapeMembers = function (descriptor) {
+  if (descriptor.members) {
+    prototypeShapes.set(descriptor.shape, descriptor.members)
+    return descriptor.members
+  }
+
+  let members = prototypeShapes.get(descriptor.shape)
+  if (!members) {
+    // The shape was sent to a previous page in this WebContents
+    members = callSync('GET_SHAPE', descriptor.shape)
+    prototypeShapes.set(descriptor.shape, members)
+  }
+  return members
+}
+
 // Populate object's prototype from descriptor.
 // This matches |getObjectPrototype| in rpc-server.
 const setObjectPrototype = function (ref, object, metaId, descriptor) {
   if (descriptor === null) return
   let proto = {}
-  setObjectMembers(ref, proto, metaId, descriptor.members)
+  setObjectMembers(ref, proto, metaId, getShapeMembers(descriptor))
   setObjectPrototype(ref, proto, metaId, descriptor.proto)
   Object.setPrototypeOf(object, proto)
 }
@@ -162,7 +220,7 @@ const proxyFunctionProperties = function (remoteMemberFunction, metaId, name) {
   const loadRemoteProperties = () => {
     if (loaded) return
     loaded = true
-    const meta = ipcRenderer.sendSync('ELECTRON_BROWSER_MEMBER_GET', metaId, name)
+    const meta = callSync('MEMBER_GET', metaId, name)
     if (Array.isArray(meta.members)) {
       setObjectMembers(remoteMemberFunction, remoteMemberFunction, meta.id, meta.members)
     }
@@ -225,14 +283,14 @@ const metaToValue = function (meta) {
         let remoteFunction = function () {
           if (this && this.constructor === remoteFunction) {
             // Constructor call.
-            let obj = ipcRenderer.sendSync('ELECTRON_BROWSER_CONSTRUCTOR', meta.id, wrapArgs(arguments))
+            let obj = callSync('CONSTRUCTOR', meta.id, wrapArgs(arguments))
             // Returning object in constructor will replace constructed object
             // with the returned object.
             // http://stackoverflow.com/questions/1978049/what-values-can-a-constructor-return-to-avoid-returning-this
             return metaToValue(obj)
           } else {
             // Function call.
-            let obj = ipcRenderer.sendSync('ELECTRON_BROWSER_FUNCTION_CALL', meta.id, wrapArgs(arguments))
+            let obj = callSync('FUNCTION_CALL', meta.id, wrapArgs(arguments))
             return metaToValue(obj)
           }
         }
@@ -289,25 +347,39 @@ ipcRenderer.on('ELECTRON_RENDERER_RELEASE_CALLBACK', function (event, id) {
   callbacksRegistry.remove(id)
 })
 
+// Browser replies to asynchronous calls.
+ipcRenderer.on('ELECTRON_RENDERER_ASYNC_RESULTS', function (event, results) {
+  for (const [requestId, meta] of results) {
+    const call = pendingCalls.get(requestId)
+    if (!call) continue
+    pendingCalls.delete(requestId)
+    try {
+      call.resolve(metaToValue(meta))
+    } catch (error) {
+      call.reject(error)
+    }
+  }
+})
+
 var binding = {}
 
 binding.require = function (module) {
-  return metaToValue(ipcRenderer.sendSync('ELECTRON_BROWSER_REQUIRE', module))
+  return metaToValue(callSync('REQUIRE', module))
 }
 
 // Alias to remote.require('electron').xxx.
 binding.getBuiltin = function (module) {
-  return metaToValue(ipcRenderer.sendSync('ELECTRON_BROWSER_GET_BUILTIN', module))
+  return metaToValue(callSync('GET_BUILTIN', module))
 }
 
 // Get current BrowserWindow.
 binding.getCurrentWindow = function () {
-  return metaToValue(ipcRenderer.sendSync('ELECTRON_BROWSER_CURRENT_WINDOW'))
+  return metaToValue(callSync('CURRENT_WINDOW'))
 }
 
 // Get current WebContents object.
 binding.getCurrentWebContents = function () {
-  return metaToValue(ipcRenderer.sendSync('ELECTRON_BROWSER_CURRENT_WEB_CONTENTS'))
+  return metaToValue(callSync('CURRENT_WEB_CONTENTS'))
 }
 
 binding.getWebContents = function (tabId, cb) {
@@ -315,13 +387,73 @@ binding.getWebContents = function (tabId, cb) {
   ipcRenderer.on('ELECTRON_BROWSER_GET_WEB_CONTENTS_RESPONSE_' + responseId, (evt, res) => {
     cb(metaToValue(res))
   })
+  flushQueuedCalls()
   ipcRenderer.send('ELECTRON_BROWSER_GET_WEB_CONTENTS', tabId, responseId)
 }
 
 binding.callAsyncWebContentsFunction = function (tabId, name, ...args) {
+  flushQueuedCalls()
   ipcRenderer.send('ELECTRON_BROWSER_ASYNC_MEMBER_CALL', tabId, name, wrapArgs(...args))
 }
 
+const getRemoteId = function (value) {
+  return value != null ? privates(value).atomId : undefined
+}
+
+const notRemote = function (value) {
+  return Promise.reject(new TypeError(`${value} is not a remote object`))
+}
+
+// Promise based versions of the calls above, they never block the renderer.
+// Calls made in the same microtask turn are sent to the browser together.
+binding.async = {
+  require (module) {
+    return callAsync('REQUIRE', [module])
+  },
+
+  getBuiltin (module) {
+    return callAsync('GET_BUILTIN', [module])
+  },
+
+  getGlobal (name) {
+    return callAsync('GLOBAL', [name])
+  },
+
+  getCurrentWindow () {
+    return callAsync('CURRENT_WINDOW', [])
+  },
+
+  getCurrentWebContents () {
+    return callAsync('CURRENT_WEB_CONTENTS', [])
+  },
+
+  // Call the remote function |func| with |args|.
+  call (func, ...args) {
+    const id = getRemoteId(func)
+    if (!id) return notRemote(func)
+    return callAsync('FUNCTION_CALL', [id, wrapArgs(args)], [func, args])
+  },
+
+  // Call the method |name| of the remote object |object| with |args|.
+  callMethod (object, name, ...args) {
+    const id = getRemoteId(object)
+    if (!id) return notRemote(object)
+    return callAsync('MEMBER_CALL', [id, name, wrapArgs(args)], [object, args])
+  },
+
+  get (object, name) {
+    const id = getRemoteId(object)
+    if (!id) return notRemote(object)
+    return callAsync('MEMBER_GET', [id, name], [object])
+  },
+
+  set (object, name, value) {
+    const id = getRemoteId(object)
+    if (!id) return notRemote(object)
+    return callAsync('MEMBER_SET', [id, name, value], [object])
+  }
+}
+
 const deprecatedRemoteAPIs = ['Menu', 'shell', 'screen', 'clipboard', 'session', 'BrowserWindow']
 for (var i = 0, len = deprecatedRemoteAPIs.length; i < len; i++) {
   const name = deprecatedRemoteAPIs[i]
@@ -0,0 +1,50 @@
+#!/usr/bin/env python
+
+# Runs the IPC payload conversion benchmark in script/bench-ipc and prints the
+# median and fastest round trip per payload, e.g.
+#   script/bench-ipc.py -R --runs=10 --iterations=500
+
+import os
+import subprocess
+import sys
+
+from lib.util import electron_gyp
+
+
+SOURCE_ROOT = os.path.abspath(os.path.dirname(os.path.dirname(__file__)))
+
+PROJECT_NAME = electron_gyp()['project_name%']
+PRODUCT_NAME = electron_gyp()['product_name%']
+
+
+def main():
+  os.chdir(SOURCE_ROOT)
+
+  config = 'D'
+  args = sys.argv[1:]
+  if '-R' in args:
+    config = 'R'
+    args.remove('-R')
+
+  if sys.platform == 'darwin':
+    electron = os.path.join(SOURCE_ROOT, 'out', config,
+                              '{0}.app'.format(PRODUCT_NAME), 'Contents',
+                              'MacOS', PRODUCT_NAME)
+  elif sys.platform == 'win32':
+    electron = os.path.join(SOURCE_ROOT, 'out', config,
+                              '{0}.exe'.format(PROJECT_NAME))
+  else:
+    electron = os.path.join(SOURCE_ROOT, 'out', config, PROJECT_NAME)
+
+  app = os.path.join(SOURCE_ROOT, 'script', 'bench-ipc')
+  try:
+    subprocess.check_call([electron, app] + args)
+  except subprocess.CalledProcessError as e:
+    return e.returncode
+  except KeyboardInterrupt:
+    pass
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
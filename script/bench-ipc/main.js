@@ -0,0 +1,23 @@
+// Times ipcRenderer.sendSync round trips of the payloads in
+// spec/fixtures/module/ipc-payloads.js and prints the results as JSON.
+const {app, ipcMain, BrowserWindow} = require('electron')
+const path = require('path')
+
+ipcMain.on('echo', function (event, msg) {
+  event.returnValue = msg
+})
+
+ipcMain.on('results', function (event, results) {
+  console.log(JSON.stringify(results, null, 2))
+  app.exit(0)
+})
+
+ipcMain.on('error', function (event, message) {
+  console.error(message)
+  app.exit(1)
+})
+
+app.on('ready', function () {
+  const w = new BrowserWindow({show: false})
+  w.loadURL(`file://${path.join(__dirname, 'index.html')}?${process.argv.slice(2).join('&')}`)
+})
@@ -1,5 +1,6 @@
 const assert = require('assert')
 const ChildProcess = require('child_process')
+const http = require('http')
 const https = require('https')
 const net = require('net')
 const fs = require('fs')
@@ -334,4 +335,216 @@ describe('app module', function () {
       assert.equal(typeof app.isAccessibilitySupportEnabled(), 'boolean')
     })
   })
+
+  describe('app.setSubresourceFilter(rules)', function () {
+    afterEach(function () {
+      app.setSubresourceFilter(null)
+    })
+
+    it('returns an increasing version for each update', function () {
+      const first = app.setSubresourceFilter({
+        blockedHosts: ['ads.example.com'],
+        patterns: ['/banner/'],
+        disabledSites: ['example.org']
+      })
+      const second = app.setSubresourceFilter({blockedHosts: []})
+      const cleared = app.setSubresourceFilter(null)
+      assert(second > first)
+      assert(cleared > second)
+    })
+
+    it('throws when a rule list is not an array of strings', function () {
+      assert.throws(function () {
+        app.setSubresourceFilter({blockedHosts: [1]})
+      }, /blockedHosts must be an array of strings/)
+      assert.throws(function () {
+        app.setSubresourceFilter({patterns: 'ads'})
+      }, /patterns must be an array of strings/)
+    })
+
+    describe('in pages', function () {
+      let server = null
+      let port = 0
+      let requests = []
+      let w = null
+      let consoleMessages = []
+
+      before(function (done) {
+        server = http.createServer(function (req, res) {
+          requests.push(req.url)
+          if (req.url === '/') {
+            res.writeHead(200, {'Content-Type': 'text/html'})
+            res.end('<html><head></head><body></body></html>')
+          } else {
+            res.writeHead(200, {'Content-Type': 'application/javascript'})
+            res.end('// script')
+          }
+        })
+        server.listen(0, '127.0.0.1', function () {
+          port = server.address().port
+          done()
+        })
+      })
+
+      after(function () {
+        server.close()
+      })
+
+      beforeEach(function (done) {
+        requests = []
+        consoleMessages = []
+        w = new BrowserWindow({show: false})
+        w.webContents.on('console-message', function (event, level, message) {
+          consoleMessages.push(message)
+        })
+        w.webContents.once('did-finish-load', function () {
+          done()
+        })
+        w.loadURL(`http://127.0.0.1:${port}/`)
+      })
+
+      afterEach(function () {
+        return closeWindow(w).then(function () { w = null })
+      })
+
+      // Loads |url| as a script in the page, from 127.0.0.1, and calls back
+      // with whether it loaded and the path the server would have seen.
+      let count = 0
+      const loadScript = function (url, callback) {
+        const src = `${url}?n=${count++}`
+        const onMessage = function (event, level, message) {
+          if (message === `loaded ${src}` || message === `failed ${src}`) {
+            w.webContents.removeListener('console-message', onMessage)
+            callback(message === `loaded ${src}`, src.substr(src.indexOf('/', 'http://'.length)))
+          }
+        }
+        w.webContents.on('console-message', onMessage)
+        w.webContents.executeJavaScript(`(function () {
+          const script = document.createElement('script')
+          script.onload = function () { console.log('loaded ${src}') }
+          script.onerror = function () { console.log('failed ${src}') }
+          script.src = '${src}'
+          document.head.appendChild(script)
+        })()`)
+      }
+
+      // Rules are applied asynchronously, so retries until |url| loads or is
+      // blocked as expected.
+      const waitForScript = function (url, loaded, callback) {
+        loadScript(url, function (result, requestPath) {
+          if (result === loaded) {
+            callback(requestPath)
+          } else {
+            setTimeout(function () {
+              waitForScript(url, loaded, callback)
+            }, 50)
+          }
+        })
+      }
+
+      const assertBlocked = function (requestPath) {
+        assert.equal(requests.indexOf(requestPath), -1)
+        assert(consoleMessages.some(function (message) {
+          return message.includes('ERR_BLOCKED_BY_CLIENT')
+        }))
+      }
+
+      it('blocks third-party requests to blocked hosts', function (done) {
+        app.setSubresourceFilter({blockedHosts: ['localhost']})
+        waitForScript(`http://localhost:${port}/blocked.js`, false, function (requestPath) {
+          assertBlocked(requestPath)
+          done()
+        })
+      })
+
+      it('blocks requests matching a pattern regardless of case', function (done) {
+        app.setSubresourceFilter({patterns: ['/BANNER/']})
+        waitForScript(`http://localhost:${port}/ads/banner/ad.js`, false, function (requestPath) {
+          assertBlocked(requestPath)
+          loadScript(`http://localhost:${port}/content/app.js`, function (loaded, requestPath) {
+            assert(loaded)
+            assert.notEqual(requests.indexOf(requestPath), -1)
+            done()
+          })
+        })
+      })
+
+      it('does not block first-party requests', function (done) {
+        app.setSubresourceFilter({blockedHosts: ['localhost', '127.0.0.1']})
+        waitForScript(`http://localhost:${port}/blocked.js`, false, function () {
+          loadScript(`http://127.0.0.1:${port}/app.js`, function (loaded) {
+            assert(loaded)
+            done()
+          })
+        })
+      })
+
+      it('does not block anything on disabled sites', function (done) {
+        app.setSubresourceFilter({blockedHosts: ['localhost']})
+        waitForScript(`http://localhost:${port}/blocked.js`, false, function () {
+          app.setSubresourceFilter({
+            blockedHosts: ['localhost'],
+            disabledSites: ['127.0.0.1']
+          })
+          waitForScript(`http://localhost:${port}/blocked.js`, true, function () {
+            done()
+          })
+        })
+      })
+
+      it('swaps to new rules in pages that are already loaded', function (done) {
+        app.setSubresourceFilter({blockedHosts: ['localhost']})
+        waitForScript(`http://localhost:${port}/app.js`, false, function () {
+          app.setSubresourceFilter({patterns: ['/ads/']})
+          waitForScript(`http://localhost:${port}/app.js`, true, function () {
+            loadScript(`http://localhost:${port}/ads/ad.js`, function (loaded) {
+              assert(!loaded)
+              app.setSubresourceFilter(null)
+              waitForScript(`http://localhost:${port}/ads/ad.js`, true, function () {
+                done()
+              })
+            })
+          })
+        })
+      })
+    })
+  })
+
+  describe('app.getRemoteSyncCallCounts()', function () {
+    it('counts synchronous remote calls by channel', function () {
+      const channel = 'ELECTRON_BROWSER_MEMBER_GET'
+      const remoteModule = remote.require(path.join(__dirname, 'fixtures', 'module', 'property.js'))
+      const before = app.getRemoteSyncCallCounts()[channel] || 0
+      // Every read of a remote property is a synchronous MEMBER_GET.
+      for (let i = 0; i < 5; i++) {
+        assert.equal(remoteModule.property, 1127)
+      }
+      assert.equal(app.getRemoteSyncCallCounts()[channel], before + 5)
+    })
+  })
+
+  describe('app.getMetrics()', function () {
+    it('returns latency percentiles for sync ipc messages', function () {
+      const metrics = app.getMetrics()
+      assert.ok(metrics['ipc.messageSync'].count > 0)
+      assert.equal(typeof metrics['ipc.messageSync'].p99Ms, 'number')
+      assert.equal(typeof metrics['worker.queueDepth'].value, 'number')
+    })
+
+    it('counts guest pool hits and misses with --guest-pool-size', function (done) {
+      this.timeout(30000)
+      const appPath = path.join(__dirname, 'fixtures', 'api', 'guest-pool')
+      const appProcess = ChildProcess.spawn(remote.process.execPath, [appPath])
+      let output = ''
+      appProcess.stdout.on('data', function (data) {
+        output += data
+      })
+      appProcess.on('close', function (code) {
+        assert.equal(code, 0)
+        const counts = JSON.parse(output.trim().split('\n').pop())
+        assert.deepEqual(counts, {hit: 1, miss: 1, create: 2})
+        done()
+      })
+    })
+  })
 })
@@ -9,6 +9,7 @@ const {closeWindow} = require('./window-helpers')
 
 const remote = require('electron').remote
 const screen = require('electron').screen
+const nativeImage = require('electron').nativeImage
 
 const app = remote.require('electron').app
 const ipcMain = remote.require('electron').ipcMain
@@ -267,6 +268,48 @@ describe('browser-window module', function () {
         done()
       })
     })
+
+    describe('with options', function () {
+      let shown = null
+
+      beforeEach(function (done) {
+        shown = new BrowserWindow({width: 400, height: 300})
+        shown.webContents.once('did-finish-load', () => done())
+        shown.loadURL('data:text/html,<body style="background: red"></body>')
+      })
+
+      afterEach(function () {
+        return closeWindow(shown).then(function () { shown = null })
+      })
+
+      it('encodes the snapshot as JPEG', function (done) {
+        shown.capturePage(null, {format: 'jpeg', quality: 50}, function (buffer) {
+          assert.ok(buffer.length > 0)
+          // The JPEG start of image marker.
+          assert.equal(buffer[0], 0xFF)
+          assert.equal(buffer[1], 0xD8)
+          assert.equal(nativeImage.createFromBuffer(Buffer.from(buffer)).isEmpty(), false)
+          done()
+        })
+      })
+
+      it('scales the snapshot down to fit in size', function (done) {
+        shown.capturePage(null, {format: 'png', size: {width: 40, height: 40}}, function (buffer) {
+          const size = nativeImage.createFromBuffer(Buffer.from(buffer)).getSize()
+          assert.ok(size.width > 0 && size.width <= 40, `width ${size.width}`)
+          assert.ok(size.height > 0 && size.height <= 40, `height ${size.height}`)
+          // The aspect ratio of the page is kept.
+          assert.ok(size.width > size.height)
+          done()
+        })
+      })
+
+      it('throws for an unsupported format', function () {
+        assert.throws(function () {
+          shown.capturePage(null, {format: 'gif'}, function () {})
+        }, /Unsupported capture format: gif/)
+      })
+    })
   })
 
   describe('BrowserWindow.setSize(width, height)', function () {
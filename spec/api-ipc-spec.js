@@ -274,6 +274,89 @@ describe('ipc module', function () {
     })
   })
 
+  describe('remote.async', function () {
+    const calls = remote.require(path.join(fixtures, 'module', 'async-calls.js'))
+
+    afterEach(function () {
+      calls.stopRecording()
+      calls.takeLog()
+    })
+
+    it('sends the calls of one microtask turn in a single message', function (done) {
+      calls.startRecording()
+      Promise.all([
+        remote.async.callMethod(calls, 'add', 1, 2),
+        remote.async.callMethod(calls, 'add', 3, 4),
+        remote.async.require(path.join(fixtures, 'module', 'id.js'))
+      ]).then(function (results) {
+        assert.equal(results[0], 3)
+        assert.equal(results[1], 7)
+        assert.equal(results[2].id, 1127)
+        assert.deepEqual(calls.stopRecording(), [['MEMBER_CALL', 'MEMBER_CALL', 'REQUIRE']])
+        done()
+      }).catch(done)
+    })
+
+    it('sends queued calls before a synchronous call', function (done) {
+      remote.async.callMethod(calls, 'push', 'async').then(function (length) {
+        assert.equal(length, 1)
+        done()
+      }).catch(done)
+      calls.push('sync')
+      assert.deepEqual(calls.takeLog(), ['async', 'sync'])
+    })
+
+    it('resolves with remote objects', function (done) {
+      remote.async.getGlobal('process').then(function (process) {
+        return remote.async.get(process, 'type')
+      }).then(function (type) {
+        assert.equal(type, 'browser')
+        done()
+      }).catch(done)
+    })
+
+    it('rejects when the call throws in the main process', function (done) {
+      remote.async.callMethod(calls, 'throws').then(function () {
+        done(new Error('Promise was not rejected'))
+      }, function (error) {
+        assert(/thrown in main/.test(error.message))
+        done()
+      }).catch(done)
+    })
+
+    it('rejects when the call returns a rejected promise', function (done) {
+      remote.async.callMethod(calls, 'rejects').then(function () {
+        done(new Error('Promise was not rejected'))
+      }, function (error) {
+        assert.equal(error.message, 'rejected in main')
+        done()
+      }).catch(done)
+    })
+
+    it('rejects calls on values that are not remote objects', function (done) {
+      Promise.all([
+        remote.async.call(function () {}).then(function () {
+          throw new Error('Promise was not rejected')
+        }, function (error) {
+          assert(error instanceof TypeError)
+          assert(/is not a remote object/.test(error.message))
+        }),
+        remote.async.callMethod({}, 'add', 1, 2).then(function () {
+          throw new Error('Promise was not rejected')
+        }, function (error) {
+          assert(error instanceof TypeError)
+        }),
+        remote.async.get(null, 'name').then(function () {
+          throw new Error('Promise was not rejected')
+        }, function (error) {
+          assert(error instanceof TypeError)
+        })
+      ]).then(function () {
+        done()
+      }).catch(done)
+    })
+  })
+
   describe('remote webContents', function () {
     it('can return same object with different getters', function () {
       var contents1 = remote.getCurrentWindow().webContents
@@ -322,6 +405,13 @@ describe('ipc module', function () {
       global.gc()
       assert.equal(method(), 'method')
     })
+
+    it('describes prototypes again when their members change', function () {
+      const changing = remote.require(path.join(fixtures, 'module', 'changing-prototype.js'))
+      assert.equal(changing.create().value(), 'method')
+      changing.replaceMethod()
+      assert.equal(changing.create().value, 'property')
+    })
   })
 
   describe('ipc.sender.send', function () {
@@ -461,6 +551,78 @@ describe('ipc module', function () {
     })
   })
 
+  describe('small messages', function () {
+    it('sends later messages on a channel by id', function () {
+      const app = remote.app
+      ipcRenderer.sendSync('echo', 0)
+
+      const registered = app.getMetrics()['ipc.channelRegistered'].count
+      for (let i = 0; i < 100; i++) {
+        assert.equal(ipcRenderer.sendSync('echo', i), i)
+      }
+      assert.equal(app.getMetrics()['ipc.channelRegistered'].count, registered)
+    })
+
+    it('keeps the order of messages on different channels', function (done) {
+      // The guest alternates sendToHost and send, the main process forwards
+      // the latter to this page.
+      const count = 1000
+      const received = []
+      const webview = document.createElement('webview')
+      const check = function () {
+        if (received.length < count * 2) return
+        webview.removeEventListener('ipc-message', onHostMessage)
+        ipcRenderer.removeListener('message-from-guest', onMainMessage)
+        document.body.removeChild(webview)
+
+        const expected = []
+        for (let i = 0; i < count; i++) {
+          expected.push(`host ${i}`, `main ${i}`)
+        }
+        assert.deepEqual(received, expected)
+        done()
+      }
+      const onHostMessage = function (event) {
+        assert.equal(event.channel, 'message-host')
+        received.push(`host ${event.args[0]}`)
+        check()
+      }
+      const onMainMessage = function (event, i) {
+        received.push(`main ${i}`)
+        check()
+      }
+      webview.addEventListener('ipc-message', onHostMessage)
+      ipcRenderer.on('message-from-guest', onMainMessage)
+      webview.setAttribute('nodeintegration', 'on')
+      webview.src = 'file://' + path.join(fixtures, 'pages', 'ipc-message-order.html')
+      document.body.appendChild(webview)
+    })
+  })
+
+  describe('payload conversion', function () {
+    const payloads = require(path.join(fixtures, 'module', 'ipc-payloads'))
+
+    it('converts sparse arrays and cycles like JSON.stringify', function () {
+      const cyclic = {name: 'cyclic'}
+      cyclic.self = cyclic
+      const shared = {a: 1}
+      assert.deepEqual(ipcRenderer.sendSync('echo', [1, , 3]), [1, 3]) // eslint-disable-line no-sparse-arrays
+      assert.deepEqual(ipcRenderer.sendSync('echo', cyclic),
+                       {name: 'cyclic', self: null})
+      assert.deepEqual(ipcRenderer.sendSync('echo', [shared, shared]),
+                       [{a: 1}, {a: 1}])
+      assert.deepEqual(ipcRenderer.sendSync('echo', {s: 'caf\u00e9 \ud83d\ude00'}),
+                       {s: 'caf\u00e9 \ud83d\ude00'})
+    })
+
+    Object.keys(payloads).forEach(function (name) {
+      it(`round trips ${name}`, function () {
+        const payload = payloads[name]
+        assert.deepEqual(ipcRenderer.sendSync('echo', payload), payload)
+      })
+    })
+  })
+
   describe('ipcRenderer.sendTo', function () {
     let contents = null
     beforeEach(function () {
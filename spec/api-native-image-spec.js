@@ -59,4 +59,39 @@ describe('nativeImage module', () => {
       assert.equal(image.getSize().width, 256)
     })
   })
+
+  describe('toPNG()', () => {
+    it('returns a Buffer that can be modified without changing the image', () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'))
+      const png = image.toPNG()
+      const dataURL = image.toDataURL()
+      const jpeg = image.toJPEG(80)
+
+      image.toPNG().fill(0)
+      image.toJPEG(80).fill(0)
+
+      assert(image.toPNG().equals(png))
+      assert.equal(image.toDataURL(), dataURL)
+      assert(image.toJPEG(80).equals(jpeg))
+      assert(!png.equals(Buffer.alloc(png.length)))
+    })
+
+    it('encodes pixels changed through getBitmap()', () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'))
+      const png = image.toPNG()
+      const dataURL = image.toDataURL()
+      const jpeg = image.toJPEG(80)
+
+      const bitmap = image.getBitmap()
+      for (let i = 0; i < bitmap.length; i++) bitmap[i] = 255 - bitmap[i]
+
+      const changed = image.toPNG()
+      assert(!changed.equals(png))
+      assert.notEqual(image.toDataURL(), dataURL)
+      assert(!image.toJPEG(80).equals(jpeg))
+
+      bitmap.fill(0)
+      assert(!image.toPNG().equals(changed))
+    })
+  })
 })
@@ -308,6 +308,85 @@ describe('protocol module', function () {
     })
   })
 
+  describe('protocol.registerStreamProtocol', function () {
+    const {PassThrough} = remote.require('stream')
+
+    it('sends stream as response', function (done) {
+      var handler = function (request, callback) {
+        var stream = new PassThrough()
+        callback(stream)
+        stream.end(text)
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function (data) {
+            assert.equal(data, text)
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('sends status code and headers', function (done) {
+      var handler = function (request, callback) {
+        var stream = new PassThrough()
+        callback({
+          statusCode: 200,
+          headers: {'x-stream': 'yes'},
+          data: stream
+        })
+        stream.end(text)
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function (data, status, request) {
+            assert.equal(data, text)
+            assert.equal(request.getResponseHeader('x-stream'), 'yes')
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('fails when sending a string', function (done) {
+      var handler = function (request, callback) {
+        callback(text)
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function () {
+            done('request succeeded but it should not')
+          },
+          error: function (xhr, errorType) {
+            assert.equal(errorType, 'error')
+            done()
+          }
+        })
+      })
+    })
+  })
+
   describe('protocol.registerFileProtocol', function () {
     var filePath = path.join(__dirname, 'fixtures', 'asar', 'a.asar', 'file1')
     var fileContent = require('fs').readFileSync(filePath)
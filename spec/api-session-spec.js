@@ -1,5 +1,7 @@
 const assert = require('assert')
+const ChildProcess = require('child_process')
 const http = require('http')
+const https = require('https')
 const path = require('path')
 const fs = require('fs')
 const {closeWindow} = require('./window-helpers')
@@ -47,6 +49,22 @@ describe('session module', function () {
       const ses2 = session.fromPartition(partition)
       assert.notEqual(ses2.getUserAgent(), userAgent)
     })
+
+    it('creates ephemeral sessions without a persistent context', function () {
+      const {app} = remote
+      const before = app.getMetrics()['partition.count'].value
+      const sessions = []
+      for (let i = 0; i < 20; i++) {
+        sessions.push(session.fromPartition(`ephemeral-${i}`, {
+          parent_partition: '',
+          ephemeral: true
+        }))
+      }
+      const metrics = app.getMetrics()
+      assert.equal(metrics['partition.count'].value, before + 20)
+      assert.ok(metrics['partition.create'].count >= 20)
+      sessions.forEach((ses) => ses.destroy())
+    })
   })
 
   describe('ses.cookies', function () {
@@ -320,6 +338,31 @@ describe('session module', function () {
       })
     })
 
+    it('can download in range requests', function (done) {
+      this.timeout(60000)
+
+      // The switch applies to every download of the process, so it is only
+      // turned on in an app of its own.
+      const appPath = path.join(fixtures, 'api', 'parallel-download')
+      const appProcess = ChildProcess.spawn(remote.process.execPath,
+        [appPath, '--parallel-download-segments=4'])
+      let output = ''
+      appProcess.stdout.on('data', function (data) {
+        output += data
+      })
+      appProcess.on('close', function (code) {
+        assert.equal(code, 0)
+        const result = JSON.parse(output.trim().split('\n').pop())
+        assert.equal(result.state, 'completed')
+        assert.equal(result.receivedBytes, 16 * 1024 * 1024)
+        assert.equal(result.totalBytes, 16 * 1024 * 1024)
+        assert.ok(result.matches)
+        assert.ok(result.rangeRequests >= 1)
+        assert.ok(result.maxSlices > 1)
+        done()
+      })
+    })
+
     describe('when a save path is specified and the URL is unavailable', function () {
       it('does not display a save dialog and reports the done state as interrupted', function (done) {
         ipcRenderer.sendSync('set-download-option', false, false)
@@ -376,6 +419,174 @@ describe('session module', function () {
     })
   })
 
+  describe('ses.setCertificateVerifyProc(proc, options)', function () {
+    const certPath = path.join(fixtures, 'certificates')
+    let server = null
+
+    beforeEach(function (done) {
+      server = https.createServer({
+        key: fs.readFileSync(path.join(certPath, 'server.key')),
+        cert: fs.readFileSync(path.join(certPath, 'server.pem'))
+      }, function (req, res) {
+        res.end('<title>hello</title>')
+      })
+      server.listen(0, '127.0.0.1', done)
+    })
+
+    afterEach(function () {
+      session.defaultSession.setCertificateVerifyProc(null)
+      server.close()
+    })
+
+    it('passes the default result and caches verdicts', function (done) {
+      const {app} = remote
+      const before = app.getMetrics()
+      let calls = 0
+      session.defaultSession.setCertificateVerifyProc((hostname, cert, callback, result) => {
+        calls++
+        assert.equal(hostname, '127.0.0.1')
+        assert.notEqual(result, 'net::OK')
+        callback(true)
+      }, {verdictCacheTime: 60})
+
+      // The same certificate on another port needs a new connection, which
+      // is verified again and answered from the cache.
+      const secondServer = https.createServer({
+        key: fs.readFileSync(path.join(certPath, 'server.key')),
+        cert: fs.readFileSync(path.join(certPath, 'server.pem'))
+      }, function (req, res) {
+        res.end('<title>again</title>')
+      })
+
+      w.webContents.once('did-finish-load', function () {
+        assert.equal(w.webContents.getTitle(), 'hello')
+        assert.equal(calls, 1)
+        const metrics = app.getMetrics()
+        assert.equal(metrics['certVerifier.cacheMiss'].count,
+          before['certVerifier.cacheMiss'].count + 1)
+        assert.ok(metrics['certVerifier.verify'].count > 0)
+
+        secondServer.listen(0, '127.0.0.1', function () {
+          w.webContents.once('did-finish-load', function () {
+            secondServer.close()
+            assert.equal(w.webContents.getTitle(), 'again')
+            assert.equal(calls, 1)
+            const metrics = app.getMetrics()
+            assert.equal(metrics['certVerifier.cacheHit'].count,
+              before['certVerifier.cacheHit'].count + 1)
+            assert.equal(metrics['certVerifier.cacheMiss'].count,
+              before['certVerifier.cacheMiss'].count + 1)
+            done()
+          })
+          w.loadURL(`https://127.0.0.1:${secondServer.address().port}`)
+        })
+      })
+      w.loadURL(`https://127.0.0.1:${server.address().port}`)
+    })
+  })
+
+  describe('ses.userPrefs.getDictionaryPref(path, callback)', function () {
+    it('converts a large pref in slices', function (done) {
+      const {app} = remote
+      const userPrefs = session.fromPartition('user-prefs-test').userPrefs
+      const state = {}
+      for (let i = 0; i < 20000; i++) {
+        state[`site${i}`] = {url: `https://example${i}.com/`, visits: [i, i + 1]}
+      }
+      userPrefs.setDictionaryPref('app_state', state)
+
+      const slices = app.getMetrics()['valueConverter.slice'].count
+      const result = userPrefs.getDictionaryPref('app_state', function (value) {
+        assert.deepEqual(value, state)
+        const metrics = app.getMetrics()['valueConverter.slice']
+        assert.ok(metrics.count > slices)
+        // Slices stop after 5ms, the bound leaves room for slow machines.
+        assert.ok(metrics.p99Ms < 50, `p99 of ${metrics.p99Ms}ms`)
+        done()
+      })
+      assert.equal(result, undefined)
+    })
+
+    it('converts the new value if the pref changes during the conversion', function (done) {
+      const userPrefs = session.fromPartition('user-prefs-test').userPrefs
+      userPrefs.setDictionaryPref('app_state', {a: {b: 1}, c: [1, 2]})
+      const changePref = remote.require(path.join(fixtures, 'module', 'change-pref-during-conversion.js'))
+      changePref('user-prefs-test', 'app_state', {a: {b: 2}, d: 'added'}, function (value) {
+        assert.deepEqual(value, {a: {b: 2}, d: 'added'})
+        done()
+      })
+    })
+  })
+
+  describe('ses.userPrefs.addDictionaryPrefObserver(path, callback)', function () {
+    it('reports the changed paths', function (done) {
+      const userPrefs = session.fromPartition('user-prefs-observer-test').userPrefs
+      userPrefs.setDictionaryPref('app_state', {
+        a: {b: 1, c: 2},
+        d: 'unchanged',
+        e: [1, 2]
+      })
+
+      const diffs = []
+      const id = userPrefs.addDictionaryPrefObserver('app_state', (diff) => {
+        diffs.push(diff)
+        if (diffs.length < 2) return
+
+        assert.deepEqual(diffs, [{
+          added: [{path: ['f'], value: {g: true}}],
+          changed: [{path: ['a', 'c'], value: 3}],
+          removed: []
+        }, {
+          added: [],
+          changed: [{path: ['e'], value: [1, 2, 3]}],
+          removed: [['d']]
+        }])
+
+        // Callbacks reach the renderer in the order the main process ran
+        // them, so once the marker sees the next change any call for the
+        // removed observer would already have arrived.
+        userPrefs.removeDictionaryPrefObserver(id)
+        const marker = userPrefs.addDictionaryPrefObserver('app_state', () => {
+          userPrefs.removeDictionaryPrefObserver(marker)
+          assert.equal(diffs.length, 2)
+          done()
+        })
+        userPrefs.setDictionaryPref('app_state', {})
+      })
+      assert.ok(id > 0)
+      userPrefs.setDictionaryPref('app_state', {
+        a: {b: 1, c: 3},
+        d: 'unchanged',
+        e: [1, 2],
+        f: {g: true}
+      })
+      userPrefs.setDictionaryPref('app_state', {
+        a: {b: 1, c: 3},
+        e: [1, 2, 3],
+        f: {g: true}
+      })
+    })
+
+    it('does not call an observer removed by another for the same change', function () {
+      const removePrefObserver = remote.require(path.join(fixtures, 'module', 'remove-pref-observer.js'))
+      assert.deepEqual(removePrefObserver('user-prefs-observer-test', 'app_state'),
+                       {first: 1, second: 0})
+    })
+
+    it('delivers a change made by an observer after the current one', function () {
+      const reentrantPrefObserver = remote.require(path.join(fixtures, 'module', 'reentrant-pref-observer.js'))
+      assert.deepEqual(reentrantPrefObserver('user-prefs-observer-test', 'app_state'), [{
+        added: [{path: ['step'], value: 1}],
+        changed: [],
+        removed: []
+      }, {
+        added: [],
+        changed: [{path: ['step'], value: 2}],
+        removed: []
+      }])
+    })
+  })
+
   describe('ses.setProxy(options, callback)', function () {
     it('allows configuring proxy settings', function (done) {
       const config = {
@@ -5,7 +5,7 @@ const path = require('path')
 const {closeWindow} = require('./window-helpers')
 
 const {remote} = require('electron')
-const {BrowserWindow, webContents} = remote
+const {BrowserWindow, session, webContents} = remote
 
 const isCi = remote.getGlobal('isCi')
 
@@ -48,6 +48,34 @@ describe('webContents module', function () {
     })
   })
 
+  describe('sendToAll() API', function () {
+    const {ipcRenderer} = require('electron')
+
+    afterEach(function () {
+      ipcRenderer.removeAllListeners('broadcast')
+    })
+
+    it('sends one message to every web contents', function (done) {
+      ipcRenderer.once('broadcast', function (event, value, object) {
+        assert.equal(value, 'state')
+        assert.deepEqual(object, {count: 1})
+        done()
+      })
+      const sent = webContents.sendToAll([remote.getCurrentWebContents(), w.webContents],
+                                         'broadcast', 'state', {count: 1})
+      assert.ok(sent >= 1)
+    })
+
+    it('sends to the web contents of a session', function (done) {
+      const specWebContents = remote.getCurrentWebContents()
+      ipcRenderer.once('broadcast', function (event, value) {
+        assert.equal(value, 'session')
+        done()
+      })
+      assert.ok(webContents.sendToAll(specWebContents.session, 'broadcast', 'session') >= 1)
+    })
+  })
+
   describe('getFocusedWebContents() API', function () {
     it('returns the focused web contents', function (done) {
       if (isCi) return done()
@@ -97,4 +125,82 @@ describe('webContents module', function () {
       })
     })
   })
+
+  describe('queryTabs(queryInfo) API', function () {
+    let tabs = []
+
+    const createTab = function (options) {
+      return new Promise((resolve) => {
+        webContents.createTab(w.webContents, session.defaultSession,
+          Object.assign({windowId: w.id}, options), resolve)
+      })
+    }
+
+    const ids = function (contents) {
+      return contents.map((tab) => tab.tabValue().id).sort()
+    }
+
+    // The tabs every tab would match if its whole state were checked.
+    const expected = function (predicate) {
+      return webContents.queryTabs({}).map((tab) => tab.tabValue())
+        .filter(predicate).map((tab) => tab.id).sort()
+    }
+
+    beforeEach(function () {
+      w.loadURL('about:blank')
+      return Promise.all([
+        createTab({src: 'about:blank', active: true}),
+        createTab({src: 'about:blank', active: false}),
+        createTab({src: 'data:text/html,tab', active: false})
+      ]).then((created) => {
+        tabs = created
+      })
+    })
+
+    afterEach(function () {
+      tabs.forEach((tab) => {
+        if (!tab.isDestroyed()) tab.forceClose()
+      })
+      tabs = []
+    })
+
+    it('returns the tabs of a window', function () {
+      assert.deepEqual(ids(webContents.queryTabs({windowId: w.id})),
+                       ids(tabs))
+    })
+
+    it('returns the tabs of every window without windowId', function () {
+      const all = ids(webContents.queryTabs({}))
+      ids(tabs).forEach((id) => assert.notEqual(all.indexOf(id), -1))
+      assert.deepEqual(all, expected(() => true))
+    })
+
+    it('filters on url', function () {
+      const url = tabs[2].tabValue().url
+      assert.deepEqual(ids(webContents.queryTabs({url})),
+                       expected((tab) => tab.url === url))
+      assert.deepEqual(ids(webContents.queryTabs({windowId: w.id, url})),
+                       expected((tab) => tab.windowId === w.id && tab.url === url))
+    })
+
+    it('filters on active', function () {
+      [true, false].forEach((active) => {
+        assert.deepEqual(ids(webContents.queryTabs({active})),
+                         expected((tab) => tab.active === active))
+        assert.deepEqual(ids(webContents.queryTabs({windowId: w.id, active})),
+                         expected((tab) => tab.windowId === w.id && tab.active === active))
+      })
+    })
+
+    it('filters on pinned', function () {
+      [true, false].forEach((pinned) => {
+        assert.deepEqual(ids(webContents.queryTabs({pinned})),
+                         expected((tab) => tab.pinned === pinned))
+        assert.deepEqual(ids(webContents.queryTabs({windowId: w.id, pinned})),
+                         expected((tab) => tab.windowId === w.id && tab.pinned === pinned))
+      })
+      assert.deepEqual(ids(webContents.queryTabs({windowId: w.id, pinned: false})),
+                       ids(tabs))
+    })
+  })
 })
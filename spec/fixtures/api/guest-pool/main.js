@@ -0,0 +1,45 @@
+const {app, BrowserWindow, session, webContents} = require('electron')
+
+app.commandLine.appendSwitch('guest-pool-size', '1')
+
+const createTab = function (owner) {
+  return new Promise((resolve) => {
+    webContents.createTab(owner, session.defaultSession, {src: 'about:blank'},
+      resolve)
+  })
+}
+
+// Resolves once a guest is waiting in the pool.
+const waitForPooledGuest = function () {
+  return new Promise((resolve) => {
+    const check = function () {
+      if (app.getMetrics()['guestPool.size'].value > 0) {
+        resolve()
+      } else {
+        setTimeout(check, 50)
+      }
+    }
+    check()
+  })
+}
+
+app.on('ready', function () {
+  const w = new BrowserWindow({show: false})
+  w.loadURL('about:blank')
+  w.webContents.once('did-finish-load', function () {
+    // The first tab finds the pool empty and starts refilling it.
+    createTab(w.webContents).then(() => {
+      return waitForPooledGuest()
+    }).then(() => {
+      return createTab(w.webContents)
+    }).then(() => {
+      const metrics = app.getMetrics()
+      console.log(JSON.stringify({
+        hit: metrics['guestPool.hit'].count,
+        miss: metrics['guestPool.miss'].count,
+        create: metrics['tab.create'].count
+      }))
+      app.exit(0)
+    })
+  })
+})
@@ -0,0 +1,77 @@
+const {app, BrowserWindow} = require('electron')
+const crypto = require('crypto')
+const fs = require('fs')
+const http = require('http')
+const path = require('path')
+
+// Each connection is throttled to about 1.6MB/s, so a single request would
+// take ten seconds and the download is always worth splitting.
+const data = crypto.randomBytes(1024 * 1024 * 16)
+const chunkSize = 32 * 1024
+const chunkIntervalMs = 20
+
+let rangeRequests = 0
+const server = http.createServer(function (req, res) {
+  let start = 0
+  let end = data.length - 1
+  const range = /^bytes=(\d+)-(\d*)$/.exec(req.headers['range'] || '')
+  const headers = {
+    'Accept-Ranges': 'bytes',
+    'Content-Type': 'application/octet-stream',
+    'Content-Disposition': 'attachment; filename="parallel.bin"',
+    'ETag': '"parallel"'
+  }
+  if (range) {
+    rangeRequests++
+    start = Number(range[1])
+    if (range[2]) end = Math.min(Number(range[2]), end)
+    headers['Content-Range'] = `bytes ${start}-${end}/${data.length}`
+  }
+  headers['Content-Length'] = end - start + 1
+  res.writeHead(range ? 206 : 200, headers)
+
+  const timer = setInterval(function () {
+    if (start > end) {
+      clearInterval(timer)
+      res.end()
+      return
+    }
+    const chunkEnd = Math.min(start + chunkSize, end + 1)
+    res.write(data.slice(start, chunkEnd))
+    start = chunkEnd
+  }, chunkIntervalMs)
+  res.on('close', function () {
+    clearInterval(timer)
+  })
+})
+
+app.on('ready', function () {
+  const savePath = path.join(app.getPath('temp'), `parallel-${process.pid}.bin`)
+  const w = new BrowserWindow({show: false})
+  w.webContents.session.once('will-download', function (event, item) {
+    item.setSavePath(savePath)
+    let maxSlices = 0
+    item.on('updated', function () {
+      maxSlices = Math.max(maxSlices, item.getReceivedSlices().length)
+    })
+    item.on('done', function (event, state) {
+      const matches = state === 'completed' &&
+        fs.readFileSync(savePath).equals(data)
+      if (fs.existsSync(savePath)) fs.unlinkSync(savePath)
+      console.log(JSON.stringify({
+        state,
+        receivedBytes: item.getReceivedBytes(),
+        totalBytes: item.getTotalBytes(),
+        matches,
+        rangeRequests,
+        maxSlices
+      }))
+      server.close()
+      app.exit(0)
+    })
+  })
+
+  server.listen(0, '127.0.0.1', function () {
+    w.webContents.downloadURL(`http://127.0.0.1:${server.address().port}/`)
+  })
+})
@@ -0,0 +1,44 @@
+'use strict'
+
+const {ipcMain} = require('electron')
+
+const log = []
+let batches = []
+
+// Records the types of the calls in each batch a renderer sends.
+const recordBatch = function (event, calls) {
+  batches.push(calls.map((call) => call[1]))
+}
+
+module.exports = {
+  startRecording () {
+    batches = []
+    ipcMain.on('ELECTRON_BROWSER_ASYNC_CALLS', recordBatch)
+  },
+
+  stopRecording () {
+    ipcMain.removeListener('ELECTRON_BROWSER_ASYNC_CALLS', recordBatch)
+    return batches
+  },
+
+  push (value) {
+    log.push(value)
+    return log.length
+  },
+
+  takeLog () {
+    return log.splice(0)
+  },
+
+  add (a, b) {
+    return a + b
+  },
+
+  throws () {
+    throw new Error('thrown in main')
+  },
+
+  rejects () {
+    return Promise.reject(new Error('rejected in main'))
+  }
+}
@@ -0,0 +1,10 @@
+'use strict'
+
+// Sets the pref in the same task as the conversion starts, so the change is
+// always seen by its first slice.
+module.exports = function (partition, path, value, callback) {
+  const {session} = require('electron')
+  const userPrefs = session.fromPartition(partition).userPrefs
+  userPrefs.getDictionaryPref(path, callback)
+  userPrefs.setDictionaryPref(path, value)
+}
@@ -0,0 +1,22 @@
+'use strict'
+
+class Changing {
+  value () {
+    return 'method'
+  }
+}
+
+module.exports = {
+  create () {
+    return new Changing()
+  },
+
+  // Replaces the method with a property, keeping the number of members.
+  replaceMethod () {
+    delete Changing.prototype.value
+    Object.defineProperty(Changing.prototype, 'value', {
+      get () { return 'property' },
+      configurable: true
+    })
+  }
+}
@@ -0,0 +1,20 @@
+// Representative payloads for the V8ValueConverter fast paths, shared by the
+// ipc spec and script/bench-ipc.py.
+module.exports = {
+  numbers: Array.from({length: 1000}, (v, i) => i * 1.5),
+  strings: Array.from({length: 1000}, (v, i) => `string ${i} \u00e9`),
+  flatObject: Array.from({length: 100}).reduce((object, v, i) => {
+    object[`key${i}`] = i % 2 ? `value${i}` : i
+    return object
+  }, {}),
+  requestDetails: Array.from({length: 50}, (v, i) => ({
+    id: i,
+    url: `https://example.com/resource/${i}`,
+    method: 'GET',
+    resourceType: 'script',
+    timestamp: 1500000000000 + i,
+    requestHeaders: {Accept: '*/*', 'User-Agent': 'muon'},
+    firstPartyUrl: 'https://example.com/'
+  })),
+  buffer: Buffer.alloc(64 * 1024, 1)
+}
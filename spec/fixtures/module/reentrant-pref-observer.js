@@ -0,0 +1,20 @@
+'use strict'
+
+// Adds two observers of a dictionary pref, the first of which changes the
+// pref again from its first call, and returns the diffs the second one saw.
+module.exports = function (partition, path) {
+  const {session} = require('electron')
+  const userPrefs = session.fromPartition(partition).userPrefs
+  userPrefs.setDictionaryPref(path, {})
+  const seen = []
+  const first = userPrefs.addDictionaryPrefObserver(path, () => {
+    userPrefs.removeDictionaryPrefObserver(first)
+    userPrefs.setDictionaryPref(path, {step: 2})
+  })
+  const second = userPrefs.addDictionaryPrefObserver(path, (diff) => {
+    seen.push(diff)
+  })
+  userPrefs.setDictionaryPref(path, {step: 1})
+  userPrefs.removeDictionaryPrefObserver(second)
+  return seen
+}
@@ -0,0 +1,20 @@
+'use strict'
+
+// Adds two observers of a dictionary pref, the first of which removes the
+// second, and returns how often each was called for one change.
+module.exports = function (partition, path) {
+  const {session} = require('electron')
+  const userPrefs = session.fromPartition(partition).userPrefs
+  const calls = {first: 0, second: 0}
+  let second = 0
+  const first = userPrefs.addDictionaryPrefObserver(path, () => {
+    calls.first++
+    userPrefs.removeDictionaryPrefObserver(second)
+  })
+  second = userPrefs.addDictionaryPrefObserver(path, () => {
+    calls.second++
+  })
+  userPrefs.setDictionaryPref(path, {changed: Date.now()})
+  userPrefs.removeDictionaryPrefObserver(first)
+  return calls
+}
@@ -40,6 +40,11 @@ ipcMain.on('message', function (event, ...args) {
   event.sender.send('message', ...args)
 })
 
+// Forwards a guest's message to its embedder.
+ipcMain.on('message-to-host', function (event, ...args) {
+  event.sender.hostWebContents.send('message-from-guest', ...args)
+})
+
 // Set productName so getUploadedReports() uses the right directory in specs
 if (process.platform === 'win32') {
   crashReporter.productName = 'Zombies'
@@ -871,6 +871,31 @@ describe('<webview> tag', function () {
       setUpRequestHandler(webview, 'openExternal', done)
       document.body.appendChild(webview)
     })
+
+    it('reuses decisions for decisionCacheTime', function (done) {
+      const ses = session.fromPartition('permissionCacheTest')
+      let requests = 0
+      let responses = 0
+      ses.setPermissionRequestHandler(function (webContents, permission, callback) {
+        requests++
+        callback([false])
+      }, {decisionCacheTime: 60})
+      webview.addEventListener('ipc-message', function (e) {
+        assert.equal(e.channel, 'message')
+        if (++responses === 1) {
+          webview.reload()
+          return
+        }
+        assert.equal(requests, 1)
+        ses.clearPermissionDecisions()
+        ses.setPermissionRequestHandler(null)
+        done()
+      })
+      webview.src = 'file://' + fixtures + '/pages/permissions/geolocation.html'
+      webview.partition = 'permissionCacheTest'
+      webview.setAttribute('nodeintegration', 'on')
+      document.body.appendChild(webview)
+    })
   })
 
   describe('<webview>.getWebContents', function () {